@@ -21,6 +21,7 @@ using wallet::CWallet;
 using wallet::CWalletTx;
 using wallet::CoinEligibilityFilter;
 using wallet::CoinSelectionParams;
+using wallet::CoinGrinder;
 using wallet::CreateMockableWalletDatabase;
 using wallet::OutputGroup;
 using wallet::SelectCoinsBnB;
@@ -86,6 +87,46 @@ static void CoinSelection(benchmark::Bench& bench)
     });
 }
 
+// Select from a pool of 50k UTXOs of different sizes, as in a wallet that
+// receives many small payments. At the high feerate all four algorithms run,
+// and BnB and CoinGrinder search up to their iteration limits.
+static void CoinSelectionLargePool(benchmark::Bench& bench)
+{
+    NodeContext node;
+    auto chain = interfaces::MakeChain(node);
+    CWallet wallet(chain.get(), "", CreateMockableWalletDatabase());
+    LOCK(wallet.cs_wallet);
+
+    const CFeeRate effective_feerate{30000};
+    const int input_bytes{68};
+    FastRandomContext det_rand{true};
+    wallet::CoinsResult available_coins;
+    for (uint32_t i = 0; i < 50000; ++i) {
+        CTxOut txout{CAmount(1000 + det_rand.randrange(COIN)), CScript() << OP_TRUE};
+        available_coins.coins[OutputType::BECH32].emplace_back(COutPoint(Txid::FromUint256(det_rand.rand256()), i), txout, /*depth=*/6 * 24, input_bytes, /*spendable=*/true, /*solvable=*/true, /*safe=*/true, /*time=*/0, /*from_me=*/true, effective_feerate.GetFee(input_bytes));
+    }
+
+    const CoinEligibilityFilter filter_standard(1, 6, 0);
+    FastRandomContext rand{};
+    const CoinSelectionParams coin_selection_params{
+        rand,
+        /*change_output_size=*/ 31,
+        /*change_spend_size=*/ 68,
+        /*min_change_target=*/ CHANGE_LOWER,
+        /*effective_feerate=*/ effective_feerate,
+        /*long_term_feerate=*/ CFeeRate(5000),
+        /*discard_feerate=*/ CFeeRate(3000),
+        /*tx_noinputs_size=*/ 11 + 31,
+        /*avoid_partial=*/ false,
+    };
+    auto group = wallet::GroupOutputs(wallet, available_coins, coin_selection_params, {{filter_standard}})[filter_standard];
+    bench.unit("selection").run([&] {
+        auto result = AttemptSelection(wallet.chain(), 50 * COIN, group, coin_selection_params, /*allow_mixed_output_types=*/true);
+        assert(result);
+        assert(result->GetSelectedValue() >= 50 * COIN);
+    });
+}
+
 // Copied from src/wallet/test/coinselector_tests.cpp
 static void add_coin(const CAmount& nValue, int nInput, std::vector<OutputGroup>& set)
 {
@@ -124,5 +165,71 @@ static void BnBExhaustion(benchmark::Bench& bench)
     });
 }
 
+// A pool of UTXOs of random sizes, to be spent at the params' feerate
+static std::vector<OutputGroup> MakeRandomPool(size_t size, const CoinSelectionParams& params, FastRandomContext& det_rand)
+{
+    const int input_bytes{68};
+    std::vector<OutputGroup> pool;
+    for (size_t i = 0; i < size; ++i) {
+        CTxOut txout{CAmount(10000 + det_rand.randrange(COIN)), CScript() << OP_TRUE};
+        COutput output(COutPoint(Txid::FromUint256(det_rand.rand256()), 0), txout, /*depth=*/6, input_bytes, /*spendable=*/true, /*solvable=*/true, /*safe=*/true, /*time=*/0, /*from_me=*/true, params.m_effective_feerate.GetFee(input_bytes));
+        pool.emplace_back(params);
+        pool.back().Insert(std::make_shared<COutput>(output), /*ancestors=*/0, /*descendants=*/0);
+    }
+    return pool;
+}
+
+// Search a pool of 1000 UTXOs with BnB and CoinGrinder. The pool is the same
+// on every run and both searches use up all of their tries on it, so the
+// benchmarks report selections evaluated per second. The asserts pin the
+// solutions found when these benchmarks were added, so that a change to a
+// search that makes it find a different solution is noticed.
+static void BnBLargePool(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    const CoinSelectionParams params{det_rand, /*change_output_size=*/31, /*change_spend_size=*/68, /*min_change_target=*/CHANGE_LOWER,
+                                     /*effective_feerate=*/CFeeRate(30000), /*long_term_feerate=*/CFeeRate(5000), /*discard_feerate=*/CFeeRate(3000),
+                                     /*tx_noinputs_size=*/11 + 31, /*avoid_partial=*/false};
+    const std::vector<OutputGroup> pool{MakeRandomPool(1000, params, det_rand)};
+    const CAmount cost_of_change{params.m_effective_feerate.GetFee(31) + params.m_discard_feerate.GetFee(68)};
+    const CAmount target{20 * COIN};
+
+    const size_t tries{100'000};
+    const CAmount expected_waste{39253};
+
+    std::vector<OutputGroup> utxo_pool;
+    bench.batch(tries).unit("selection").run([&] {
+        utxo_pool = pool;
+        const auto result{SelectCoinsBnB(utxo_pool, target, cost_of_change, MAX_STANDARD_TX_WEIGHT)};
+        assert(result && result->GetSelectionsEvaluated() == tries);
+        assert(result->GetWaste() == expected_waste);
+    });
+}
+
+static void CoinGrinderLargePool(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    const CoinSelectionParams params{det_rand, /*change_output_size=*/31, /*change_spend_size=*/68, /*min_change_target=*/CHANGE_LOWER,
+                                     /*effective_feerate=*/CFeeRate(30000), /*long_term_feerate=*/CFeeRate(5000), /*discard_feerate=*/CFeeRate(3000),
+                                     /*tx_noinputs_size=*/11 + 31, /*avoid_partial=*/false};
+    const std::vector<OutputGroup> pool{MakeRandomPool(1000, params, det_rand)};
+    const CAmount target{20 * COIN};
+
+    const size_t tries{100'000};
+    // CoinGrinder minimizes the input weight rather than the waste
+    const int expected_weight{5712};
+
+    std::vector<OutputGroup> utxo_pool;
+    bench.batch(tries).unit("selection").run([&] {
+        utxo_pool = pool;
+        const auto result{CoinGrinder(utxo_pool, target, params.m_min_change_target, MAX_STANDARD_TX_WEIGHT)};
+        assert(result && result->GetSelectionsEvaluated() == tries);
+        assert(result->GetWeight() == expected_weight);
+    });
+}
+
 BENCHMARK(CoinSelection, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinSelectionLargePool, benchmark::PriorityLevel::LOW);
 BENCHMARK(BnBExhaustion, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BnBLargePool, benchmark::PriorityLevel::LOW);
+BENCHMARK(CoinGrinderLargePool, benchmark::PriorityLevel::LOW);
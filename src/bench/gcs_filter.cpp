@@ -4,6 +4,11 @@
 
 #include <bench/bench.h>
 #include <blockfilter.h>
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/script.h>
+#include <undo.h>
 
 static GCSFilter::ElementSet GenerateGCSTestElements()
 {
@@ -81,8 +86,121 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+static void GCSFilterHashElements(benchmark::Bench& bench)
+{
+    // A block's worth of scriptPubKeys of typical sizes.
+    GCSFilter::ElementSet elements;
+    for (int i = 0; i < 5000; ++i) {
+        GCSFilter::Element element(i % 3 == 0 ? 22 : 34);
+        element[0] = static_cast<unsigned char>(i);
+        element[1] = static_cast<unsigned char>(i >> 8);
+        elements.insert(std::move(element));
+    }
+
+    uint64_t siphash_k0 = 0;
+    bench.batch(elements.size()).unit("elem").run([&] {
+        GCSFilter filter({siphash_k0, 0, BASIC_FILTER_P, BASIC_FILTER_M});
+        // A non-empty set exercises the hashing, and matching against an
+        // empty filter skips the decoding.
+        filter.MatchAny(elements);
+        siphash_k0++;
+    });
+}
+
+static void GCSFilterMatchAny(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+
+    // A wallet's worth of scripts, none of them in the filter, as when
+    // rescanning with FastWalletRescanFilter.
+    GCSFilter::ElementSet queries;
+    for (int i = 0; i < 1000; ++i) {
+        GCSFilter::Element element(34);
+        element[2] = static_cast<unsigned char>(i);
+        element[3] = static_cast<unsigned char>(i >> 8);
+        queries.insert(std::move(element));
+    }
+
+    bench.run([&] {
+        filter.MatchAny(queries);
+    });
+}
+
+// A block of 2000 transactions with two inputs and two outputs each, half of
+// the outputs segwit v0 and half taproot.
+static void CreateFilterBlock(CBlock& block, CBlockUndo& block_undo)
+{
+    FastRandomContext det_rand{true};
+    CMutableTransaction coinbase;
+    coinbase.vin.emplace_back();
+    coinbase.vout.emplace_back(50 * COIN, CScript() << OP_0 << det_rand.randbytes(20));
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    for (int i = 0; i < 2000; ++i) {
+        CMutableTransaction tx;
+        CTxUndo tx_undo;
+        for (int j = 0; j < 2; ++j) {
+            tx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), uint32_t(j)});
+            tx_undo.vprevout.emplace_back(CTxOut(COIN, CScript() << OP_0 << det_rand.randbytes(20)), 1, false);
+        }
+        tx.vout.emplace_back(COIN, CScript() << OP_0 << det_rand.randbytes(20));
+        tx.vout.emplace_back(COIN, CScript() << OP_1 << det_rand.randbytes(32));
+        block.vtx.push_back(MakeTransactionRef(tx));
+        block_undo.vtxundo.push_back(std::move(tx_undo));
+    }
+}
+
+static void BlockFilterBuild(benchmark::Bench& bench, BlockFilterType filter_type)
+{
+    CBlock block;
+    CBlockUndo block_undo;
+    CreateFilterBlock(block, block_undo);
+
+    bench.unit("block").run([&] {
+        BlockFilter filter(filter_type, block, block_undo);
+    });
+}
+
+// Match throughput of a wallet with 1000 scripts (and 1000 outpoints for the
+// outpoint filter) against the filter of a block it has no transactions in.
+static void BlockFilterMatch(benchmark::Bench& bench, BlockFilterType filter_type)
+{
+    CBlock block;
+    CBlockUndo block_undo;
+    CreateFilterBlock(block, block_undo);
+    BlockFilter filter(filter_type, block, block_undo);
+
+    FastRandomContext det_rand{true};
+    GCSFilter::ElementSet queries;
+    for (int i = 0; i < 1000; ++i) {
+        const CScript script{CScript() << OP_0 << det_rand.randbytes(20)};
+        if (filter_type == BlockFilterType::OUTPOINT) {
+            queries.insert(OutPointFilterElement(script));
+            queries.insert(OutPointFilterElement(COutPoint{Txid::FromUint256(det_rand.rand256()), 0}));
+        } else {
+            queries.emplace(script.begin(), script.end());
+        }
+    }
+
+    bench.unit("block").run([&] {
+        filter.GetFilter().MatchAny(queries);
+    });
+}
+
+static void BlockFilterBuildBasic(benchmark::Bench& bench) { BlockFilterBuild(bench, BlockFilterType::BASIC); }
+static void BlockFilterBuildOutPoint(benchmark::Bench& bench) { BlockFilterBuild(bench, BlockFilterType::OUTPOINT); }
+static void BlockFilterMatchBasic(benchmark::Bench& bench) { BlockFilterMatch(bench, BlockFilterType::BASIC); }
+static void BlockFilterMatchOutPoint(benchmark::Bench& bench) { BlockFilterMatch(bench, BlockFilterType::OUTPOINT); }
+
 BENCHMARK(GCSBlockFilterGetHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterConstruct, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecode, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecodeSkipCheck, benchmark::PriorityLevel::HIGH);
-BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
\ No newline at end of file
+BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterHashElements, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAny, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterBuildBasic, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterBuildOutPoint, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterMatchBasic, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterMatchOutPoint, benchmark::PriorityLevel::HIGH);
\ No newline at end of file
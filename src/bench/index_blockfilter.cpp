@@ -6,26 +6,33 @@
 
 #include <addresstype.h>
 #include <index/blockfilterindex.h>
+#include <netmessagemaker.h>
 #include <node/chainstate.h>
 #include <node/context.h>
+#include <protocol.h>
 #include <test/util/setup_common.h>
 #include <util/strencodings.h>
 
-// Very simple block filter index sync benchmark, only using coinbase outputs.
-static void BlockFilterIndexSync(benchmark::Bench& bench)
-{
-    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+static constexpr int CHAIN_SIZE{600};
 
-    // Create more blocks
-    int CHAIN_SIZE = 600;
+// Extend the test chain to CHAIN_SIZE blocks, only using coinbase outputs.
+static void CreateChain(TestChain100Setup& test_setup)
+{
     CPubKey pubkey{ParseHex("02ed26169896db86ced4cbb7b3ecef9859b5952825adbeab998fb5b307e54949c9")};
     CScript script = GetScriptForDestination(WitnessV0KeyHash(pubkey));
     std::vector<CMutableTransaction> noTxns;
     for (int i = 0; i < CHAIN_SIZE - 100; i++) {
-        test_setup->CreateAndProcessBlock(noTxns, script);
+        test_setup.CreateAndProcessBlock(noTxns, script);
         SetMockTime(GetTime() + 1);
     }
-    assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+    assert(WITH_LOCK(::cs_main, return test_setup.m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+}
+
+// Very simple block filter index sync benchmark, only using coinbase outputs.
+static void BlockFilterIndexSync(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CreateChain(*test_setup);
 
     bench.minEpochIterations(5).run([&] {
         BlockFilterIndex filter_index(interfaces::MakeChain(test_setup->m_node), BlockFilterType::BASIC,
@@ -40,4 +47,34 @@ static void BlockFilterIndexSync(benchmark::Bench& bench)
     });
 }
 
+// Serve a light client catching up with the chain: the filter headers of
+// every block, as for getcfheaders and getcfcheckpt, and the cfilter messages
+// for all filters.
+static void BlockFilterIndexServe(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CreateChain(*test_setup);
+
+    BlockFilterIndex filter_index(interfaces::MakeChain(test_setup->m_node), BlockFilterType::BASIC,
+                                  /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true);
+    assert(filter_index.Init());
+    filter_index.Sync();
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip())};
+
+    bench.minEpochIterations(10).batch(CHAIN_SIZE + 1).unit("filter").run([&] {
+        for (const CBlockIndex* block_index{tip}; block_index; block_index = block_index->pprev) {
+            uint256 header;
+            assert(filter_index.LookupFilterHeader(block_index, header));
+        }
+
+        std::vector<BlockFilterRecord> records;
+        assert(filter_index.LookupFilterRecordRange(0, tip, records));
+        for (const auto& record : records) {
+            CSerializedNetMsg msg{NetMsg::Make(NetMsgType::CFILTER, static_cast<uint8_t>(BlockFilterType::BASIC), record.data)};
+            assert(!msg.data.empty());
+        }
+    });
+}
+
 BENCHMARK(BlockFilterIndexSync, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexServe, benchmark::PriorityLevel::HIGH);
@@ -5,9 +5,11 @@
 #include <bench/bench.h>
 #include <kernel/mempool_entry.h>
 #include <policy/policy.h>
+#include <random.h>
 #include <test/util/setup_common.h>
 #include <txmempool.h>
 
+#include <vector>
 
 static void AddTx(const CTransactionRef& tx, const CAmount& nFee, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
 {
@@ -134,4 +136,42 @@ static void MempoolEviction(benchmark::Bench& bench)
     });
 }
 
+// Evict half of a mempool flooded with mostly independent transactions, as
+// seen when a burst of low feerate transactions pushes the mempool over its limit.
+static void MempoolEvictionFlood(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    FastRandomContext det_rand{true};
+
+    std::vector<CTransactionRef> txs;
+    std::vector<CAmount> fees;
+    for (int i = 0; i < 2000; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        // Every tenth transaction spends the previous one, the rest are independent.
+        if (i % 10 == 9) {
+            tx.vin[0].prevout = COutPoint(txs.back()->GetHash(), 0);
+        } else {
+            tx.vin[0].prevout = COutPoint(Txid::FromUint256(det_rand.rand256()), 0);
+        }
+        tx.vin[0].scriptSig = CScript() << CScriptNum(i);
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+        txs.push_back(MakeTransactionRef(tx));
+        fees.push_back(1000 + det_rand.randrange(100000));
+    }
+
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    bench.batch(txs.size() / 2).unit("tx").run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        for (size_t i = 0; i < txs.size(); ++i) {
+            AddTx(txs[i], fees[i], pool);
+        }
+        pool.TrimToSize(pool.DynamicMemoryUsage() / 2);
+        pool.TrimToSize(0);
+    });
+}
+
 BENCHMARK(MempoolEviction, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolEvictionFlood, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <kernel/mempool_entry.h>
+#include <policy/fees.h>
+#include <policy/fees_args.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+
+#include <vector>
+
+static constexpr size_t BLOCK_TXS{5000};
+
+// Queue the mempool additions for a 5k transaction block and then process
+// that block, which applies the queued additions and records the confirmations.
+static void PolicyEstimatorProcessBlock(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>();
+    CBlockPolicyEstimator estimator{FeeestPath(*testing_setup->m_node.args), DEFAULT_ACCEPT_STALE_FEE_ESTIMATES};
+    FastRandomContext det_rand{true};
+
+    std::vector<CTransactionRef> txs;
+    std::vector<CAmount> fees;
+    for (size_t i = 0; i < BLOCK_TXS; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(Txid::FromUint256(det_rand.rand256()), 0);
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+        tx.vout[0].nValue = 10 * COIN;
+        txs.push_back(MakeTransactionRef(tx));
+        fees.push_back(1000 + det_rand.randrange(100000));
+    }
+
+    unsigned int height{1};
+    estimator.processBlock({}, height);
+    bench.batch(BLOCK_TXS).unit("tx").run([&] {
+        std::vector<RemovedMempoolTransactionInfo> block_txs;
+        block_txs.reserve(BLOCK_TXS);
+        for (size_t i = 0; i < BLOCK_TXS; ++i) {
+            const NewMempoolTransactionInfo tx_info{txs[i], fees[i], /*vsize=*/200, height,
+                                                    /*mempool_limit_bypassed=*/false,
+                                                    /*submitted_in_package=*/false,
+                                                    /*chainstate_is_current=*/true,
+                                                    /*has_no_mempool_parents=*/true};
+            estimator.processTransaction(tx_info);
+            LockPoints lp;
+            const CTxMemPoolEntry entry{txs[i], fees[i], /*time=*/0, height, /*entry_sequence=*/0,
+                                        /*spends_coinbase=*/false, /*sigops_cost=*/4, lp};
+            block_txs.emplace_back(entry);
+        }
+        estimator.processBlock(block_txs, ++height);
+    });
+}
+
+BENCHMARK(PolicyEstimatorProcessBlock, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <txorphanage.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t NUM_PARENTS{50};
+static constexpr uint32_t PARENT_OUTPUTS{50};
+static constexpr NodeId NUM_PEERS{125};
+static constexpr size_t NUM_ORPHANS{2500};
+
+// An orphan storm: many peers send orphans spending the outputs of a set of
+// missing parents. Measures adding the orphans, resolving them as each parent
+// arrives, and erasing the rest when the peers disconnect.
+static void OrphanageStorm(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+
+    std::vector<CTransactionRef> parents;
+    for (size_t i = 0; i < NUM_PARENTS; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(det_rand.rand256()), 0});
+        for (uint32_t n = 0; n < PARENT_OUTPUTS; ++n) {
+            tx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        }
+        parents.push_back(MakeTransactionRef(tx));
+    }
+
+    std::vector<CTransactionRef> orphans;
+    for (size_t i = 0; i < NUM_ORPHANS; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{parents[i % NUM_PARENTS]->GetHash(), uint32_t(i / NUM_PARENTS % PARENT_OUTPUTS)});
+        tx.vin.emplace_back(COutPoint{parents[det_rand.randrange(NUM_PARENTS)]->GetHash(), uint32_t(det_rand.randrange(PARENT_OUTPUTS))});
+        tx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        orphans.push_back(MakeTransactionRef(tx));
+    }
+
+    bench.batch(NUM_ORPHANS).unit("orphan").run([&] {
+        TxOrphanage orphanage;
+        for (size_t i = 0; i < NUM_ORPHANS; ++i) {
+            orphanage.AddTx(orphans[i], NodeId(i % NUM_PEERS));
+        }
+        // Half of the parents arrive, resolving their children.
+        for (size_t i = 0; i < NUM_PARENTS / 2; ++i) {
+            orphanage.AddChildrenToWorkSet(*parents[i]);
+        }
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            while (CTransactionRef tx = orphanage.GetTxToReconsider(peer)) {
+                orphanage.EraseTx(tx->GetWitnessHash());
+            }
+        }
+        // The other parents are mined, which leaves their children to be
+        // erased when the peers disconnect.
+        CBlock block;
+        block.vtx.assign(parents.begin() + NUM_PARENTS / 2, parents.end());
+        orphanage.EraseForBlock(block);
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            orphanage.EraseForPeer(peer);
+        }
+        assert(orphanage.Size() == 0);
+    });
+}
+
+BENCHMARK(OrphanageStorm, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,96 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <univalue.h>
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+static constexpr size_t NUM_ENTRIES{5000};
+
+namespace {
+
+struct LargeObject {
+    std::vector<std::string> keys;
+
+    LargeObject()
+    {
+        FastRandomContext rng{/*fDeterministic=*/true};
+        for (size_t i = 0; i < NUM_ENTRIES; ++i) {
+            keys.push_back(rng.rand256().GetHex());
+        }
+    }
+
+    // Shaped like the result of getrawmempool with verbose=true.
+    UniValue Build() const
+    {
+        UniValue obj(UniValue::VOBJ);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            UniValue entry(UniValue::VOBJ);
+            entry.pushKV("vsize", 141 + i);
+            entry.pushKV("weight", 564 + 4 * i);
+            entry.pushKV("time", 1700000000 + i);
+            entry.pushKV("height", 800000);
+            entry.pushKV("fee", 0.00001234);
+            entry.pushKV("wtxid", keys[i]);
+            UniValue depends(UniValue::VARR);
+            depends.push_back(keys[(i * 7) % keys.size()]);
+            entry.pushKV("depends", std::move(depends));
+            entry.pushKV("bip125-replaceable", false);
+            obj.pushKV(keys[i], std::move(entry));
+        }
+        return obj;
+    }
+};
+
+} // namespace
+
+static void UniValueBuildLargeObject(benchmark::Bench& bench)
+{
+    const LargeObject data;
+    bench.run([&] {
+        UniValue obj{data.Build()};
+        ankerl::nanobench::doNotOptimizeAway(obj);
+    });
+}
+
+static void UniValueFindValue(benchmark::Bench& bench)
+{
+    const LargeObject data;
+    const UniValue obj{data.Build()};
+    bench.batch(data.keys.size()).unit("key").run([&] {
+        for (const std::string& key : data.keys) {
+            ankerl::nanobench::doNotOptimizeAway(obj.find_value(key));
+        }
+    });
+}
+
+static void UniValueWrite(benchmark::Bench& bench)
+{
+    const UniValue obj{LargeObject{}.Build()};
+    bench.run([&] {
+        std::string str{obj.write()};
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+static void UniValueRead(benchmark::Bench& bench)
+{
+    const std::string str{LargeObject{}.Build().write()};
+    bench.run([&] {
+        UniValue obj;
+        assert(obj.read(str));
+        ankerl::nanobench::doNotOptimizeAway(obj);
+    });
+}
+
+BENCHMARK(UniValueBuildLargeObject, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueFindValue, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueWrite, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueRead, benchmark::PriorityLevel::HIGH);
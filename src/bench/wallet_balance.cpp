@@ -16,7 +16,7 @@
 #include <optional>
 
 namespace wallet {
-static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const bool add_mine)
+static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const bool add_mine, const int history = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
 
@@ -42,6 +42,23 @@ static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const b
     // Calls SyncWithValidationInterfaceQueue
     wallet.chain().waitForNotificationsIfTipChanged(uint256::ZERO);
 
+    // Give the wallet a long history of spent outputs: a chain of confirmed
+    // transactions, each spending the previous one's output.
+    if (history > 0) {
+        LOCK(wallet.cs_wallet);
+        const CScript script_mine{GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32M, "")))};
+        const TxStateConfirmed confirmed{wallet.GetLastBlockHash(), wallet.GetLastBlockHeight(), /*index=*/1};
+        COutPoint prevout{Txid::FromUint256(uint256::ONE), 0};
+        for (int i = 0; i < history; ++i) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(prevout);
+            mtx.vout.emplace_back(COIN, script_mine);
+            const CWalletTx* wtx{wallet.AddToWallet(MakeTransactionRef(mtx), confirmed)};
+            assert(wtx);
+            prevout = COutPoint{wtx->GetHash(), 0};
+        }
+    }
+
     auto bal = GetBalance(wallet); // Cache
 
     bench.run([&] {
@@ -55,9 +72,11 @@ static void WalletBalanceDirty(benchmark::Bench& bench) { WalletBalance(bench, /
 static void WalletBalanceClean(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceMine(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceWatch(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/false); }
+static void WalletBalanceLargeHistory(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true, /*history=*/20000); }
 
 BENCHMARK(WalletBalanceDirty, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceClean, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceMine, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceWatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletBalanceLargeHistory, benchmark::PriorityLevel::HIGH);
 } // namespace wallet
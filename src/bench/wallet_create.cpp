@@ -8,13 +8,15 @@
 #include <node/context.h>
 #include <random.h>
 #include <test/util/setup_common.h>
+#include <util/string.h>
 #include <wallet/context.h>
 #include <wallet/wallet.h>
 
 namespace wallet {
-static void WalletCreate(benchmark::Bench& bench, bool encrypted)
+static void WalletCreate(benchmark::Bench& bench, bool encrypted, int keypool_size = DEFAULT_KEYPOOL_SIZE)
 {
     auto test_setup = MakeNoLogFileContext<TestingSetup>();
+    test_setup->m_args.ForceSetArg("-keypool", util::ToString(keypool_size));
     FastRandomContext random;
 
     WalletContext context;
@@ -49,10 +51,12 @@ static void WalletCreate(benchmark::Bench& bench, bool encrypted)
 
 static void WalletCreatePlain(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/false); }
 static void WalletCreateEncrypted(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/true); }
+static void WalletCreateLargeKeypool(benchmark::Bench& bench) { WalletCreate(bench, /*encrypted=*/false, /*keypool_size=*/10000); }
 
 #ifdef USE_SQLITE
 BENCHMARK(WalletCreatePlain, benchmark::PriorityLevel::LOW);
 BENCHMARK(WalletCreateEncrypted, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletCreateLargeKeypool, benchmark::PriorityLevel::LOW);
 #endif
 
 } // namespace wallet
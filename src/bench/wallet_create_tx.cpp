@@ -32,10 +32,11 @@ TipBlock getTip(const CChainParams& params, const node::NodeContext& context)
            TipBlock{params.GenesisBlock().GetHash(), params.GenesisBlock().GetBlockTime(), 0};
 }
 
-void generateFakeBlock(const CChainParams& params,
-                       const node::NodeContext& context,
-                       CWallet& wallet,
-                       const CScript& coinbase_out_script)
+CTransactionRef generateFakeBlock(const CChainParams& params,
+                                  const node::NodeContext& context,
+                                  CWallet& wallet,
+                                  const CScript& coinbase_out_script,
+                                  const std::vector<CTransactionRef>& txs = {})
 {
     TipBlock tip{getTip(params, context)};
 
@@ -51,6 +52,7 @@ void generateFakeBlock(const CChainParams& params,
     coinbase_tx.vout[1].scriptPubKey = coinbase_out_script; // extra output
     coinbase_tx.vout[1].nValue = 1 * COIN;
     block.vtx = {MakeTransactionRef(std::move(coinbase_tx))};
+    block.vtx.insert(block.vtx.end(), txs.begin(), txs.end());
 
     block.nVersion = VERSIONBITS_LAST_OLD_BLOCK_VERSION;
     block.hashPrevBlock = tip.prev_block_hash;
@@ -70,6 +72,41 @@ void generateFakeBlock(const CChainParams& params,
     // notify wallet
     const auto& pindex = WITH_LOCK(::cs_main, return context.chainman->ActiveChain().Tip());
     wallet.blockConnected(ChainstateRole::NORMAL, kernel::MakeBlockInfo(pindex, &block));
+    return block.vtx[0];
+}
+
+/**
+ * Generate chain_size blocks, paying the coinbase of block i to dests[i % dests.size()].
+ * With history_ratio > 0, only one in every history_ratio coinbases is kept and the
+ * others are spent to a foreign script in the next block. This leaves the wallet with
+ * a long history of spent outputs, like a hot wallet that has been running for years.
+ *
+ * Returns the number of mature coinbase transactions left unspent.
+ */
+unsigned int generateFakeChain(const CChainParams& params,
+                               const node::NodeContext& context,
+                               CWallet& wallet,
+                               const std::vector<CScript>& dests,
+                               unsigned int chain_size,
+                               unsigned int history_ratio = 0)
+{
+    unsigned int mature_unspent{0};
+    std::vector<CTransactionRef> txs;
+    for (unsigned int i = 0; i < chain_size; ++i) {
+        const CTransactionRef coinbase{generateFakeBlock(params, context, wallet, dests[i % dests.size()], txs)};
+        txs.clear();
+        if (history_ratio > 0 && i % history_ratio != 0) {
+            CMutableTransaction spend;
+            for (uint32_t n = 0; n < coinbase->vout.size(); ++n) {
+                spend.vin.emplace_back(coinbase->GetHash(), n);
+            }
+            spend.vout.emplace_back(50 * COIN, CScript() << OP_TRUE);
+            txs.push_back(MakeTransactionRef(std::move(spend)));
+        } else if (i < chain_size - COINBASE_MATURITY) {
+            ++mature_unspent;
+        }
+    }
+    return mature_unspent;
 }
 
 struct PreSelectInputs {
@@ -78,7 +115,8 @@ struct PreSelectInputs {
     // future: this could have external inputs as well.
 };
 
-static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type, bool allow_other_inputs, std::optional<PreSelectInputs> preset_inputs)
+static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type, bool allow_other_inputs, std::optional<PreSelectInputs> preset_inputs,
+                           unsigned int history_ratio = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
 
@@ -98,13 +136,11 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     const auto& params = Params();
     const CScript coinbase_out{GetScriptForDestination(dest)};
     unsigned int chain_size = 5000; // 5k blocks means 10k UTXO for the wallet (minus 200 due COINBASE_MATURITY)
-    for (unsigned int i = 0; i < chain_size; ++i) {
-        generateFakeBlock(params, test_setup->m_node, wallet, coinbase_out);
-    }
+    const unsigned int mature_unspent{generateFakeChain(params, test_setup->m_node, wallet, {coinbase_out}, chain_size, history_ratio)};
 
     // Check available balance
     auto bal = WITH_LOCK(wallet.cs_wallet, return wallet::AvailableCoins(wallet).GetTotalAmount()); // Cache
-    assert(bal == 50 * COIN * (chain_size - COINBASE_MATURITY));
+    assert(bal == 50 * COIN * mature_unspent);
 
     wallet::CCoinControl coin_control;
     coin_control.m_allow_other_inputs = allow_other_inputs;
@@ -134,7 +170,8 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     });
 }
 
-static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type)
+static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type, unsigned int chain_size = 1000,
+                           unsigned int history_ratio = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
     // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
@@ -155,21 +192,16 @@ static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType
 
     // Generate chain; each coinbase will have two outputs to fill-up the wallet
     const auto& params = Params();
-    unsigned int chain_size = 1000;
-    for (unsigned int i = 0; i < chain_size / dest_wallet.size(); ++i) {
-        for (const auto& dest : dest_wallet) {
-            generateFakeBlock(params, test_setup->m_node, wallet, dest);
-        }
-    }
+    const unsigned int mature_unspent{generateFakeChain(params, test_setup->m_node, wallet, dest_wallet, chain_size, history_ratio)};
 
     // Check available balance
     auto bal = WITH_LOCK(wallet.cs_wallet, return wallet::AvailableCoins(wallet).GetTotalAmount()); // Cache
-    assert(bal == 50 * COIN * (chain_size - COINBASE_MATURITY));
+    assert(bal == 50 * COIN * mature_unspent);
 
     bench.epochIterations(2).run([&] {
         LOCK(wallet.cs_wallet);
         const auto& res = wallet::AvailableCoins(wallet);
-        assert(res.All().size() == (chain_size - COINBASE_MATURITY) * 2);
+        assert(res.All().size() == mature_unspent * 2);
     });
 }
 
@@ -179,8 +211,16 @@ static void WalletCreateTxUseOnlyPresetInputs(benchmark::Bench& bench) { WalletC
 static void WalletCreateTxUsePresetInputsAndCoinSelection(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
                                                                                                     {{/*num_of_internal_inputs=*/4}}); }
 
+static void WalletCreateTxLargeHistory(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
+                                                                                 {{/*num_of_internal_inputs=*/4}}, /*history_ratio=*/10); }
+
 static void WalletAvailableCoins(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}); }
 
+// About the same number of UTXOs as WalletAvailableCoins, in a wallet with 20 times the transactions
+static void WalletAvailableCoinsLargeHistory(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}, /*chain_size=*/10000, /*history_ratio=*/10); }
+
 BENCHMARK(WalletCreateTxUseOnlyPresetInputs, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletCreateTxUsePresetInputsAndCoinSelection, benchmark::PriorityLevel::LOW)
+BENCHMARK(WalletCreateTxLargeHistory, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletAvailableCoins, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletAvailableCoinsLargeHistory, benchmark::PriorityLevel::LOW);
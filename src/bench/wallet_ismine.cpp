@@ -17,7 +17,7 @@
 #include <wallet/walletutil.h>
 
 namespace wallet {
-static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0)
+static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0, bool mine = false)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
@@ -36,6 +36,7 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
 
     // For a descriptor wallet, fill with num_combo combo descriptors with random keys
     // This benchmarks a non-HD wallet migrated to descriptors
+    CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
     if (!legacy_wallet && num_combo > 0) {
         LOCK(wallet->cs_wallet);
         for (int i = 0; i < num_combo; ++i) {
@@ -47,15 +48,15 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
             WalletDescriptor w_desc(std::move(desc), /*creation_time=*/0, /*range_start=*/0, /*range_end=*/0, /*next_index=*/0);
             auto spkm = wallet->AddWalletDescriptor(w_desc, keys, /*label=*/"", /*internal=*/false);
             assert(spkm);
+            // Look up a script of a descriptor in the middle of the wallet
+            if (mine && i == num_combo / 2) script = GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()));
         }
     }
 
-    const CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
-
     bench.run([&] {
         LOCK(wallet->cs_wallet);
-        isminetype mine = wallet->IsMine(script);
-        assert(mine == ISMINE_NO);
+        isminetype res = wallet->IsMine(script);
+        assert(res == (mine ? ISMINE_SPENDABLE : ISMINE_NO));
     });
 
     TestUnloadWallet(std::move(wallet));
@@ -69,7 +70,12 @@ BENCHMARK(WalletIsMineLegacy, benchmark::PriorityLevel::LOW);
 #ifdef USE_SQLITE
 static void WalletIsMineDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false); }
 static void WalletIsMineMigratedDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/2000); }
+// Cost of a match should not depend on the number of descriptors
+static void WalletIsMineMigratedDescriptorsMine200(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/200, /*mine=*/true); }
+static void WalletIsMineMigratedDescriptorsMine2000(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/2000, /*mine=*/true); }
 BENCHMARK(WalletIsMineDescriptors, benchmark::PriorityLevel::LOW);
 BENCHMARK(WalletIsMineMigratedDescriptors, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineMigratedDescriptorsMine200, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineMigratedDescriptorsMine2000, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
@@ -28,7 +28,7 @@ static void AddTx(CWallet& wallet)
     wallet.AddToWallet(MakeTransactionRef(mtx), TxStateInactive{});
 }
 
-static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
+static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet, int num_txs = 1000)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
@@ -46,7 +46,7 @@ static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
     auto wallet = TestLoadWallet(std::move(database), context, create_flags);
 
     // Generate a bunch of transactions and addresses to put into the wallet
-    for (int i = 0; i < 1000; ++i) {
+    for (int i = 0; i < num_txs; ++i) {
         AddTx(*wallet);
     }
 
@@ -72,5 +72,8 @@ BENCHMARK(WalletLoadingLegacy, benchmark::PriorityLevel::HIGH);
 #ifdef USE_SQLITE
 static void WalletLoadingDescriptors(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false); }
 BENCHMARK(WalletLoadingDescriptors, benchmark::PriorityLevel::HIGH);
+// Enough transactions for their deserialization to be split across threads
+static void WalletLoadingDescriptorsLargeHistory(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false, /*num_txs=*/20000); }
+BENCHMARK(WalletLoadingDescriptorsLargeHistory, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
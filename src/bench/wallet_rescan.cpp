@@ -0,0 +1,52 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <interfaces/chain.h>
+#include <node/context.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+
+#include <cassert>
+
+namespace wallet {
+static constexpr int RESCAN_BLOCKS{400};
+
+// Rescan a chain in which every other block pays to the wallet, with the
+// slow (no block filter) variant that reads every block.
+static void WalletRescan(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
+    SetMockTime(test_setup->m_node.chainman->GetParams().GenesisBlock().nTime);
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    const std::string address{getnewaddress(wallet)};
+    for (int i = 0; i < RESCAN_BLOCKS / 2; ++i) {
+        generatetoaddress(test_setup->m_node, address);
+        generatetoaddress(test_setup->m_node, ADDRESS_BCRT1_UNSPENDABLE);
+    }
+    const uint256 genesis_hash{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    WITH_LOCK(wallet.cs_wallet, wallet.SetLastBlockProcessed(RESCAN_BLOCKS, WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveChain().Tip()->GetBlockHash())));
+
+    bench.batch(RESCAN_BLOCKS).unit("block").run([&] {
+        WalletRescanReserver reserver(wallet);
+        reserver.reserve();
+        const CWallet::ScanResult result{wallet.ScanForWalletTransactions(genesis_hash, /*start_height=*/0, /*max_height=*/{}, reserver, /*fUpdate=*/true, /*save_progress=*/false)};
+        assert(result.status == CWallet::ScanResult::SUCCESS);
+        assert(result.last_scanned_height == RESCAN_BLOCKS);
+    });
+    assert(WITH_LOCK(wallet.cs_wallet, return wallet.mapWallet.size()) == RESCAN_BLOCKS / 2);
+}
+
+BENCHMARK(WalletRescan, benchmark::PriorityLevel::HIGH);
+} // namespace wallet
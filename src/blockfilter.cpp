@@ -10,6 +10,7 @@
 #include <hash.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <script/interpreter.h>
 #include <script/script.h>
 #include <streams.h>
 #include <undo.h>
@@ -20,6 +21,7 @@ using util::Join;
 
 static const std::map<BlockFilterType, std::string> g_filter_types = {
     {BlockFilterType::BASIC, "basic"},
+    {BlockFilterType::OUTPOINT, "outpoint"},
 };
 
 uint64_t GCSFilter::HashToRange(const Element& element) const
@@ -32,10 +34,11 @@ uint64_t GCSFilter::HashToRange(const Element& element) const
 
 std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) const
 {
-    std::vector<uint64_t> hashed_elements;
-    hashed_elements.reserve(elements.size());
-    for (const Element& element : elements) {
-        hashed_elements.push_back(HashToRange(element));
+    std::vector<Span<const unsigned char>> inputs(elements.begin(), elements.end());
+    std::vector<uint64_t> hashed_elements(inputs.size());
+    SipHashBatch(m_params.m_siphash_k0, m_params.m_siphash_k1, inputs, hashed_elements);
+    for (uint64_t& hash : hashed_elements) {
+        hash = FastRange64(hash, m_F);
     }
     std::sort(hashed_elements.begin(), hashed_elements.end());
     return hashed_elements;
@@ -61,11 +64,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{Span{m_encoded}.last(stream.size())};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        reader.Read(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (reader.RemainingBytes() != 0) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -108,12 +111,12 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{Span{m_encoded}.last(stream.size())};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = reader.Read(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -206,6 +209,43 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
     return elements;
 }
 
+GCSFilter::Element OutPointFilterElement(const CScript& script)
+{
+    int witness_version;
+    std::vector<unsigned char> witness_program;
+    if (script.IsWitnessProgram(witness_version, witness_program) &&
+        witness_version == 1 && witness_program.size() == WITNESS_V1_TAPROOT_SIZE) {
+        return witness_program;
+    }
+    return {script.begin(), script.end()};
+}
+
+GCSFilter::Element OutPointFilterElement(const COutPoint& outpoint)
+{
+    GCSFilter::Element element;
+    VectorWriter{element, 0, outpoint};
+    return element;
+}
+
+static GCSFilter::ElementSet OutPointFilterElements(const CBlock& block)
+{
+    GCSFilter::ElementSet elements;
+
+    for (const CTransactionRef& tx : block.vtx) {
+        for (const CTxOut& txout : tx->vout) {
+            const CScript& script = txout.scriptPubKey;
+            if (script.empty() || script[0] == OP_RETURN) continue;
+            elements.insert(OutPointFilterElement(script));
+        }
+        if (tx->IsCoinBase()) continue;
+        for (const CTxIn& txin : tx->vin) {
+            elements.insert(OutPointFilterElement(txin.prevout));
+        }
+    }
+
+    return elements;
+}
+
 BlockFilter::BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
                          std::vector<unsigned char> filter, bool skip_decode_check)
     : m_filter_type(filter_type), m_block_hash(block_hash)
@@ -224,7 +264,8 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    m_filter = GCSFilter(params, m_filter_type == BlockFilterType::OUTPOINT ? OutPointFilterElements(block)
+                                                                             : BasicFilterElements(block, block_undo));
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
@@ -236,6 +277,12 @@ bool BlockFilter::BuildParams(GCSFilter::Params& params) const
         params.m_P = BASIC_FILTER_P;
         params.m_M = BASIC_FILTER_M;
         return true;
+    case BlockFilterType::OUTPOINT:
+        params.m_siphash_k0 = m_block_hash.GetUint64(0);
+        params.m_siphash_k1 = m_block_hash.GetUint64(1);
+        params.m_P = OUTPOINT_FILTER_P;
+        params.m_M = OUTPOINT_FILTER_M;
+        return true;
     case BlockFilterType::INVALID:
         return false;
     }
@@ -20,6 +20,8 @@
 
 class CBlock;
 class CBlockUndo;
+class COutPoint;
+class CScript;
 
 /**
  * This implements a Golomb-coded set as defined in BIP 158. It is a
@@ -89,9 +91,16 @@ public:
 constexpr uint8_t BASIC_FILTER_P = 19;
 constexpr uint32_t BASIC_FILTER_M = 784931;
 
+// Half the false positive rate of basic filters, for about one more bit per element.
+constexpr uint8_t OUTPOINT_FILTER_P = 20;
+constexpr uint32_t OUTPOINT_FILTER_M = 1569862;
+
 enum class BlockFilterType : uint8_t
 {
     BASIC = 0,
+    //! Output scripts, with taproot outputs reduced to their output key, and
+    //! the outpoints spent by the block.
+    OUTPOINT = 1,
     INVALID = 255,
 };
 
@@ -107,6 +116,12 @@ const std::set<BlockFilterType>& AllBlockFilterTypes();
 /** Get a comma-separated list of known filter type names. */
 const std::string& ListBlockFilterTypes();
 
+/** The element committing to an output script in an OUTPOINT filter. */
+GCSFilter::Element OutPointFilterElement(const CScript& script);
+
+/** The element committing to a spent outpoint in an OUTPOINT filter. */
+GCSFilter::Element OutPointFilterElement(const COutPoint& outpoint);
+
 /**
  * Complete block filter struct as defined in BIP 157. Serialization matches
  * payload of "cfilter" messages.
@@ -4,7 +4,11 @@
 
 #include <crypto/siphash.h>
 
+#include <crypto/common.h>
+
+#include <algorithm>
 #include <bit>
+#include <cassert>
 
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
@@ -52,6 +56,20 @@ CSipHasher& CSipHasher::Write(Span<const unsigned char> data)
     uint8_t c = count;
 
     while (data.size() > 0) {
+        if ((c & 7) == 0 && data.size() >= 8) {
+            // Aligned to a block: consume whole words at once.
+            do {
+                t = ReadLE64(data.data());
+                v3 ^= t;
+                SIPROUND;
+                SIPROUND;
+                v0 ^= t;
+                c += 8;
+                data = data.subspan(8);
+            } while (data.size() >= 8);
+            t = 0;
+            continue;
+        }
         t |= uint64_t{data.front()} << (8 * (c % 8));
         c++;
         if ((c & 7) == 0) {
@@ -172,3 +190,81 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+/** Hash the words of data from block offset `words` on, and finalize. The state
+ *  must have absorbed the first `words` blocks already. */
+uint64_t SipHashFinish(uint64_t v0, uint64_t v1, uint64_t v2, uint64_t v3, Span<const unsigned char> data, size_t words)
+{
+    size_t pos = words * 8;
+    for (; pos + 8 <= data.size(); pos += 8) {
+        const uint64_t m = ReadLE64(data.data() + pos);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+    uint64_t t = uint64_t{data.size()} << 56;
+    for (size_t i = 0; pos + i < data.size(); ++i) {
+        t |= uint64_t{data[pos + i]} << (8 * i);
+    }
+    v3 ^= t;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= t;
+    v2 ^= 0xFF;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+} // namespace
+
+void SipHashBatch(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> in, Span<uint64_t> out)
+{
+    assert(in.size() == out.size());
+    static constexpr size_t LANES{4};
+
+    size_t i = 0;
+    for (; i + LANES <= in.size(); i += LANES) {
+        uint64_t v0[LANES], v1[LANES], v2[LANES], v3[LANES];
+        size_t words = SIZE_MAX;
+        for (size_t l = 0; l < LANES; ++l) {
+            v0[l] = 0x736f6d6570736575ULL ^ k0;
+            v1[l] = 0x646f72616e646f6dULL ^ k1;
+            v2[l] = 0x6c7967656e657261ULL ^ k0;
+            v3[l] = 0x7465646279746573ULL ^ k1;
+            words = std::min(words, in[i + l].size() / 8);
+        }
+        // Absorb the words all lanes have in lockstep. Elements hashed
+        // together tend to have similar sizes, so this covers most of the input.
+        for (size_t w = 0; w < words; ++w) {
+            for (size_t l = 0; l < LANES; ++l) {
+                const uint64_t m = ReadLE64(in[i + l].data() + w * 8);
+                uint64_t a = v0[l], b = v1[l], c = v2[l], d = v3[l] ^ m;
+                for (int r = 0; r < 2; ++r) {
+                    a += b; b = std::rotl(b, 13); b ^= a;
+                    a = std::rotl(a, 32);
+                    c += d; d = std::rotl(d, 16); d ^= c;
+                    a += d; d = std::rotl(d, 21); d ^= a;
+                    c += b; b = std::rotl(b, 17); b ^= c;
+                    c = std::rotl(c, 32);
+                }
+                v0[l] = a ^ m;
+                v1[l] = b;
+                v2[l] = c;
+                v3[l] = d;
+            }
+        }
+        for (size_t l = 0; l < LANES; ++l) {
+            out[i + l] = SipHashFinish(v0[l], v1[l], v2[l], v3[l], in[i + l], words);
+        }
+    }
+    for (; i < in.size(); ++i) {
+        out[i] = SipHashFinish(0x736f6d6570736575ULL ^ k0, 0x646f72616e646f6dULL ^ k1,
+                               0x6c7967656e657261ULL ^ k0, 0x7465646279746573ULL ^ k1, in[i], 0);
+    }
+}
@@ -45,4 +45,14 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** SipHash-2-4 of many byte strings with the same key.
+ *
+ *  It is identical to computing, for each i:
+ *    out[i] = CSipHasher(k0, k1).Write(in[i]).Finalize()
+ *
+ *  but hashes several inputs at once in interleaved lanes, so that the rounds
+ *  of independent inputs overlap instead of waiting on each other.
+ */
+void SipHashBatch(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> in, Span<uint64_t> out);
+
 #endif // BGL_CRYPTO_SIPHASH_H
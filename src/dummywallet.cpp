@@ -38,6 +38,7 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-maxapsfee=<n>",
         "-maxtxfee=<amt>",
         "-mintxfee=<amt>",
+        "-payoutwindow=<n>",
         "-paytxfee=<amt>",
         "-signer=<cmd>",
         "-spendzeroconfchange",
@@ -53,6 +54,7 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-walletrejectlongchains",
         "-walletcrosschain",
         "-unsafesqlitesync",
+        "-sqlitewal",
         "-swapbdbendian",
     });
 }
@@ -9,8 +9,12 @@
 #include <httpserver.h>
 #include <logging.h>
 #include <netaddress.h>
+#include <rpc/binary.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <streams.h>
+#include <univalue_stream.h>
+#include <util/check.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
@@ -24,6 +28,8 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 using util::SplitString;
@@ -99,6 +105,18 @@ static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCReq
     req->WriteReply(nStatus, strReply);
 }
 
+/** The reply object to a request, split around the place of its result. */
+static std::pair<std::string, std::string> SplitReplyObj(const JSONRPCRequest& jreq)
+{
+    const std::string reply{JSONRPCReplyObj(NullUniValue, NullUniValue, jreq.id, jreq.m_json_version).write()};
+    // The result comes before the id, so this finds the result even if the id
+    // contains the same text.
+    const size_t pos{reply.find("\"result\":null")};
+    CHECK_NONFATAL(pos != std::string::npos);
+    const size_t split{pos + std::string_view{"\"result\":"}.size()};
+    return {reply.substr(0, split), reply.substr(split + std::string_view{"null"}.size())};
+}
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool multiUserAuthorized(std::string strUserPass)
@@ -154,14 +172,9 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return multiUserAuthorized(strUserPass);
 }
 
-static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
+/** Check the authorization header of a request, replying to it if it fails. */
+static bool CheckAuthorization(HTTPRequest* req, const std::string& peer_addr, std::string& auth_user)
 {
-    // JSONRPC handles only POST
-    if (req->GetRequestMethod() != HTTPRequest::POST) {
-        req->WriteReply(HTTP_BAD_METHOD, "JSONRPC server handles only POST requests");
-        return false;
-    }
-    // Check authorization
     std::pair<bool, std::string> authHeader = req->GetHeader("authorization");
     if (!authHeader.first) {
         req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
@@ -169,11 +182,8 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         return false;
     }
 
-    JSONRPCRequest jreq;
-    jreq.context = context;
-    jreq.peerAddr = req->GetPeer().ToStringAddrPort();
-    if (!RPCAuthorized(authHeader.second, jreq.authUser)) {
-        LogPrintf("ThreadRPCServer incorrect password attempt from %s\n", jreq.peerAddr);
+    if (!RPCAuthorized(authHeader.second, auth_user)) {
+        LogPrintf("ThreadRPCServer incorrect password attempt from %s\n", peer_addr);
 
         /* Deter brute-forcing
            If this results in a DoS the user really
@@ -184,6 +194,23 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         req->WriteReply(HTTP_UNAUTHORIZED);
         return false;
     }
+    return true;
+}
+
+static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
+{
+    // JSONRPC handles only POST
+    if (req->GetRequestMethod() != HTTPRequest::POST) {
+        req->WriteReply(HTTP_BAD_METHOD, "JSONRPC server handles only POST requests");
+        return false;
+    }
+
+    JSONRPCRequest jreq;
+    jreq.context = context;
+    jreq.peerAddr = req->GetPeer().ToStringAddrPort();
+    if (!CheckAuthorization(req, jreq.peerAddr, jreq.authUser)) {
+        return false;
+    }
 
     try {
         // Parse request
@@ -215,7 +242,29 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
-            reply = JSONRPCExec(jreq, catch_errors);
+
+            // Methods with large results may stream them straight into the
+            // reply body, see JSONRPCRequest::m_result_writer. The start of
+            // the reply object is written along with the first part of the
+            // result. Nothing is sent before WriteReply(), so on failure the
+            // body is discarded and the error is replied as usual.
+            const std::pair<std::string, std::string> reply_parts{SplitReplyObj(jreq)};
+            bool result_sent{false};
+            UniValueStreamWriter result_writer{[&](std::string_view chunk) {
+                if (!result_sent) {
+                    req->WriteBody(reply_parts.first);
+                    result_sent = true;
+                }
+                req->WriteBody(chunk);
+            }};
+            if (!jreq.IsNotification()) jreq.m_result_writer = &result_writer;
+            try {
+                reply = JSONRPCExec(jreq, catch_errors);
+            } catch (...) {
+                if (result_sent) req->ClearBody();
+                throw;
+            }
+            jreq.m_result_writer = nullptr;
 
             if (jreq.IsNotification()) {
                 // Even though we do execute notifications, we do not respond to them
@@ -223,6 +272,17 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                 return true;
             }
 
+            if (result_writer.size() > 0) {
+                if (reply.find_value("error").isNull()) {
+                    result_writer.flush();
+                    req->WriteBody(reply_parts.second);
+                    req->WriteHeader("Content-Type", "application/json");
+                    req->WriteReply(HTTP_OK, "\n");
+                    return true;
+                }
+                if (result_sent) req->ClearBody();
+            }
+
         // array of requests
         } else if (valRequest.isArray()) {
             // Check authorization for each request's method
@@ -290,6 +350,104 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
     return true;
 }
 
+/**
+ * Binary RPC: the body of a request is a sequence of calls, each a method name
+ * and an argument payload, both prefixed with their CompactSize length. The
+ * reply holds, for each call in order, a status byte followed by either the
+ * length-prefixed result (status 0) or an int32 error code and message
+ * (status 1), with the codes of JSON-RPC.
+ */
+static bool HTTPReq_BinaryRPC(const std::any& context, HTTPRequest* req)
+{
+    if (req->GetRequestMethod() != HTTPRequest::POST) {
+        req->WriteReply(HTTP_BAD_METHOD, "Binary RPC server handles only POST requests");
+        return false;
+    }
+
+    const std::string peer_addr{req->GetPeer().ToStringAddrPort()};
+    std::string auth_user;
+    if (!CheckAuthorization(req, peer_addr, auth_user)) {
+        return false;
+    }
+
+    const std::string body{req->ReadBody()};
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> calls;
+    try {
+        SpanReader stream{MakeUCharSpan(body)};
+        while (!stream.empty()) {
+            if (calls.size() == MAX_BINARY_RPC_CALLS) {
+                req->WriteReply(HTTP_BAD_REQUEST, strprintf("Binary RPC request has more than %u calls", MAX_BINARY_RPC_CALLS));
+                return false;
+            }
+            auto& [method, params]{calls.emplace_back()};
+            stream >> method >> params;
+        }
+    } catch (const std::ios_base::failure& e) {
+        req->WriteReply(HTTP_BAD_REQUEST, strprintf("Malformed binary RPC request: %s", e.what()));
+        return false;
+    }
+
+    const bool user_has_whitelist = g_rpc_whitelist.count(auth_user);
+    if (!user_has_whitelist && g_rpc_whitelist_default) {
+        LogPrintf("RPC User %s not allowed to call any methods\n", auth_user);
+        req->WriteReply(HTTP_FORBIDDEN);
+        return false;
+    }
+    for (const auto& [method, params] : calls) {
+        if (user_has_whitelist && !g_rpc_whitelist[auth_user].count(method)) {
+            LogPrintf("RPC User %s not allowed to call method %s\n", auth_user, method);
+            req->WriteReply(HTTP_FORBIDDEN);
+            return false;
+        }
+    }
+
+    DataStream reply;
+    DataStream result;
+    for (const auto& [method, params] : calls) {
+        result.clear();
+        bool success{false};
+        int code{RPC_MISC_ERROR};
+        std::string message;
+        if (fLogIPs) {
+            LogPrint(BCLog::RPC, "BinaryRPC method=%s user=%s peeraddr=%s\n", SanitizeString(method), auth_user, peer_addr);
+        } else {
+            LogPrint(BCLog::RPC, "BinaryRPC method=%s user=%s\n", SanitizeString(method), auth_user);
+        }
+        try {
+            RpcInterruptionPoint();
+            if (std::string status; RPCIsInWarmup(&status)) {
+                throw JSONRPCError(RPC_IN_WARMUP, status);
+            }
+            if (reply.size() >= MAX_BINARY_RPC_REPLY_SIZE) {
+                throw JSONRPCError(RPC_MISC_ERROR, strprintf("Binary RPC reply size limit of %u bytes reached", MAX_BINARY_RPC_REPLY_SIZE));
+            }
+            SpanReader params_stream{params};
+            ExecuteBinaryRPC(context, method, params_stream, result);
+            success = true;
+        } catch (const UniValue& e) {
+            code = e.find_value("code").getInt<int>();
+            message = e.find_value("message").get_str();
+        } catch (const std::ios_base::failure& e) {
+            code = RPC_DESERIALIZATION_ERROR;
+            message = e.what();
+        } catch (const std::exception& e) {
+            code = RPC_MISC_ERROR;
+            message = e.what();
+        }
+        if (success) {
+            reply << uint8_t{0};
+            WriteCompactSize(reply, result.size());
+            reply.write(result);
+        } else {
+            reply << uint8_t{1} << int32_t{code} << message;
+        }
+    }
+
+    req->WriteHeader("Content-Type", "application/octet-stream");
+    req->WriteReply(HTTP_OK, reply);
+    return true;
+}
+
 static bool InitRPCAuthentication()
 {
     if (gArgs.GetArg("-rpcpassword", "") == "")
@@ -366,6 +524,9 @@ bool StartHTTPRPC(const std::any& context)
     if (g_wallet_init_interface.HasWalletSupport()) {
         RegisterHTTPHandler("/wallet/", false, handle_rpc);
     }
+    if (gArgs.GetBoolArg("-rpcbinary", DEFAULT_RPC_BINARY)) {
+        RegisterHTTPHandler("/binary", true, [context](HTTPRequest* req, const std::string&) { return HTTPReq_BinaryRPC(context, req); });
+    }
     struct event_base* eventBase = EventBase();
     assert(eventBase);
     httpRPCTimerInterface = std::make_unique<HTTPRPCTimerInterface>(eventBase);
@@ -385,6 +546,9 @@ void StopHTTPRPC()
     if (g_wallet_init_interface.HasWalletSupport()) {
         UnregisterHTTPHandler("/wallet/", false);
     }
+    if (gArgs.GetBoolArg("-rpcbinary", DEFAULT_RPC_BINARY)) {
+        UnregisterHTTPHandler("/binary", true);
+    }
     if (httpRPCTimerInterface) {
         RPCUnsetTimerInterface(httpRPCTimerInterface.get());
         httpRPCTimerInterface.reset();
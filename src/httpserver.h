@@ -121,10 +121,24 @@ public:
      */
     void WriteHeader(const std::string& hdr, const std::string& value);
 
+    /**
+     * Append data to the body of the reply, which is sent by WriteReply.
+     * This allows a large reply to be produced in parts, without holding all
+     * of it in a single buffer first.
+     */
+    void WriteBody(std::string_view data)
+    {
+        WriteBody(std::as_bytes(std::span{data}));
+    }
+    void WriteBody(std::span<const std::byte> data);
+    /** Discard the data appended with WriteBody, e.g. to reply an error instead. */
+    void ClearBody();
+
     /**
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
-     * reply is the body of the reply. Keep it empty to send a standard message.
+     * reply is the body of the reply, appended to anything passed to WriteBody.
+     * Keep both empty to send a standard message.
      *
      * @note Can be called only once. As this will give the request back to the
      * main thread, do not call any other HTTPRequest methods after calling this.
@@ -0,0 +1,198 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addrindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <kernel/chain.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <map>
+
+static constexpr uint8_t DB_SCRIPT_HISTORY{'a'};
+
+std::unique_ptr<AddrIndex> g_addr_index;
+
+namespace {
+
+uint256 ScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+/** Entries are sorted by script hash and then by height, so the history of a
+ * script can be read with a single iterator. */
+struct DBScriptKey {
+    uint256 script_hash;
+    int height;
+
+    explicit DBScriptKey(const uint256& script_hash_in, int height_in) : script_hash(script_hash_in), height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT_HISTORY);
+        s << script_hash;
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPT_HISTORY) {
+            throw std::ios_base::failure("Invalid format for addrindex DB script key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+    }
+};
+
+/** The transactions of a block touching a script, sorted by position. Each
+ * one is stored as a varint of the distance to the previous position, with
+ * the lowest bit set for spends. */
+struct DBPostings {
+    std::vector<std::pair<uint32_t, bool>> txs;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        WriteCompactSize(s, txs.size());
+        uint32_t prev_pos{0};
+        for (const auto& [tx_pos, spend] : txs) {
+            s << VARINT((uint64_t{tx_pos - prev_pos} << 1) | spend);
+            prev_pos = tx_pos;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        txs.resize(ReadCompactSize(s));
+        uint32_t prev_pos{0};
+        for (auto& [tx_pos, spend] : txs) {
+            uint64_t code;
+            s >> VARINT(code);
+            tx_pos = prev_pos + (code >> 1);
+            spend = code & 1;
+            prev_pos = tx_pos;
+        }
+    }
+
+    void Add(uint32_t tx_pos, bool spend)
+    {
+        // Several outputs (or inputs) of a transaction can be for the same script.
+        if (txs.empty() || txs.back() != std::make_pair(tx_pos, spend)) txs.emplace_back(tx_pos, spend);
+    }
+};
+
+/** The postings of a block, by script hash. */
+struct BlockPostings final : IndexBlockData {
+    std::map<uint256, DBPostings> scripts;
+};
+
+} // namespace
+
+AddrIndex::AddrIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "addrindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "addrindex"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+std::unique_ptr<IndexBlockData> AddrIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    auto postings{std::make_unique<BlockPostings>()};
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return postings;
+
+    const CBlock& data{*Assert(block.data)};
+    const CBlockUndo& block_undo{*Assert(block.undo_data)};
+    for (uint32_t i = 0; i < data.vtx.size(); ++i) {
+        const CTransaction& tx{*data.vtx[i]};
+        for (const CTxOut& out : tx.vout) {
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            postings->scripts[ScriptHash(out.scriptPubKey)].Add(i, /*spend=*/false);
+        }
+        // The coinbase tx has no undo data since no former output is spent
+        if (i == 0) continue;
+        for (const Coin& coin : block_undo.vtxundo.at(i - 1).vprevout) {
+            postings->scripts[ScriptHash(coin.out.scriptPubKey)].Add(i, /*spend=*/true);
+        }
+    }
+    return postings;
+}
+
+bool AddrIndex::CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch)
+{
+    for (const auto& [script_hash, txs] : Assert(static_cast<const BlockPostings*>(prepared))->scripts) {
+        batch.Write(DBScriptKey(script_hash, block.height), txs);
+    }
+    return true;
+}
+
+bool AddrIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    CDBBatch batch(*m_db);
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+        const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+        do {
+            CBlock block;
+            CBlockUndo block_undo;
+            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip) ||
+                !m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *iter_tip)) {
+                LogError("%s: Failed to read block %s from disk\n",
+                         __func__, iter_tip->GetBlockHash().ToString());
+                return false;
+            }
+
+            // Erase the entries of every script the disconnected block touched.
+            interfaces::BlockInfo block_info{kernel::MakeBlockInfo(iter_tip, &block)};
+            block_info.undo_data = &block_undo;
+            const auto postings{CustomPrepare(block_info)};
+            for (const auto& [script_hash, txs] : static_cast<const BlockPostings&>(*postings).scripts) {
+                batch.Erase(DBScriptKey(script_hash, iter_tip->nHeight));
+            }
+
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip_index != iter_tip);
+    }
+    return m_db->WriteBatch(batch);
+}
+
+std::optional<int> AddrIndex::FindScriptHistory(const CScript& script, int start_height, int stop_height, size_t max_count,
+                                                std::vector<AddrIndexPosting>& postings) const
+{
+    const uint256 script_hash{ScriptHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    DBScriptKey key(script_hash, start_height);
+    for (db_it->Seek(key); db_it->Valid(); db_it->Next()) {
+        if (!db_it->GetKey(key) || key.script_hash != script_hash || key.height > stop_height) break;
+        if (postings.size() >= max_count) return key.height;
+        DBPostings value;
+        if (!db_it->GetValue(value)) {
+            LogError("%s: Failed to read addrindex entry for height %d\n", __func__, key.height);
+            break;
+        }
+        for (const auto& [tx_pos, spend] : value.txs) {
+            postings.push_back({key.height, tx_pos, spend});
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BGL_INDEX_ADDRINDEX_H
+#define BGL_INDEX_ADDRINDEX_H
+
+#include <index/base.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_ADDRINDEX{false};
+
+/** A transaction touching a script, as recorded by the AddrIndex. */
+struct AddrIndexPosting {
+    int height;
+    //! Position of the transaction in its block
+    uint32_t tx_pos;
+    //! Whether the transaction spends an output to the script, rather than
+    //! creating one
+    bool spend;
+
+    friend bool operator==(const AddrIndexPosting&, const AddrIndexPosting&) = default;
+};
+
+/**
+ * AddrIndex records, for every scriptPubKey, the transactions that created
+ * or spent an output to it. For each block touching a script, a single entry
+ * keyed by the script hash and block height holds the delta and varint
+ * encoded positions of those transactions in the block.
+ */
+class AddrIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool AllowPrune() const override { return false; }
+
+protected:
+    bool NeedsUndoData() const override { return true; }
+
+    std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddrIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the transactions touching a script, in chain order.
+    ///
+    /// @param[in]   script        The scriptPubKey to look up.
+    /// @param[in]   start_height  Height of the first block to return postings for.
+    /// @param[in]   stop_height   Height of the last block to return postings for.
+    /// @param[in]   max_count     Stop after the first block at which this many postings were found.
+    /// @param[out]  postings      The postings found.
+    /// @return  The height to continue from if postings up to stop_height were
+    ///          left out because of max_count, std::nullopt otherwise.
+    std::optional<int> FindScriptHistory(const CScript& script, int start_height, int stop_height, size_t max_count,
+                                         std::vector<AddrIndexPosting>& postings) const;
+};
+
+/// The global address index, used by the getaddresshistory RPC. May be null.
+extern std::unique_ptr<AddrIndex> g_addr_index;
+
+#endif // BGL_INDEX_ADDRINDEX_H
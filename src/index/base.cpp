@@ -4,6 +4,7 @@
 
 #include <chainparams.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <index/base.h>
 #include <interfaces/chain.h>
 #include <kernel/chain.h>
@@ -14,18 +15,31 @@
 #include <node/database_args.h>
 #include <node/interface_ui.h>
 #include <tinyformat.h>
+#include <undo.h>
 #include <util/thread.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
 
+//! Number of blocks read and prepared ahead of the one being indexed during initial sync.
+constexpr size_t SYNC_PREFETCH_BLOCKS{32};
+//! Maximum number of worker threads used by each index during initial sync.
+constexpr int MAX_SYNC_THREADS{8};
+
 template <typename... Args>
 void BaseIndex::FatalErrorf(const char* fmt, const Args&... args)
 {
@@ -140,21 +154,271 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
+static bool ReadBlockUndo(const node::BlockManager& blockman, const CBlockIndex& index, CBlockUndo& block_undo)
+{
+    // The genesis block has no undo data.
+    return index.nHeight == 0 || blockman.UndoReadFromDisk(block_undo, index);
+}
+
+namespace {
+/** A block read and prepared by a SyncPrefetcher worker. */
+struct SyncBlock {
+    const CBlockIndex* pindex;
+    CBlock block;
+    CBlockUndo undo;
+    std::unique_ptr<IndexBlockData> prepared;
+    //! Whether the block (and undo data) could be read
+    bool ok{false};
+    bool done{false};
+};
+
+/**
+ * Reads and prepares the blocks ahead of the one being indexed on a pool of
+ * worker threads during the initial sync of an index. Blocks are handed back
+ * to the sync thread in chain order.
+ */
+class SyncPrefetcher
+{
+public:
+    using PrepareFn = std::function<void(SyncBlock&)>;
+
+    SyncPrefetcher(int threads, size_t depth, PrepareFn prepare)
+        : m_depth{depth}, m_prepare{std::move(prepare)}
+    {
+        m_workers.reserve(threads);
+        for (int n = 0; n < threads; ++n) {
+            m_workers.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("idxsync.%i", n));
+                Loop();
+            });
+        }
+    }
+
+    ~SyncPrefetcher()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_work_cv.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    SyncPrefetcher(const SyncPrefetcher&) = delete;
+    SyncPrefetcher& operator=(const SyncPrefetcher&) = delete;
+
+    /** Queue pindex and the blocks following it in chain, up to m_depth blocks.
+     *  Anything queued that does not start at pindex (after a reorg) is dropped. */
+    void Fill(const CBlockIndex* pindex, const CChain& chain) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex)
+    {
+        LOCK(m_mutex);
+        if (!m_queue.empty() && m_queue.front()->pindex != pindex) {
+            m_queue.clear();
+            m_pending.clear();
+        }
+        const CBlockIndex* next{m_queue.empty() ? pindex : chain.Next(m_queue.back()->pindex)};
+        for (; next && m_queue.size() < m_depth; next = chain.Next(next)) {
+            auto item{std::make_shared<SyncBlock>()};
+            item->pindex = next;
+            m_queue.push_back(item);
+            m_pending.push_back(std::move(item));
+            m_work_cv.notify_one();
+        }
+    }
+
+    /** Wait for and return the first queued block. Fill must have been called
+     *  before. */
+    std::shared_ptr<SyncBlock> Pop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        std::shared_ptr<SyncBlock> item{std::move(m_queue.front())};
+        m_queue.pop_front();
+        m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return item->done; });
+        return item;
+    }
+
+private:
+    const size_t m_depth;
+    const PrepareFn m_prepare;
+
+    Mutex m_mutex;
+    //! Signalled when blocks are queued or on shutdown
+    std::condition_variable m_work_cv;
+    //! Signalled when a worker finished preparing a block
+    std::condition_variable m_done_cv;
+    //! All queued blocks, in chain order
+    std::deque<std::shared_ptr<SyncBlock>> m_queue GUARDED_BY(m_mutex);
+    //! Queued blocks not yet picked up by a worker
+    std::deque<std::shared_ptr<SyncBlock>> m_pending GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::shared_ptr<SyncBlock> item;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_pending.empty(); });
+                if (m_stop) return;
+                item = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+
+            m_prepare(*item);
+
+            WITH_LOCK(m_mutex, item->done = true);
+            m_done_cv.notify_all();
+        }
+    }
+};
+
+/**
+ * Writes the batches collected during the initial sync of an index on a
+ * background thread. Only one batch is handed over at a time, so at most two
+ * batches (the one being written and the one being collected) are held in
+ * memory.
+ */
+class SyncWriter
+{
+public:
+    //! Called on the writer thread once a batch was written.
+    using WrittenFn = std::function<void()>;
+
+    explicit SyncWriter(CDBWrapper& db) : m_db{db}
+    {
+        m_thread = std::thread([this]() {
+            util::ThreadRename("idxwrite");
+            Loop();
+        });
+    }
+
+    ~SyncWriter()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    SyncWriter(const SyncWriter&) = delete;
+    SyncWriter& operator=(const SyncWriter&) = delete;
+
+    /** Hand over a batch to be written, after the previous one was written.
+     *  Returns false if writing a previous batch failed. */
+    bool Write(std::unique_ptr<CDBBatch> batch, WrittenFn written) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_batch && !m_writing; });
+            if (!m_ok) return false;
+            m_batch = std::move(batch);
+            m_written = std::move(written);
+        }
+        m_cv.notify_all();
+        return true;
+    }
+
+    /** Wait for all batches handed over to be written. Returns false if
+     *  writing any of them failed. */
+    bool Wait() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_batch && !m_writing; });
+        return m_ok;
+    }
+
+private:
+    CDBWrapper& m_db;
+
+    Mutex m_mutex;
+    //! Signalled when a batch is handed over, written, or on shutdown
+    std::condition_variable m_cv;
+    std::unique_ptr<CDBBatch> m_batch GUARDED_BY(m_mutex);
+    WrittenFn m_written GUARDED_BY(m_mutex);
+    bool m_writing GUARDED_BY(m_mutex){false};
+    bool m_ok GUARDED_BY(m_mutex){true};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::unique_ptr<CDBBatch> batch;
+            WrittenFn written;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_batch; });
+                // A batch handed over before shutdown is still written.
+                if (!m_batch) return;
+                batch = std::move(m_batch);
+                written = std::move(m_written);
+                m_writing = true;
+            }
+
+            bool ok{false};
+            try {
+                ok = m_db.WriteBatch(*batch);
+            } catch (const std::exception& e) {
+                LogError("%s: Failed to write index batch: %s\n", __func__, e.what());
+            }
+            if (ok) written();
+
+            {
+                LOCK(m_mutex);
+                m_writing = false;
+                m_ok = m_ok && ok;
+            }
+            m_cv.notify_all();
+        }
+    }
+};
+} // namespace
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
+        // Reading blocks and CustomPrepare run on the workers, the sync thread
+        // only calls CustomAppend.
+        SyncPrefetcher prefetcher{std::clamp(GetNumCores() - 1, 1, MAX_SYNC_THREADS), SYNC_PREFETCH_BLOCKS, [this](SyncBlock& item) {
+            if (!m_chainstate->m_blockman.ReadBlockFromDisk(item.block, *item.pindex)) return;
+            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(item.pindex, &item.block);
+            if (NeedsUndoData()) {
+                if (!ReadBlockUndo(m_chainstate->m_blockman, *item.pindex, item.undo)) return;
+                block_info.undo_data = &item.undo;
+            }
+            item.prepared = CustomPrepare(block_info);
+            item.ok = true;
+        }};
+
+        // Entries are collected in batch and handed over to the writer along
+        // with the locator of the last block appended, which becomes the best
+        // block once written.
+        const size_t batch_size{size_t(std::max<int64_t>(gArgs.GetIntArg("-indexbatchsize", DEFAULT_INDEX_BATCH_SIZE), 0))};
+        SyncWriter writer{GetDB()};
+        auto batch{std::make_unique<CDBBatch>(GetDB())};
+        const auto flush{[&](bool wait) {
+            if (pindex) {
+                // No need to handle errors in PrepareCommit. If it fails, the error will be already
+                // be logged. The best way to recover is to continue, as index cannot be corrupted
+                // by a missed commit to disk for an advanced index state.
+                PrepareCommit(*batch, *pindex);
+            }
+            bool ok{writer.Write(std::move(batch), [this, pindex] { SetBestBlockIndex(pindex); })};
+            batch = std::make_unique<CDBBatch>(GetDB());
+            if (ok && wait) ok = writer.Wait();
+            if (!ok) {
+                FatalErrorf("%s: Failed to write index %s to disk", __func__, GetName());
+            }
+            return ok;
+        }};
+
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
         while (true) {
             if (m_interrupt) {
                 LogPrintf("%s: m_interrupt set; exiting ThreadSync\n", GetName());
 
-                SetBestBlockIndex(pindex);
-                // No need to handle errors in Commit. If it fails, the error will be already be
-                // logged. The best way to recover is to continue, as index cannot be corrupted by
-                // a missed commit to disk for an advanced index state.
-                Commit();
+                flush(/*wait=*/true);
                 return;
             }
 
@@ -162,9 +426,7 @@ void BaseIndex::Sync()
             // If pindex_next is null, it means pindex is the chain tip, so
             // commit data indexed so far.
             if (!pindex_next) {
-                SetBestBlockIndex(pindex);
-                // No need to handle errors in Commit. See rationale above.
-                Commit();
+                if (!flush(/*wait=*/true)) return;
 
                 // If pindex is still the chain tip after committing, exit the
                 // sync loop. It is important for cs_main to be locked while
@@ -178,23 +440,26 @@ void BaseIndex::Sync()
                     break;
                 }
             }
-            if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
-                FatalErrorf("%s: Failed to rewind index %s to a previous chain tip", __func__, GetName());
-                return;
+            if (pindex_next->pprev != pindex) {
+                // CustomRewind reads the entries of the blocks being disconnected.
+                if (!flush(/*wait=*/true)) return;
+                if (!Rewind(pindex, pindex_next->pprev)) {
+                    FatalErrorf("%s: Failed to rewind index %s to a previous chain tip", __func__, GetName());
+                    return;
+                }
             }
             pindex = pindex_next;
 
-
-            CBlock block;
-            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *pindex)) {
+            WITH_LOCK(cs_main, prefetcher.Fill(pindex, m_chainstate->m_chain));
+            const std::shared_ptr<SyncBlock> item{prefetcher.Pop()};
+            if (!item->ok) {
                 FatalErrorf("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
-            } else {
-                block_info.data = &block;
             }
-            if (!CustomAppend(block_info)) {
+            interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, &item->block);
+            if (NeedsUndoData()) block_info.undo_data = &item->undo;
+            if (!CustomAppend(block_info, item->prepared.get(), *batch)) {
                 FatalErrorf("%s: Failed to write block %s to index database",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
@@ -207,11 +472,9 @@ void BaseIndex::Sync()
                 last_log_time = current_time;
             }
 
-            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
-                SetBestBlockIndex(pindex);
+            if (batch->SizeEstimate() >= batch_size || last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
                 last_locator_write_time = current_time;
-                // No need to handle errors in Commit. See rationale above.
-                Commit();
+                if (!flush(/*wait=*/false)) return;
             }
         }
     }
@@ -227,22 +490,30 @@ bool BaseIndex::Commit()
 {
     // Don't commit anything if we haven't indexed any block yet
     // (this could happen if init is interrupted).
-    bool ok = m_best_block_index != nullptr;
-    if (ok) {
-        CDBBatch batch(GetDB());
-        ok = CustomCommit(batch);
-        if (ok) {
-            GetDB().WriteBestBlock(batch, GetLocator(*m_chain, m_best_block_index.load()->GetBlockHash()));
-            ok = GetDB().WriteBatch(batch);
-        }
+    const CBlockIndex* best_block_index{m_best_block_index.load()};
+    if (!best_block_index) {
+        LogError("%s: Failed to commit latest %s state\n", __func__, GetName());
+        return false;
     }
-    if (!ok) {
+    CDBBatch batch(GetDB());
+    if (!PrepareCommit(batch, *best_block_index)) return false;
+    if (!GetDB().WriteBatch(batch)) {
         LogError("%s: Failed to commit latest %s state\n", __func__, GetName());
         return false;
     }
     return true;
 }
 
+bool BaseIndex::PrepareCommit(CDBBatch& batch, const CBlockIndex& block)
+{
+    if (!CustomCommit(batch)) {
+        LogError("%s: Failed to commit latest %s state\n", __func__, GetName());
+        return false;
+    }
+    GetDB().WriteBestBlock(batch, GetLocator(*m_chain, block.GetBlockHash()));
+    return true;
+}
+
 bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
 {
     assert(current_tip == m_best_block_index);
@@ -311,7 +582,17 @@ void BaseIndex::BlockConnected(ChainstateRole role, const std::shared_ptr<const
         }
     }
     interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block.get());
-    if (CustomAppend(block_info)) {
+    CBlockUndo block_undo;
+    if (NeedsUndoData()) {
+        if (!ReadBlockUndo(m_chainstate->m_blockman, *pindex, block_undo)) {
+            FatalErrorf("%s: Failed to read undo data of block %s from disk",
+                       __func__, pindex->GetBlockHash().ToString());
+            return;
+        }
+        block_info.undo_data = &block_undo;
+    }
+    CDBBatch batch(GetDB());
+    if (CustomAppend(block_info, CustomPrepare(block_info).get(), batch) && GetDB().WriteBatch(batch)) {
         // Setting the best block index is intentionally the last step of this
         // function, so BlockUntilSyncedToCurrentChain callers waiting for the
         // best block index to be updated can rely on the block being fully
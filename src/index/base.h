@@ -10,6 +10,7 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <memory>
 #include <string>
 
 class CBlock;
@@ -20,6 +21,10 @@ namespace interfaces {
 class Chain;
 } // namespace interfaces
 
+//! Default for -indexbatchsize, the memory used to collect the writes of an
+//! index during its initial sync before they are flushed to disk.
+static constexpr int64_t DEFAULT_INDEX_BATCH_SIZE{32 << 20};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -27,6 +32,12 @@ struct IndexSummary {
     uint256 best_block_hash;
 };
 
+/** Per-block data computed by BaseIndex::CustomPrepare and handed on to
+ * BaseIndex::CustomAppend. Indexes derive their own type from it. */
+struct IndexBlockData {
+    virtual ~IndexBlockData() = default;
+};
+
 /**
  * Base class for indices of blockchain data. This implements
  * CValidationInterface and ensures blocks are indexed sequentially according
@@ -36,6 +47,17 @@ struct IndexSummary {
  * only the background "IBD" chainstate will be indexed to avoid building the
  * index out of order. When the background chainstate completes validation, the
  * index will be reinitialized and indexing will continue.
+ *
+ * During the initial sync, blocks (and undo data, if the index needs it) are
+ * read and passed to CustomPrepare on a pool of worker threads, ahead of the
+ * block being indexed. CustomAppend is then called for each block in height
+ * order on the sync thread, which is where indexes with order-dependent state
+ * fold in the prepared data.
+ *
+ * The entries written by CustomAppend during the initial sync are collected in
+ * a single batch over many blocks, up to -indexbatchsize bytes. The batch is
+ * then written together with the block locator in one atomic write on a
+ * background thread, while the sync thread carries on with the next blocks.
  */
 class BaseIndex : public CValidationInterface
 {
@@ -88,6 +110,11 @@ private:
     /// getting corrupted.
     bool Commit();
 
+    /// Add the index state as of block (the block locator and subclass-specific
+    /// items) to batch, for it to be written atomically with the entries
+    /// already in it.
+    bool PrepareCommit(CDBBatch& batch, const CBlockIndex& block);
+
     /// Loop over disconnected blocks and call CustomRewind.
     bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip);
 
@@ -108,8 +135,22 @@ protected:
     /// Initialize internal state from the database and block index.
     [[nodiscard]] virtual bool CustomInit(const std::optional<interfaces::BlockKey>& block) { return true; }
 
-    /// Write update index entries for a newly connected block.
-    [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
+    /// Whether the index needs the undo data of each block. If so, it is read
+    /// before CustomPrepare and set in block.undo_data (empty for the genesis
+    /// block).
+    virtual bool NeedsUndoData() const { return false; }
+
+    /// Compute the parts of the index entries for a block that do not depend
+    /// on the index state, like a block filter or transaction positions. During
+    /// the initial sync this is called from worker threads, out of order and
+    /// concurrently with CustomAppend, so it must not access mutable index state.
+    [[nodiscard]] virtual std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const { return nullptr; }
+
+    /// Add the index entries for a newly connected block to batch. Called in
+    /// height order with the result of CustomPrepare for the same block. During
+    /// the initial sync the batch holds the entries of many blocks, so entries
+    /// added for earlier blocks may not be readable from the database yet.
+    [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) { return true; }
 
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
@@ -11,6 +11,7 @@
 #include <index/blockfilterindex.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <streams.h>
 #include <undo.h>
 #include <util/fs_helpers.h>
 #include <validation.h>
@@ -37,12 +38,9 @@ constexpr uint8_t DB_FILTER_POS{'P'};
 constexpr unsigned int MAX_FLTR_FILE_SIZE = 0x1000000; // 16 MiB
 /** The pre-allocation chunk size for fltr?????.dat files */
 constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000; // 1 MiB
-/** Maximum size of the cfheaders cache
- *  We have a limit to prevent a bug in filling this cache
- *  potentially turning into an OOM. At 2000 entries, this cache
- *  is big enough for a 2,000,000 length block chain, which
- *  we should be enough until ~2047. */
-constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
+/** Maximum number of filter files kept mapped. Older mappings are dropped
+ *  once they are no longer in use. */
+constexpr size_t MAX_MAPPED_FILTER_FILES{64};
 
 namespace {
 
@@ -93,6 +91,12 @@ struct DBHashKey {
     }
 };
 
+struct PreparedFilter final : IndexBlockData {
+    BlockFilter filter;
+
+    explicit PreparedFilter(BlockFilter&& filter_in) : filter(std::move(filter_in)) {}
+};
+
 }; // namespace
 
 static std::map<BlockFilterType, BlockFilterIndex> g_filter_indexes;
@@ -138,6 +142,26 @@ bool BlockFilterIndex::CustomInit(const std::optional<interfaces::BlockKey>& blo
         m_last_header = *op_last_header;
     }
 
+    // Load the headers of the chain the index is synced to.
+    LOCK(m_cs_headers_cache);
+    m_headers_cache.clear();
+    if (block) {
+        m_headers_cache.reserve(block->height + 1);
+        std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+        DBHeightKey key(0);
+        db_it->Seek(key);
+        for (int height = 0; height <= block->height; ++height) {
+            std::pair<uint256, DBVal> value;
+            if (!db_it->Valid() || !db_it->GetKey(key) || key.height != height || !db_it->GetValue(value)) {
+                LogError("%s: Cannot read block filter header at height %d; index may be corrupted\n",
+                         __func__, height);
+                return false;
+            }
+            m_headers_cache.emplace_back(value.first, value.second.header);
+            db_it->Next();
+        }
+    }
+
     return true;
 }
 
@@ -160,22 +184,60 @@ bool BlockFilterIndex::CustomCommit(CDBBatch& batch)
     return true;
 }
 
+bool BlockFilterIndex::ReadFilterRecord(const FlatFilePos& pos, const uint256& hash, BlockFilterRecord& record) const
+{
+    // The filter may have been written after the file was mapped, in which
+    // case the file is mapped again.
+    for (const bool remap : {false, true}) {
+        {
+            LOCK(m_cs_mapped_files);
+            auto it{m_mapped_files.find(pos.nFile)};
+            if (it == m_mapped_files.end() || remap) {
+                if (it == m_mapped_files.end() && m_mapped_files.size() >= MAX_MAPPED_FILTER_FILES) {
+                    m_mapped_files.clear();
+                }
+                it = m_mapped_files.insert_or_assign(pos.nFile, std::make_shared<const MappedFile>(m_filter_fileseq->FileName(pos))).first;
+            }
+            record.file = it->second;
+        }
+
+        const Span<const std::byte> file_data{record.file->Data()};
+        if (pos.nPos >= file_data.size()) continue;
+        SpanReader reader{MakeUCharSpan(file_data.subspan(pos.nPos))};
+        uint64_t filter_size;
+        try {
+            reader.ignore(uint256::size());
+            filter_size = ReadCompactSize(reader);
+        } catch (const std::ios_base::failure&) {
+            continue;
+        }
+        if (filter_size > reader.size()) continue;
+        const size_t filter_offset{file_data.size() - pos.nPos - reader.size()};
+        record.data = file_data.subspan(pos.nPos, filter_offset + filter_size);
+
+        // Check that the hash of the encoded_filter matches the one stored in the db.
+        if (Hash(record.data.subspan(filter_offset)) != hash) {
+            LogError("Checksum mismatch in filter decode.\n");
+            return false;
+        }
+        return true;
+    }
+
+    LogError("%s: Failed to read block filter from disk at %s\n", __func__, pos.ToString());
+    return false;
+}
+
 bool BlockFilterIndex::ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const
 {
-    AutoFile filein{m_filter_fileseq->Open(pos, true)};
-    if (filein.IsNull()) {
+    BlockFilterRecord record;
+    if (!ReadFilterRecord(pos, hash, record)) {
         return false;
     }
 
-    // Check that the hash of the encoded_filter matches the one stored in the db.
     uint256 block_hash;
     std::vector<uint8_t> encoded_filter;
     try {
-        filein >> block_hash >> encoded_filter;
-        if (Hash(encoded_filter) != hash) {
-            LogError("Checksum mismatch in filter decode.\n");
-            return false;
-        }
+        SpanReader{MakeUCharSpan(record.data)} >> block_hash >> encoded_filter;
         filter = BlockFilter(GetFilterType(), block_hash, std::move(encoded_filter), /*skip_decode_check=*/true);
     }
     catch (const std::exception& e) {
@@ -196,6 +258,8 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
 
     // If writing the filter would overflow the file, flush and move to the next one.
     if (pos.nPos + data_size > MAX_FLTR_FILE_SIZE) {
+        // A mapped file cannot be truncated on all platforms.
+        WITH_LOCK(m_cs_mapped_files, m_mapped_files.erase(pos.nFile));
         AutoFile last_file{m_filter_fileseq->Open(pos)};
         if (last_file.IsNull()) {
             LogPrintf("%s: Failed to open filter file %d\n", __func__, pos.nFile);
@@ -248,28 +312,30 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
-bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::unique_ptr<IndexBlockData> BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
-    CBlockUndo block_undo;
-
-    if (block.height > 0) {
-        // pindex variable gives indexing code access to node internals. It
-        // will be removed in upcoming commit
-        const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
-        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
-            return false;
-        }
+    if (!NeedsUndoData()) {
+        return std::make_unique<PreparedFilter>(BlockFilter(m_filter_type, *Assert(block.data), CBlockUndo{}));
     }
+    return std::make_unique<PreparedFilter>(BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data)));
+}
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch)
+{
+    const BlockFilter& filter{Assert(static_cast<const PreparedFilter*>(prepared))->filter};
 
     const uint256& header = filter.ComputeHeader(m_last_header);
-    bool res = Write(filter, block.height, header);
-    if (res) m_last_header = header; // update last header
+    bool res = Write(batch, filter, block.height, header);
+    if (res) {
+        m_last_header = header; // update last header
+        LOCK(m_cs_headers_cache);
+        m_headers_cache.resize(block.height);
+        m_headers_cache.emplace_back(block.hash, header);
+    }
     return res;
 }
 
-bool BlockFilterIndex::Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header)
+bool BlockFilterIndex::Write(CDBBatch& batch, const BlockFilter& filter, uint32_t block_height, const uint256& filter_header)
 {
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
     if (bytes_written == 0) return false;
@@ -280,9 +346,7 @@ bool BlockFilterIndex::Write(const BlockFilter& filter, uint32_t block_height, c
     value.second.header = filter_header;
     value.second.pos = m_next_filter_pos;
 
-    if (!m_db->Write(DBHeightKey(block_height), value)) {
-        return false;
-    }
+    batch.Write(DBHeightKey(block_height), value);
 
     m_next_filter_pos.nPos += bytes_written;
     return true;
@@ -336,6 +400,8 @@ bool BlockFilterIndex::CustomRewind(const interfaces::BlockKey& current_tip, con
 
     // Update cached header
     m_last_header = *Assert(ReadFilterHeader(new_tip.height, new_tip.hash));
+    LOCK(m_cs_headers_cache);
+    m_headers_cache.resize(std::min<size_t>(m_headers_cache.size(), new_tip.height + 1));
     return true;
 }
 
@@ -428,30 +494,23 @@ bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter&
 
 bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out)
 {
-    LOCK(m_cs_headers_cache);
-
-    bool is_checkpoint{block_index->nHeight % CFCHECKPT_INTERVAL == 0};
-
-    if (is_checkpoint) {
-        // Try to find the block in the headers cache if this is a checkpoint height.
-        auto header = m_headers_cache.find(block_index->GetBlockHash());
-        if (header != m_headers_cache.end()) {
-            header_out = header->second;
-            return true;
+    {
+        LOCK(m_cs_headers_cache);
+        if (static_cast<size_t>(block_index->nHeight) < m_headers_cache.size()) {
+            const auto& [block_hash, header]{m_headers_cache[block_index->nHeight]};
+            if (block_hash == block_index->GetBlockHash()) {
+                header_out = header;
+                return true;
+            }
         }
     }
 
+    // Blocks not on the chain the index is synced to are looked up on disk.
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
     }
 
-    if (is_checkpoint &&
-        m_headers_cache.size() < CF_HEADERS_CACHE_MAX_SZ) {
-        // Add to the headers cache if this is a checkpoint height.
-        m_headers_cache.emplace(block_index->GetBlockHash(), entry.header);
-    }
-
     header_out = entry.header;
     return true;
 }
@@ -476,6 +535,24 @@ bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* st
     return true;
 }
 
+bool BlockFilterIndex::LookupFilterRecordRange(int start_height, const CBlockIndex* stop_index,
+                                               std::vector<BlockFilterRecord>& records_out) const
+{
+    std::vector<DBVal> entries;
+    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
+        return false;
+    }
+
+    records_out.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!ReadFilterRecord(entries[i].pos, entries[i].hash, records_out[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
                                              std::vector<uint256>& hashes_out) const
 
@@ -10,15 +10,33 @@
 #include <chain.h>
 #include <flatfile.h>
 #include <index/base.h>
-#include <util/hasher.h>
+#include <span.h>
+#include <sync.h>
 
-#include <unordered_map>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class MappedFile;
 
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
+/**
+ * A block filter as stored in the filter files: the block hash followed by the
+ * encoded filter. This is also the payload of a cfilter message after the
+ * filter type, so it can be sent without decoding it. The data points into a
+ * memory mapping of the filter file, which is kept alive by the record.
+ */
+struct BlockFilterRecord {
+    std::shared_ptr<const MappedFile> file;
+    Span<const std::byte> data;
+};
+
 /**
  * BlockFilterIndex is used to store and retrieve block filters, hashes, and headers for a range of
  * blocks by height. An index is constructed for each supported filter type with its own database
@@ -35,19 +53,28 @@ private:
     FlatFilePos m_next_filter_pos;
     std::unique_ptr<FlatFileSeq> m_filter_fileseq;
 
-    bool ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const;
-    size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter);
+    /** Memory mappings of the filter files read from, by file number. */
+    mutable Mutex m_cs_mapped_files;
+    mutable std::map<int, std::shared_ptr<const MappedFile>> m_mapped_files GUARDED_BY(m_cs_mapped_files);
+
+    bool ReadFilterRecord(const FlatFilePos& pos, const uint256& hash, BlockFilterRecord& record) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
+    bool ReadFilterFromDisk(const FlatFilePos& pos, const uint256& hash, BlockFilter& filter) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
+    size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
 
     Mutex m_cs_headers_cache;
-    /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
-    std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
+    /** Block hash and filter header of each block of the chain the index is
+     *  synced to, by height, to avoid disk access when responding to
+     *  getcfheaders and getcfcheckpt. */
+    std::vector<std::pair<uint256, uint256>> m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
     // Last computed header to avoid disk reads on every new block.
     uint256 m_last_header{};
 
     bool AllowPrune() const override { return true; }
 
-    bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
+    bool Write(CDBBatch& batch, const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
 
@@ -56,7 +83,12 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    /** Only the basic filter commits to the scripts of spent outputs. */
+    bool NeedsUndoData() const override { return m_filter_type == BlockFilterType::BASIC; }
+
+    std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) override;
 
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
@@ -70,14 +102,18 @@ public:
     BlockFilterType GetFilterType() const { return m_filter_type; }
 
     /** Get a single filter by block. */
-    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const;
+    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
 
     /** Get a single filter header by block. */
     bool LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a range of filters between two heights on a chain. */
     bool LookupFilterRange(int start_height, const CBlockIndex* stop_index,
-                           std::vector<BlockFilter>& filters_out) const;
+                           std::vector<BlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
+
+    /** Get a range of filters between two heights on a chain, as stored on disk. */
+    bool LookupFilterRecordRange(int start_height, const CBlockIndex* stop_index,
+                                 std::vector<BlockFilterRecord>& records_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_mapped_files);
 
     /** Get a range of filter hashes between two heights on a chain. */
     bool LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
@@ -99,6 +99,23 @@ struct DBHashKey {
     }
 };
 
+/** Changes to the UTXO set stats made by a single block. The MuHash of the
+ * block's created and spent coins is combined with the running one in
+ * CustomAppend, so it can be computed out of order. */
+struct BlockStats final : IndexBlockData {
+    MuHash3072 muhash;
+    int64_t transaction_output_count{0};
+    int64_t bogo_size{0};
+    CAmount total_amount{0};
+    CAmount total_unspendable_amount{0};
+    CAmount total_prevout_spent_amount{0};
+    CAmount total_new_outputs_ex_coinbase_amount{0};
+    CAmount total_coinbase_amount{0};
+    CAmount total_unspendables_genesis_block{0};
+    CAmount total_unspendables_bip30{0};
+    CAmount total_unspendables_scripts{0};
+};
+
 }; // namespace
 
 std::unique_ptr<CoinStatsIndex> g_coin_stats_index;
@@ -112,37 +129,17 @@ CoinStatsIndex::CoinStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t
     m_db = std::make_unique<CoinStatsIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
 }
 
-bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::unique_ptr<IndexBlockData> CoinStatsIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
-    CBlockUndo block_undo;
+    auto stats{std::make_unique<BlockStats>()};
     const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
-    m_total_subsidy += block_subsidy;
 
     // Ignore genesis block
     if (block.height > 0) {
         // pindex variable gives indexing code access to node internals. It
         // will be removed in upcoming commit
         const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
-        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
-            return false;
-        }
-
-        std::pair<uint256, DBVal> read_out;
-        if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
-            return false;
-        }
-
-        uint256 expected_block_hash{*Assert(block.prev_hash)};
-        if (read_out.first != expected_block_hash) {
-            LogPrintf("WARNING: previous block header belongs to unexpected block %s; expected %s\n",
-                      read_out.first.ToString(), expected_block_hash.ToString());
-
-            if (!m_db->Read(DBHashKey(expected_block_hash), read_out)) {
-                LogError("%s: previous block header not found; expected %s\n",
-                             __func__, expected_block_hash.ToString());
-                return false;
-            }
-        }
+        const CBlockUndo& block_undo{*Assert(block.undo_data)};
 
         // Add the new utxos created from the block
         assert(block.data);
@@ -151,8 +148,8 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
             // Skip duplicate txid coinbase transactions (BIP30).
             if (IsBIP30Unspendable(*pindex) && tx->IsCoinBase()) {
-                m_total_unspendable_amount += block_subsidy;
-                m_total_unspendables_bip30 += block_subsidy;
+                stats->total_unspendable_amount += block_subsidy;
+                stats->total_unspendables_bip30 += block_subsidy;
                 continue;
             }
 
@@ -163,22 +160,22 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
                 // Skip unspendable coins
                 if (coin.out.scriptPubKey.IsUnspendable()) {
-                    m_total_unspendable_amount += coin.out.nValue;
-                    m_total_unspendables_scripts += coin.out.nValue;
+                    stats->total_unspendable_amount += coin.out.nValue;
+                    stats->total_unspendables_scripts += coin.out.nValue;
                     continue;
                 }
 
-                ApplyCoinHash(m_muhash, outpoint, coin);
+                ApplyCoinHash(stats->muhash, outpoint, coin);
 
                 if (tx->IsCoinBase()) {
-                    m_total_coinbase_amount += coin.out.nValue;
+                    stats->total_coinbase_amount += coin.out.nValue;
                 } else {
-                    m_total_new_outputs_ex_coinbase_amount += coin.out.nValue;
+                    stats->total_new_outputs_ex_coinbase_amount += coin.out.nValue;
                 }
 
-                ++m_transaction_output_count;
-                m_total_amount += coin.out.nValue;
-                m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
+                ++stats->transaction_output_count;
+                stats->total_amount += coin.out.nValue;
+                stats->bogo_size += GetBogoSize(coin.out.scriptPubKey);
             }
 
             // The coinbase tx has no undo data since no former output is spent
@@ -189,21 +186,65 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                     Coin coin{tx_undo.vprevout[j]};
                     COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
 
-                    RemoveCoinHash(m_muhash, outpoint, coin);
+                    RemoveCoinHash(stats->muhash, outpoint, coin);
 
-                    m_total_prevout_spent_amount += coin.out.nValue;
+                    stats->total_prevout_spent_amount += coin.out.nValue;
 
-                    --m_transaction_output_count;
-                    m_total_amount -= coin.out.nValue;
-                    m_bogo_size -= GetBogoSize(coin.out.scriptPubKey);
+                    --stats->transaction_output_count;
+                    stats->total_amount -= coin.out.nValue;
+                    stats->bogo_size -= GetBogoSize(coin.out.scriptPubKey);
                 }
             }
         }
     } else {
         // genesis block
-        m_total_unspendable_amount += block_subsidy;
-        m_total_unspendables_genesis_block += block_subsidy;
+        stats->total_unspendable_amount += block_subsidy;
+        stats->total_unspendables_genesis_block += block_subsidy;
     }
+    return stats;
+}
+
+bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch)
+{
+    const BlockStats& stats{*Assert(static_cast<const BlockStats*>(prepared))};
+    const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
+    m_total_subsidy += block_subsidy;
+
+    // The entry of the previous block only needs to be looked up if it was
+    // not the last one appended.
+    if (block.height > 0 && *Assert(block.prev_hash) != m_current_block_hash) {
+        std::pair<uint256, DBVal> read_out;
+        if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
+            return false;
+        }
+
+        uint256 expected_block_hash{*Assert(block.prev_hash)};
+        if (read_out.first != expected_block_hash) {
+            LogPrintf("WARNING: previous block header belongs to unexpected block %s; expected %s\n",
+                      read_out.first.ToString(), expected_block_hash.ToString());
+
+            if (!m_db->Read(DBHashKey(expected_block_hash), read_out)) {
+                LogError("%s: previous block header not found; expected %s\n",
+                             __func__, expected_block_hash.ToString());
+                return false;
+            }
+        }
+    }
+
+    // Fold the block into the running stats. This has to happen in block
+    // order, as the totals written for each height depend on all blocks
+    // before it.
+    m_muhash *= stats.muhash;
+    m_transaction_output_count += stats.transaction_output_count;
+    m_bogo_size += stats.bogo_size;
+    m_total_amount += stats.total_amount;
+    m_total_unspendable_amount += stats.total_unspendable_amount;
+    m_total_prevout_spent_amount += stats.total_prevout_spent_amount;
+    m_total_new_outputs_ex_coinbase_amount += stats.total_new_outputs_ex_coinbase_amount;
+    m_total_coinbase_amount += stats.total_coinbase_amount;
+    m_total_unspendables_genesis_block += stats.total_unspendables_genesis_block;
+    m_total_unspendables_bip30 += stats.total_unspendables_bip30;
+    m_total_unspendables_scripts += stats.total_unspendables_scripts;
 
     // If spent prevouts + block subsidy are still a higher amount than
     // new outputs + coinbase + current unspendable amount this means
@@ -234,7 +275,9 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
 
     // Intentionally do not update DB_MUHASH here so it stays in sync with
     // DB_BEST_BLOCK, and the index is not corrupted if there is an unclean shutdown.
-    return m_db->Write(DBHeightKey(block.height), value);
+    batch.Write(DBHeightKey(block.height), value);
+    m_current_block_hash = block.hash;
+    return true;
 }
 
 [[nodiscard]] static bool CopyHeightIndexToHashIndex(CDBIterator& db_it, CDBBatch& batch,
@@ -301,6 +344,7 @@ bool CoinStatsIndex::CustomRewind(const interfaces::BlockKey& current_tip, const
         } while (new_tip_index != iter_tip);
     }
 
+    m_current_block_hash = new_tip.hash;
     return true;
 }
 
@@ -391,6 +435,7 @@ bool CoinStatsIndex::CustomInit(const std::optional<interfaces::BlockKey>& block
         m_total_unspendables_bip30 = entry.total_unspendables_bip30;
         m_total_unspendables_scripts = entry.total_unspendables_scripts;
         m_total_unspendables_unclaimed_rewards = entry.total_unspendables_unclaimed_rewards;
+        m_current_block_hash = block->hash;
     }
 
     return true;
@@ -38,6 +38,10 @@ private:
     CAmount m_total_unspendables_scripts{0};
     CAmount m_total_unspendables_unclaimed_rewards{0};
 
+    //! The last block folded into the running stats. Its entry may not have
+    //! been written to the database yet during the initial sync.
+    uint256 m_current_block_hash;
+
     [[nodiscard]] bool ReverseBlock(const CBlock& block, const CBlockIndex* pindex);
 
     bool AllowPrune() const override { return true; }
@@ -47,7 +51,11 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    bool NeedsUndoData() const override { return true; }
+
+    std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) override;
 
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
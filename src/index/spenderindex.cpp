@@ -0,0 +1,120 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/spenderindex.h>
+
+#include <common/args.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <validation.h>
+
+#include <vector>
+
+static constexpr uint8_t DB_SPENDER{'s'};
+
+std::unique_ptr<SpenderIndex> g_spender_index;
+
+namespace {
+
+struct DBOutPointKey {
+    COutPoint prevout;
+
+    explicit DBOutPointKey(const COutPoint& prevout_in) : prevout(prevout_in) {}
+
+    SERIALIZE_METHODS(DBOutPointKey, obj)
+    {
+        uint8_t prefix{DB_SPENDER};
+        READWRITE(prefix);
+        if (prefix != DB_SPENDER) {
+            throw std::ios_base::failure("Invalid format for spenderindex DB outpoint key");
+        }
+        READWRITE(obj.prevout.hash, VARINT(obj.prevout.n));
+    }
+};
+
+struct DBSpender {
+    OutPointSpender spender;
+
+    SERIALIZE_METHODS(DBSpender, obj)
+    {
+        READWRITE(obj.spender.txid, VARINT(obj.spender.vin), VARINT_MODE(obj.spender.height, VarIntMode::NONNEGATIVE_SIGNED));
+    }
+};
+
+/** The outpoints spent by a block, in block order. */
+struct BlockSpends final : IndexBlockData {
+    std::vector<std::pair<COutPoint, DBSpender>> spends;
+};
+
+} // namespace
+
+SpenderIndex::SpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "spenderindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "spenderindex"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+std::unique_ptr<IndexBlockData> SpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    auto spends{std::make_unique<BlockSpends>()};
+    for (const CTransactionRef& tx : Assert(block.data)->vtx) {
+        if (tx->IsCoinBase()) continue;
+        for (uint32_t i = 0; i < tx->vin.size(); ++i) {
+            spends->spends.emplace_back(tx->vin[i].prevout, DBSpender{{tx->GetHash(), i, block.height}});
+        }
+    }
+    return spends;
+}
+
+bool SpenderIndex::CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch)
+{
+    for (const auto& [prevout, spender] : Assert(static_cast<const BlockSpends*>(prepared))->spends) {
+        batch.Write(DBOutPointKey(prevout), spender);
+    }
+    return true;
+}
+
+bool SpenderIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    CDBBatch batch(*m_db);
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+        const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+        do {
+            CBlock block;
+            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+                LogError("%s: Failed to read block %s from disk\n",
+                         __func__, iter_tip->GetBlockHash().ToString());
+                return false;
+            }
+
+            // The outputs spent by the disconnected block are unspent again.
+            for (const CTransactionRef& tx : block.vtx) {
+                if (tx->IsCoinBase()) continue;
+                for (const CTxIn& txin : tx->vin) {
+                    batch.Erase(DBOutPointKey(txin.prevout));
+                }
+            }
+
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip_index != iter_tip);
+    }
+    return m_db->WriteBatch(batch);
+}
+
+std::optional<OutPointSpender> SpenderIndex::FindSpender(const COutPoint& prevout) const
+{
+    DBSpender value;
+    if (!m_db->Read(DBOutPointKey(prevout), value)) return std::nullopt;
+    return value.spender;
+}
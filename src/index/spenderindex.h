@@ -0,0 +1,60 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BGL_INDEX_SPENDERINDEX_H
+#define BGL_INDEX_SPENDERINDEX_H
+
+#include <index/base.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <optional>
+
+class COutPoint;
+
+static constexpr bool DEFAULT_SPENDERINDEX{false};
+
+/** The confirmed transaction input spending an outpoint. */
+struct OutPointSpender {
+    uint256 txid;
+    //! Index of the spending input
+    uint32_t vin;
+    //! Height of the block containing the spending transaction
+    int height;
+};
+
+/**
+ * SpenderIndex maps every spent outpoint to the transaction input spending
+ * it, used by gettxspendingprevout to find spends that are no longer in the
+ * mempool.
+ */
+class SpenderIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit SpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the confirmed spender of an outpoint, std::nullopt if the
+    /// outpoint is unspent or does not exist.
+    std::optional<OutPointSpender> FindSpender(const COutPoint& prevout) const;
+};
+
+/// The global spender index, used by gettxspendingprevout. May be null.
+extern std::unique_ptr<SpenderIndex> g_spender_index;
+
+#endif // BGL_INDEX_SPENDERINDEX_H
@@ -15,6 +15,12 @@ constexpr uint8_t DB_TXINDEX{'t'};
 
 std::unique_ptr<TxIndex> g_txindex;
 
+namespace {
+/** Disk positions of the transactions of a block. */
+struct TxPositions final : IndexBlockData {
+    std::vector<std::pair<uint256, CDiskTxPos>> v_pos;
+};
+} // namespace
 
 /** Access to the txindex database (indexes/txindex/) */
 class TxIndex::DB : public BaseIndex::DB
@@ -26,8 +32,8 @@ public:
     /// transaction hash is not indexed.
     bool ReadTxPos(const uint256& txid, CDiskTxPos& pos) const;
 
-    /// Write a batch of transaction positions to the DB.
-    [[nodiscard]] bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
+    /// Write transaction positions to a batch for the DB.
+    void WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
 };
 
 TxIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
@@ -39,13 +45,11 @@ bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
 
-bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
+void TxIndex::DB::WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
 {
-    CDBBatch batch(*this);
     for (const auto& tuple : v_pos) {
         batch.Write(std::make_pair(DB_TXINDEX, tuple.first), tuple.second);
     }
-    return WriteBatch(batch);
 }
 
 TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
@@ -54,20 +58,27 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::unique_ptr<IndexBlockData> TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    if (block.height == 0) return nullptr;
 
     assert(block.data);
+    auto positions{std::make_unique<TxPositions>()};
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
-    std::vector<std::pair<uint256, CDiskTxPos>> vPos;
-    vPos.reserve(block.data->vtx.size());
+    positions->v_pos.reserve(block.data->vtx.size());
     for (const auto& tx : block.data->vtx) {
-        vPos.emplace_back(tx->GetHash(), pos);
+        positions->v_pos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    return positions;
+}
+
+bool TxIndex::CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch)
+{
+    // Nothing is prepared for the genesis block.
+    if (prepared) m_db->WriteTxs(batch, static_cast<const TxPositions*>(prepared)->v_pos);
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
@@ -25,7 +25,9 @@ private:
     bool AllowPrune() const override { return false; }
 
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::unique_ptr<IndexBlockData> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block, const IndexBlockData* prepared, CDBBatch& batch) override;
 
     BaseIndex::DB& GetDB() const override;
 
@@ -67,6 +67,9 @@ public:
     //! Read block data from disk. If the block exists but doesn't have data
     //! (for example due to pruning), the CBlock variable will be set to null.
     FoundBlock& data(CBlock& data) { m_data = &data; return *this; }
+    //! Return the position of the block data on disk, for readBlockFromDisk().
+    //! file_number is set to -1 if the block has no data on disk.
+    FoundBlock& diskPos(int& file_number, unsigned& data_pos) { m_file_number = &file_number; m_data_pos = &data_pos; return *this; }
 
     uint256* m_hash = nullptr;
     int* m_height = nullptr;
@@ -77,6 +80,8 @@ public:
     CBlockLocator* m_locator = nullptr;
     const FoundBlock* m_next_block = nullptr;
     CBlock* m_data = nullptr;
+    int* m_file_number = nullptr;
+    unsigned* m_data_pos = nullptr;
     mutable bool found = false;
 };
 
@@ -160,6 +165,12 @@ public:
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
 
+    //! Read block data at a position returned by FoundBlock::diskPos(). Unlike
+    //! findBlock() this does not lock cs_main, so it can be called from
+    //! threads that must not wait on the thread holding it. Returns false if
+    //! the data could not be read, for example because it was pruned since.
+    virtual bool readBlockFromDisk(int file_number, unsigned data_pos, CBlock& block) = 0;
+
     //! Find first block in the chain with timestamp >= the given time
     //! and height >= than the given height, return false if there is no block
     //! with a high enough timestamp and height. Optionally return block
@@ -216,8 +216,11 @@ struct TransactionInfo {
 
 struct RemovedMempoolTransactionInfo {
     TransactionInfo info;
-    explicit RemovedMempoolTransactionInfo(const CTxMemPoolEntry& entry)
-        : info{entry.GetSharedTx(), entry.GetFee(), entry.GetTxSize(), entry.GetHeight()} {}
+    /* The mempool sequence number of the removal */
+    const uint64_t mempool_sequence;
+    explicit RemovedMempoolTransactionInfo(const CTxMemPoolEntry& entry, uint64_t mempool_sequence = 0)
+        : info{entry.GetSharedTx(), entry.GetFee(), entry.GetTxSize(), entry.GetHeight()},
+          mempool_sequence{mempool_sequence} {}
 };
 
 struct NewMempoolTransactionInfo {
@@ -93,6 +93,12 @@ static constexpr int32_t MAX_PEER_TX_REQUEST_IN_FLIGHT = 100;
  *  rate (by our own policy, see INVENTORY_BROADCAST_PER_SECOND) for several minutes, while not receiving
  *  the actual transaction (from any peer) in response to requests for them. */
 static constexpr int32_t MAX_PEER_TX_ANNOUNCEMENTS = 5000;
+/** Maximum total weight of orphans reconsidered for a peer in a single ProcessMessages call. Bounds the
+ *  time spent in the message handler when a parent resolves many orphans, while letting chains of small
+ *  orphans resolve in one pass instead of one per call. */
+static constexpr int64_t MAX_ORPHAN_RESOLUTION_WEIGHT{MAX_STANDARD_TX_WEIGHT};
+/** Maximum number of orphans reconsidered for a peer in a single ProcessMessages call. */
+static constexpr size_t MAX_ORPHAN_RESOLUTION_BATCH{16};
 /** How long to delay requesting transactions via txids, if we have wtxid-relaying peers */
 static constexpr auto TXID_RELAY_DELAY{2s};
 /** How long to delay requesting transactions from non-preferred peers */
@@ -640,12 +646,13 @@ private:
     /**
      * Reconsider orphan transactions after a parent has been accepted to the mempool.
      *
-     * @peer[in]  peer     The peer whose orphan transactions we will reconsider. Generally only
-     *                     one orphan will be reconsidered on each call of this function. If an
+     * @peer[in]  peer     The peer whose orphan transactions we will reconsider. Orphans are
+     *                     reconsidered until the work set is empty or MAX_ORPHAN_RESOLUTION_BATCH
+     *                     orphans or MAX_ORPHAN_RESOLUTION_WEIGHT have been processed. If an
      *                     accepted orphan has orphaned children, those will need to be
      *                     reconsidered, creating more work, possibly for other peers.
-     * @return             True if meaningful work was done (an orphan was accepted/rejected).
-     *                     If no meaningful work was done, then the work set for this peer
+     * @return             True if meaningful work was done (an orphan was accepted/rejected) or
+     *                     the batch limit was reached. Otherwise the work set for this peer
      *                     will be empty.
      */
     bool ProcessOrphanTx(Peer& peer)
@@ -3405,9 +3412,16 @@ bool PeerManagerImpl::ProcessOrphanTx(Peer& peer)
     AssertLockHeld(g_msgproc_mutex);
     LOCK(cs_main);
 
-    CTransactionRef porphanTx = nullptr;
+    bool did_work{false};
+    size_t processed{0};
+    int64_t processed_weight{0};
+
+    while (processed < MAX_ORPHAN_RESOLUTION_BATCH && processed_weight < MAX_ORPHAN_RESOLUTION_WEIGHT) {
+        CTransactionRef porphanTx = m_orphanage.GetTxToReconsider(peer.m_id);
+        if (!porphanTx) break;
+        ++processed;
+        processed_weight += GetTransactionWeight(*porphanTx);
 
-    while (CTransactionRef porphanTx = m_orphanage.GetTxToReconsider(peer.m_id)) {
         const MempoolAcceptResult result = m_chainman.ProcessTransaction(porphanTx);
         const TxValidationState& state = result.m_state;
         const Txid& orphanHash = porphanTx->GetHash();
@@ -3416,7 +3430,7 @@ bool PeerManagerImpl::ProcessOrphanTx(Peer& peer)
         if (result.m_result_type == MempoolAcceptResult::ResultType::VALID) {
             LogPrint(BCLog::TXPACKAGES, "   accepted orphan tx %s (wtxid=%s)\n", orphanHash.ToString(), orphan_wtxid.ToString());
             ProcessValidTx(peer.m_id, porphanTx, result.m_replaced_transactions);
-            return true;
+            did_work = true;
         } else if (state.GetResult() != TxValidationResult::TX_MISSING_INPUTS) {
             LogPrint(BCLog::TXPACKAGES, "   invalid orphan tx %s (wtxid=%s) from peer=%d. %s\n",
                 orphanHash.ToString(),
@@ -3430,11 +3444,15 @@ bool PeerManagerImpl::ProcessOrphanTx(Peer& peer)
                        state.GetResult() != TxValidationResult::TX_RESULT_UNSET)) {
                 ProcessInvalidTx(peer.m_id, porphanTx, state, /*maybe_add_extra_compact_tx=*/false);
             }
-            return true;
+            did_work = true;
         }
     }
 
-    return false;
+    if (processed > 1) {
+        LogPrint(BCLog::TXPACKAGES, "reconsidered %u orphans (weight %d) for peer=%d\n", processed, processed_weight, peer.m_id);
+    }
+    // If a batch limit was hit, there is more work left for this peer.
+    return did_work || m_orphanage.HaveTxToReconsider(peer.m_id);
 }
 
 bool PeerManagerImpl::PrepareBlockFilterRequest(CNode& node, Peer& peer,
@@ -3445,7 +3463,9 @@ bool PeerManagerImpl::PrepareBlockFilterRequest(CNode& node, Peer& peer,
 {
     const bool supported_filter_type =
         (filter_type == BlockFilterType::BASIC &&
-         (peer.m_our_services & NODE_COMPACT_FILTERS));
+         (peer.m_our_services & NODE_COMPACT_FILTERS)) ||
+        (filter_type == BlockFilterType::OUTPOINT &&
+         (peer.m_our_services & NODE_OUTPOINT_FILTERS));
     if (!supported_filter_type) {
         LogPrint(BCLog::NET, "peer %d requested unsupported block filter type: %d\n",
                  node.GetId(), static_cast<uint8_t>(filter_type));
@@ -3507,15 +3527,16 @@ void PeerManagerImpl::ProcessGetCFilters(CNode& node, Peer& peer, DataStream& vR
         return;
     }
 
-    std::vector<BlockFilter> filters;
-    if (!filter_index->LookupFilterRange(start_height, stop_index, filters)) {
+    std::vector<BlockFilterRecord> filters;
+    if (!filter_index->LookupFilterRecordRange(start_height, stop_index, filters)) {
         LogPrint(BCLog::NET, "Failed to find block filter in index: filter_type=%s, start_height=%d, stop_hash=%s\n",
                      BlockFilterTypeName(filter_type), start_height, stop_hash.ToString());
         return;
     }
 
+    // The filters are sent as stored on disk, without decoding them.
     for (const auto& filter : filters) {
-        MakeAndPushMessage(node, NetMsgType::CFILTER, filter);
+        MakeAndPushMessage(node, NetMsgType::CFILTER, filter_type_ser, filter.data);
     }
 }
 
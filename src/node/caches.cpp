@@ -5,6 +5,8 @@
 #include <node/caches.h>
 
 #include <common/args.h>
+#include <index/addrindex.h>
+#include <index/spenderindex.h>
 #include <index/txindex.h>
 #include <txdb.h>
 
@@ -19,6 +21,10 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     nTotalCache -= sizes.block_tree_db;
     sizes.tx_index = std::min(nTotalCache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= sizes.tx_index;
+    sizes.addr_index = std::min(nTotalCache / 8, args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX) ? nMaxAddrIndexCache << 20 : 0);
+    nTotalCache -= sizes.addr_index;
+    sizes.spender_index = std::min(nTotalCache / 8, args.GetBoolArg("-spenderindex", DEFAULT_SPENDERINDEX) ? nMaxSpenderIndexCache << 20 : 0);
+    nTotalCache -= sizes.spender_index;
     sizes.filter_index = 0;
     if (n_indexes > 0) {
         int64_t max_cache = std::min(nTotalCache / 8, max_filter_index_cache << 20);
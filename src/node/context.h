@@ -40,6 +40,7 @@ class SignalInterrupt;
 
 namespace node {
 class KernelNotifications;
+class MempoolEventLog;
 class Warnings;
 
 //! NodeContext struct containing references to chain state and connection
@@ -65,6 +66,8 @@ struct NodeContext {
     std::unique_ptr<CTxMemPool> mempool;
     std::unique_ptr<const NetGroupManager> netgroupman;
     std::unique_ptr<CBlockPolicyEstimator> fee_estimator;
+    //! Mempool event stream served over REST, only set if -rest is enabled
+    std::unique_ptr<MempoolEventLog> mempool_event_log;
     std::unique_ptr<PeerManager> peerman;
     std::unique_ptr<ChainstateManager> chainman;
     std::unique_ptr<BanMan> banman;
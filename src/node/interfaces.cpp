@@ -427,6 +427,11 @@ bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<Rec
     if (block.m_mtp_time) *block.m_mtp_time = index->GetMedianTimePast();
     if (block.m_in_active_chain) *block.m_in_active_chain = active[index->nHeight] == index;
     if (block.m_locator) { *block.m_locator = GetLocator(index); }
+    if (block.m_file_number) {
+        const FlatFilePos pos{index->nStatus & BLOCK_HAVE_DATA ? index->GetBlockPos() : FlatFilePos{}};
+        *block.m_file_number = pos.nFile;
+        *block.m_data_pos = pos.nPos;
+    }
     if (block.m_next_block) FillBlock(active[index->nHeight] == index ? active[index->nHeight + 1] : nullptr, *block.m_next_block, lock, active, blockman);
     if (block.m_data) {
         REVERSE_LOCK(lock);
@@ -585,6 +590,11 @@ public:
         WAIT_LOCK(cs_main, lock);
         return FillBlock(chainman().m_blockman.LookupBlockIndex(hash), block, lock, chainman().ActiveChain(), chainman().m_blockman);
     }
+    bool readBlockFromDisk(int file_number, unsigned data_pos, CBlock& block) override
+    {
+        if (file_number < 0) return false;
+        return chainman().m_blockman.ReadBlockFromDisk(block, FlatFilePos{file_number, data_pos});
+    }
     bool findFirstBlockWithTimeAndHeight(int64_t min_time, int min_height, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -0,0 +1,90 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/mempool_event_log.h>
+
+#include <core_memusage.h>
+#include <kernel/mempool_entry.h>
+#include <random.h>
+#include <sync.h>
+
+#include <algorithm>
+
+namespace node {
+static size_t EventUsage(const MempoolEvent& event)
+{
+    return sizeof(MempoolEvent) + (event.tx ? RecursiveDynamicUsage(event.tx) : 0);
+}
+
+MempoolEventLog::MempoolEventLog(size_t max_events, size_t max_bytes)
+    : m_max_events{max_events},
+      m_max_bytes{max_bytes},
+      m_epoch{FastRandomContext().randbits(64 - MEMPOOL_EVENT_POSITION_BITS) << MEMPOOL_EVENT_POSITION_BITS},
+      m_next_seq{m_epoch + 1}
+{
+}
+
+void MempoolEventLog::Append(MempoolEvent&& event)
+{
+    AssertLockHeld(m_mutex);
+    event.seq = m_next_seq++;
+    m_bytes += EventUsage(event);
+    m_events.push_back(std::move(event));
+    // Always keep the newest event, even if it alone exceeds the memory limit.
+    while (m_events.size() > 1 && (m_events.size() > m_max_events || m_bytes > m_max_bytes)) {
+        m_bytes -= EventUsage(m_events.front());
+        m_events.pop_front();
+    }
+}
+
+void MempoolEventLog::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    LOCK(m_mutex);
+    Append({.seq = 0, .type = MempoolEvent::Type::ADDED, .mempool_sequence = mempool_sequence,
+            .txid = tx.info.m_tx->GetHash(), .wtxid = tx.info.m_tx->GetWitnessHash(), .tx = tx.info.m_tx, .fee = tx.info.m_fee, .vsize = tx.info.m_virtual_transaction_size});
+}
+
+void MempoolEventLog::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
+{
+    LOCK(m_mutex);
+    // Removed transactions are not kept, so the log does not hold on to them
+    // after they left the mempool.
+    Append({.seq = 0, .type = MempoolEvent::Type::REMOVED, .mempool_sequence = mempool_sequence,
+            .txid = tx->GetHash(), .wtxid = tx->GetWitnessHash(), .reason = reason});
+}
+
+void MempoolEventLog::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
+{
+    LOCK(m_mutex);
+    for (const auto& removed : txs_removed_for_block) {
+        Append({.seq = 0, .type = MempoolEvent::Type::REMOVED, .mempool_sequence = removed.mempool_sequence,
+                .txid = removed.info.m_tx->GetHash(), .wtxid = removed.info.m_tx->GetWitnessHash(),
+                .reason = MemPoolRemovalReason::BLOCK});
+    }
+}
+
+std::optional<MempoolEventLog::Page> MempoolEventLog::Read(uint64_t start, size_t max_count) const
+{
+    LOCK(m_mutex);
+    const uint64_t oldest{m_events.empty() ? m_next_seq : m_events.front().seq};
+    // A start of 0 means "from the oldest retained event". A cursor of another
+    // epoch comes from a previous run of the node.
+    if (start == 0) start = oldest;
+    if ((start >> MEMPOOL_EVENT_POSITION_BITS) != (m_epoch >> MEMPOOL_EVENT_POSITION_BITS)) return std::nullopt;
+    if (start < oldest || start > m_next_seq) return std::nullopt;
+
+    Page page{.next_seq = start, .events = {}};
+    const auto first{m_events.begin() + (start - oldest)};
+    const auto last{first + std::min<uint64_t>(max_count, m_events.end() - first)};
+    page.events.assign(first, last);
+    if (!page.events.empty()) page.next_seq = page.events.back().seq + 1;
+    return page;
+}
+
+uint64_t MempoolEventLog::NextSeq() const
+{
+    LOCK(m_mutex);
+    return m_next_seq;
+}
+} // namespace node
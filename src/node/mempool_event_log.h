@@ -0,0 +1,123 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BGL_NODE_MEMPOOL_EVENT_LOG_H
+#define BGL_NODE_MEMPOOL_EVENT_LOG_H
+
+#include <consensus/amount.h>
+#include <kernel/mempool_removal_reason.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <sync.h>
+#include <validationinterface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace node {
+//! Default number of mempool events retained for -restmempoolevents.
+static constexpr size_t DEFAULT_MEMPOOL_EVENT_LOG_SIZE{50000};
+//! Default memory limit in megabytes for retained mempool events (-restmempooleventsmem).
+static constexpr size_t DEFAULT_MEMPOOL_EVENT_LOG_MEM{100};
+//! Event positions are prefixed with a random epoch in the bits above these,
+//! so cursors from a previous run of the node are not mistaken for current ones.
+static constexpr int MEMPOOL_EVENT_POSITION_BITS{40};
+
+/** A single mempool addition or removal, as served by /rest/mempool/events. */
+struct MempoolEvent {
+    enum class Type : uint8_t {
+        ADDED = 0,
+        REMOVED = 1,
+    };
+
+    //! Position of this event in the log, prefixed by the epoch of the log.
+    //! Strictly increasing, used as the resume cursor.
+    uint64_t seq;
+    Type type;
+    //! Mempool sequence number of the event, matching ZMQ pubsequence and
+    //! getrawmempool(mempool_sequence=true). Removals for a connected block are
+    //! not assigned one by the mempool and report 0.
+    uint64_t mempool_sequence;
+    Txid txid;
+    Wtxid wtxid;
+    //! The transaction, only kept for ADDED events.
+    CTransactionRef tx{};
+    //! Fee and virtual size, only meaningful for ADDED events.
+    CAmount fee{0};
+    int64_t vsize{0};
+    //! Removal reason, only meaningful for REMOVED events.
+    MemPoolRemovalReason reason{MemPoolRemovalReason::EXPIRY};
+
+    /** Additions carry the full transaction with witness, fee and vsize.
+     * Removals only carry the txid, wtxid and reason. */
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << seq << uint8_t(type) << mempool_sequence;
+        if (type == Type::ADDED) {
+            s << TX_WITH_WITNESS(*tx) << fee << vsize;
+        } else {
+            s << txid << wtxid << uint8_t(reason);
+        }
+    }
+};
+
+/**
+ * Bounded log of mempool additions and removals.
+ *
+ * Lets downstream indexers mirror the mempool at O(changes) instead of
+ * diffing getrawmempool on every poll. A client bootstraps from
+ * getrawmempool(mempool_sequence=true), then pages through the log from a
+ * cursor, ignoring additions and removals whose mempool_sequence is not
+ * newer than its snapshot. Once a cursor falls behind the oldest retained
+ * event the client has to bootstrap again.
+ */
+class MempoolEventLog final : public CValidationInterface
+{
+public:
+    /** Create a log retaining at most max_events events, using about
+     * max_bytes of memory at most. */
+    MempoolEventLog(size_t max_events, size_t max_bytes);
+
+    struct Page {
+        //! Cursor to pass as start for the next request.
+        uint64_t next_seq;
+        std::vector<MempoolEvent> events;
+    };
+
+    /** Return up to max_count events starting at seq start, or std::nullopt
+     * if events at or after start have already been dropped from the log or
+     * start is from another epoch. */
+    std::optional<Page> Read(uint64_t start, size_t max_count) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Sequence number that will be given to the next event. */
+    uint64_t NextSeq() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    void Append(MempoolEvent&& event) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const size_t m_max_events;
+    const size_t m_max_bytes;
+    //! Epoch of this run, in the bits above MEMPOOL_EVENT_POSITION_BITS.
+    const uint64_t m_epoch;
+    mutable Mutex m_mutex;
+    std::deque<MempoolEvent> m_events GUARDED_BY(m_mutex);
+    //! Memory used by the retained events.
+    size_t m_bytes GUARDED_BY(m_mutex){0};
+    uint64_t m_next_seq GUARDED_BY(m_mutex);
+};
+} // namespace node
+
+#endif // BGL_NODE_MEMPOOL_EVENT_LOG_H
@@ -123,6 +123,10 @@ public:
     TxConfirmStats(const std::vector<double>& defaultBuckets, const std::map<double, unsigned int>& defaultBucketMap,
                    unsigned int maxPeriods, double decay, unsigned int scale);
 
+    /** Copy all tracked data of other, referring to the given (identical) bucket definitions. */
+    TxConfirmStats(const TxConfirmStats& other, const std::vector<double>& buckets,
+                   const std::map<double, unsigned int>& bucketMap);
+
     /** Roll the circular buffer for unconfirmed txs*/
     void ClearCurrent(unsigned int nBlockHeight);
 
@@ -191,6 +195,15 @@ TxConfirmStats::TxConfirmStats(const std::vector<double>& defaultBuckets,
     resizeInMemoryCounters(buckets.size());
 }
 
+TxConfirmStats::TxConfirmStats(const TxConfirmStats& other, const std::vector<double>& buckets,
+                               const std::map<double, unsigned int>& bucketMap)
+    : buckets(buckets), bucketMap(bucketMap),
+      txCtAvg(other.txCtAvg), confAvg(other.confAvg), failAvg(other.failAvg), m_feerate_avg(other.m_feerate_avg),
+      decay(other.decay), scale(other.scale), unconfTxs(other.unconfTxs), oldUnconfTxs(other.oldUnconfTxs)
+{
+    assert(buckets == other.buckets);
+}
+
 void TxConfirmStats::resizeInMemoryCounters(size_t newbuckets) {
     // newbuckets must be passed in because the buckets referred to during Read have not been updated yet.
     unconfTxs.resize(GetMaxConfirms());
@@ -518,7 +531,10 @@ void TxConfirmStats::removeTx(unsigned int entryHeight, unsigned int nBestSeenHe
 bool CBlockPolicyEstimator::removeTx(uint256 hash)
 {
     LOCK(m_cs_fee_estimator);
-    return _removeTx(hash, /*inBlock=*/false);
+    ApplyPendingEvents();
+    const bool removed{_removeTx(hash, /*inBlock=*/false)};
+    PublishSnapshot();
+    return removed;
 }
 
 bool CBlockPolicyEstimator::_removeTx(const uint256& hash, bool inBlock)
@@ -553,6 +569,7 @@ CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath
     feeStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, MED_BLOCK_PERIODS, MED_DECAY, MED_SCALE));
     shortStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, SHORT_BLOCK_PERIODS, SHORT_DECAY, SHORT_SCALE));
     longStats = std::unique_ptr<TxConfirmStats>(new TxConfirmStats(buckets, bucketMap, LONG_BLOCK_PERIODS, LONG_DECAY, LONG_SCALE));
+    WITH_LOCK(m_cs_fee_estimator, PublishSnapshot());
 
     AutoFile est_file{fsbridge::fopen(m_estimation_filepath, "rb")};
 
@@ -574,6 +591,8 @@ CBlockPolicyEstimator::CBlockPolicyEstimator(const fs::path& estimation_filepath
 
 CBlockPolicyEstimator::~CBlockPolicyEstimator() = default;
 
+CBlockPolicyEstimator::EstimatorSnapshot::~EstimatorSnapshot() = default;
+
 void CBlockPolicyEstimator::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/)
 {
     processTransaction(tx);
@@ -581,7 +600,12 @@ void CBlockPolicyEstimator::TransactionAddedToMempool(const NewMempoolTransactio
 
 void CBlockPolicyEstimator::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/)
 {
-    removeTx(tx->GetHash());
+    MempoolTxEvent event;
+    event.hash = tx->GetHash();
+    event.removed = true;
+
+    LOCK(m_pending_mutex);
+    m_pending_events.push_back(std::move(event));
 }
 
 void CBlockPolicyEstimator::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
@@ -591,9 +615,44 @@ void CBlockPolicyEstimator::MempoolTransactionsRemovedForBlock(const std::vector
 
 void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo& tx)
 {
-    LOCK(m_cs_fee_estimator);
-    const unsigned int txHeight = tx.info.txHeight;
-    const auto& hash = tx.info.m_tx->GetHash();
+    MempoolTxEvent event;
+    event.hash = tx.info.m_tx->GetHash();
+    event.height = tx.info.txHeight;
+    // This transaction should only count for fee estimation if:
+    // - it's not being re-added during a reorg which bypasses typical mempool fee limits
+    // - the node is not behind
+    // - the transaction is not dependent on any other transactions in the mempool
+    // - it's not part of a package.
+    event.valid_for_estimation = !tx.m_mempool_limit_bypassed && !tx.m_submitted_in_package && tx.m_chainstate_is_current && tx.m_has_no_mempool_parents;
+    // Feerates are stored and reported as BTC-per-kb:
+    event.feerate = static_cast<double>(CFeeRate(tx.info.m_fee, tx.info.m_virtual_transaction_size).GetFeePerK());
+
+    LOCK(m_pending_mutex);
+    m_pending_events.push_back(std::move(event));
+}
+
+void CBlockPolicyEstimator::ApplyPendingEvents()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    std::vector<MempoolTxEvent> events;
+    {
+        LOCK(m_pending_mutex);
+        events.swap(m_pending_events);
+    }
+    for (const MempoolTxEvent& event : events) {
+        if (event.removed) {
+            _removeTx(event.hash, /*inBlock=*/false);
+        } else {
+            _processTransaction(event);
+        }
+    }
+}
+
+void CBlockPolicyEstimator::_processTransaction(const MempoolTxEvent& event)
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    const unsigned int txHeight = event.height;
+    const auto& hash = event.hash;
     if (mapMemPoolTxs.count(hash)) {
         LogPrint(BCLog::ESTIMATEFEE, "Blockpolicy error mempool tx %s already being tracked\n",
                  hash.ToString());
@@ -607,30 +666,22 @@ void CBlockPolicyEstimator::processTransaction(const NewMempoolTransactionInfo&
         // It will be synced next time a block is processed.
         return;
     }
-    // This transaction should only count for fee estimation if:
-    // - it's not being re-added during a reorg which bypasses typical mempool fee limits
-    // - the node is not behind
-    // - the transaction is not dependent on any other transactions in the mempool
-    // - it's not part of a package.
-    const bool validForFeeEstimation = !tx.m_mempool_limit_bypassed && !tx.m_submitted_in_package && tx.m_chainstate_is_current && tx.m_has_no_mempool_parents;
 
     // Only want to be updating estimates when our blockchain is synced,
     // otherwise we'll miscalculate how many blocks its taking to get included.
-    if (!validForFeeEstimation) {
+    if (!event.valid_for_estimation) {
         untrackedTxs++;
         return;
     }
     trackedTxs++;
 
-    // Feerates are stored and reported as BTC-per-kb:
-    const CFeeRate feeRate(tx.info.m_fee, tx.info.m_virtual_transaction_size);
-
-    mapMemPoolTxs[hash].blockHeight = txHeight;
-    unsigned int bucketIndex = feeStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
-    mapMemPoolTxs[hash].bucketIndex = bucketIndex;
-    unsigned int bucketIndex2 = shortStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
+    TxStatsInfo& stats_info = mapMemPoolTxs[hash];
+    stats_info.blockHeight = txHeight;
+    unsigned int bucketIndex = feeStats->NewTx(txHeight, event.feerate);
+    stats_info.bucketIndex = bucketIndex;
+    unsigned int bucketIndex2 = shortStats->NewTx(txHeight, event.feerate);
     assert(bucketIndex == bucketIndex2);
-    unsigned int bucketIndex3 = longStats->NewTx(txHeight, static_cast<double>(feeRate.GetFeePerK()));
+    unsigned int bucketIndex3 = longStats->NewTx(txHeight, event.feerate);
     assert(bucketIndex == bucketIndex3);
 }
 
@@ -666,6 +717,8 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
                                          unsigned int nBlockHeight)
 {
     LOCK(m_cs_fee_estimator);
+    // Catch up with the mempool events reported since the previous block
+    ApplyPendingEvents();
     if (nBlockHeight <= nBestSeenHeight) {
         // Ignore side chains and re-orgs; assuming they are random
         // they don't affect the estimate.
@@ -709,6 +762,30 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
 
     trackedTxs = 0;
     untrackedTxs = 0;
+
+    PublishSnapshot();
+}
+
+void CBlockPolicyEstimator::PublishSnapshot()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    auto snapshot{std::make_shared<EstimatorSnapshot>()};
+    snapshot->nBestSeenHeight = nBestSeenHeight;
+    snapshot->max_usable_estimate = MaxUsableEstimate();
+    snapshot->buckets = buckets;
+    snapshot->bucketMap = bucketMap;
+    snapshot->feeStats = std::make_unique<const TxConfirmStats>(*feeStats, snapshot->buckets, snapshot->bucketMap);
+    snapshot->shortStats = std::make_unique<const TxConfirmStats>(*shortStats, snapshot->buckets, snapshot->bucketMap);
+    snapshot->longStats = std::make_unique<const TxConfirmStats>(*longStats, snapshot->buckets, snapshot->bucketMap);
+
+    LOCK(m_snapshot_mutex);
+    m_snapshot = std::move(snapshot);
+}
+
+std::shared_ptr<const CBlockPolicyEstimator::EstimatorSnapshot> CBlockPolicyEstimator::GetSnapshot() const
+{
+    LOCK(m_snapshot_mutex);
+    return m_snapshot;
 }
 
 CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
@@ -722,33 +799,33 @@ CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
 
 CFeeRate CBlockPolicyEstimator::estimateRawFee(int confTarget, double successThreshold, FeeEstimateHorizon horizon, EstimationResult* result) const
 {
-    TxConfirmStats* stats = nullptr;
+    const auto snapshot{GetSnapshot()};
+    const TxConfirmStats* stats = nullptr;
     double sufficientTxs = SUFFICIENT_FEETXS;
     switch (horizon) {
     case FeeEstimateHorizon::SHORT_HALFLIFE: {
-        stats = shortStats.get();
+        stats = snapshot->shortStats.get();
         sufficientTxs = SUFFICIENT_TXS_SHORT;
         break;
     }
     case FeeEstimateHorizon::MED_HALFLIFE: {
-        stats = feeStats.get();
+        stats = snapshot->feeStats.get();
         break;
     }
     case FeeEstimateHorizon::LONG_HALFLIFE: {
-        stats = longStats.get();
+        stats = snapshot->longStats.get();
         break;
     }
     } // no default case, so the compiler can warn about missing cases
     assert(stats);
 
-    LOCK(m_cs_fee_estimator);
     // Return failure if trying to analyze a target we're not tracking
     if (confTarget <= 0 || (unsigned int)confTarget > stats->GetMaxConfirms())
         return CFeeRate(0);
     if (successThreshold > 1)
         return CFeeRate(0);
 
-    double median = stats->EstimateMedianVal(confTarget, sufficientTxs, successThreshold, nBestSeenHeight, result);
+    double median = stats->EstimateMedianVal(confTarget, sufficientTxs, successThreshold, snapshot->nBestSeenHeight, result);
 
     if (median < 0)
         return CFeeRate(0);
@@ -758,16 +835,16 @@ CFeeRate CBlockPolicyEstimator::estimateRawFee(int confTarget, double successThr
 
 unsigned int CBlockPolicyEstimator::HighestTargetTracked(FeeEstimateHorizon horizon) const
 {
-    LOCK(m_cs_fee_estimator);
+    const auto snapshot{GetSnapshot()};
     switch (horizon) {
     case FeeEstimateHorizon::SHORT_HALFLIFE: {
-        return shortStats->GetMaxConfirms();
+        return snapshot->shortStats->GetMaxConfirms();
     }
     case FeeEstimateHorizon::MED_HALFLIFE: {
-        return feeStats->GetMaxConfirms();
+        return snapshot->feeStats->GetMaxConfirms();
     }
     case FeeEstimateHorizon::LONG_HALFLIFE: {
-        return longStats->GetMaxConfirms();
+        return snapshot->longStats->GetMaxConfirms();
     }
     } // no default case, so the compiler can warn about missing cases
     assert(false);
@@ -801,32 +878,36 @@ unsigned int CBlockPolicyEstimator::MaxUsableEstimate() const
  * time horizon which tracks confirmations up to the desired target.  If
  * checkShorterHorizon is requested, also allow short time horizon estimates
  * for a lower target to reduce the given answer */
-double CBlockPolicyEstimator::estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const
+double CBlockPolicyEstimator::estimateCombinedFee(const EstimatorSnapshot& snapshot, unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result)
 {
+    const TxConfirmStats& feeStats{*snapshot.feeStats};
+    const TxConfirmStats& shortStats{*snapshot.shortStats};
+    const TxConfirmStats& longStats{*snapshot.longStats};
+    const unsigned int nBestSeenHeight{snapshot.nBestSeenHeight};
     double estimate = -1;
-    if (confTarget >= 1 && confTarget <= longStats->GetMaxConfirms()) {
+    if (confTarget >= 1 && confTarget <= longStats.GetMaxConfirms()) {
         // Find estimate from shortest time horizon possible
-        if (confTarget <= shortStats->GetMaxConfirms()) { // short horizon
-            estimate = shortStats->EstimateMedianVal(confTarget, SUFFICIENT_TXS_SHORT, successThreshold, nBestSeenHeight, result);
+        if (confTarget <= shortStats.GetMaxConfirms()) { // short horizon
+            estimate = shortStats.EstimateMedianVal(confTarget, SUFFICIENT_TXS_SHORT, successThreshold, nBestSeenHeight, result);
         }
-        else if (confTarget <= feeStats->GetMaxConfirms()) { // medium horizon
-            estimate = feeStats->EstimateMedianVal(confTarget, SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, result);
+        else if (confTarget <= feeStats.GetMaxConfirms()) { // medium horizon
+            estimate = feeStats.EstimateMedianVal(confTarget, SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, result);
         }
         else { // long horizon
-            estimate = longStats->EstimateMedianVal(confTarget, SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, result);
+            estimate = longStats.EstimateMedianVal(confTarget, SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, result);
         }
         if (checkShorterHorizon) {
             EstimationResult tempResult;
             // If a lower confTarget from a more recent horizon returns a lower answer use it.
-            if (confTarget > feeStats->GetMaxConfirms()) {
-                double medMax = feeStats->EstimateMedianVal(feeStats->GetMaxConfirms(), SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, &tempResult);
+            if (confTarget > feeStats.GetMaxConfirms()) {
+                double medMax = feeStats.EstimateMedianVal(feeStats.GetMaxConfirms(), SUFFICIENT_FEETXS, successThreshold, nBestSeenHeight, &tempResult);
                 if (medMax > 0 && (estimate == -1 || medMax < estimate)) {
                     estimate = medMax;
                     if (result) *result = tempResult;
                 }
             }
-            if (confTarget > shortStats->GetMaxConfirms()) {
-                double shortMax = shortStats->EstimateMedianVal(shortStats->GetMaxConfirms(), SUFFICIENT_TXS_SHORT, successThreshold, nBestSeenHeight, &tempResult);
+            if (confTarget > shortStats.GetMaxConfirms()) {
+                double shortMax = shortStats.EstimateMedianVal(shortStats.GetMaxConfirms(), SUFFICIENT_TXS_SHORT, successThreshold, nBestSeenHeight, &tempResult);
                 if (shortMax > 0 && (estimate == -1 || shortMax < estimate)) {
                     estimate = shortMax;
                     if (result) *result = tempResult;
@@ -840,15 +921,19 @@ double CBlockPolicyEstimator::estimateCombinedFee(unsigned int confTarget, doubl
 /** Ensure that for a conservative estimate, the DOUBLE_SUCCESS_PCT is also met
  * at 2 * target for any longer time horizons.
  */
-double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget, EstimationResult *result) const
+double CBlockPolicyEstimator::estimateConservativeFee(const EstimatorSnapshot& snapshot, unsigned int doubleTarget, EstimationResult *result)
 {
+    const TxConfirmStats& feeStats{*snapshot.feeStats};
+    const TxConfirmStats& shortStats{*snapshot.shortStats};
+    const TxConfirmStats& longStats{*snapshot.longStats};
+    const unsigned int nBestSeenHeight{snapshot.nBestSeenHeight};
     double estimate = -1;
     EstimationResult tempResult;
-    if (doubleTarget <= shortStats->GetMaxConfirms()) {
-        estimate = feeStats->EstimateMedianVal(doubleTarget, SUFFICIENT_FEETXS, DOUBLE_SUCCESS_PCT, nBestSeenHeight, result);
+    if (doubleTarget <= shortStats.GetMaxConfirms()) {
+        estimate = feeStats.EstimateMedianVal(doubleTarget, SUFFICIENT_FEETXS, DOUBLE_SUCCESS_PCT, nBestSeenHeight, result);
     }
-    if (doubleTarget <= feeStats->GetMaxConfirms()) {
-        double longEstimate = longStats->EstimateMedianVal(doubleTarget, SUFFICIENT_FEETXS, DOUBLE_SUCCESS_PCT, nBestSeenHeight, &tempResult);
+    if (doubleTarget <= feeStats.GetMaxConfirms()) {
+        double longEstimate = longStats.EstimateMedianVal(doubleTarget, SUFFICIENT_FEETXS, DOUBLE_SUCCESS_PCT, nBestSeenHeight, &tempResult);
         if (longEstimate > estimate) {
             estimate = longEstimate;
             if (result) *result = tempResult;
@@ -866,7 +951,7 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
-    LOCK(m_cs_fee_estimator);
+    const auto snapshot{GetSnapshot()};
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -877,14 +962,14 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
     EstimationResult tempResult;
 
     // Return failure if trying to analyze a target we're not tracking
-    if (confTarget <= 0 || (unsigned int)confTarget > longStats->GetMaxConfirms()) {
+    if (confTarget <= 0 || (unsigned int)confTarget > snapshot->longStats->GetMaxConfirms()) {
         return CFeeRate(0);  // error condition
     }
 
     // It's not possible to get reasonable estimates for confTarget of 1
     if (confTarget == 1) confTarget = 2;
 
-    unsigned int maxUsableEstimate = MaxUsableEstimate();
+    unsigned int maxUsableEstimate = snapshot->max_usable_estimate;
     if ((unsigned int)confTarget > maxUsableEstimate) {
         confTarget = maxUsableEstimate;
     }
@@ -903,13 +988,13 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
      * the purpose of conservative estimates is not to let short term
      * fluctuations lower our estimates by too much.
      */
-    double halfEst = estimateCombinedFee(confTarget/2, HALF_SUCCESS_PCT, true, &tempResult);
+    double halfEst = estimateCombinedFee(*snapshot, confTarget/2, HALF_SUCCESS_PCT, true, &tempResult);
     if (feeCalc) {
         feeCalc->est = tempResult;
         feeCalc->reason = FeeReason::HALF_ESTIMATE;
     }
     median = halfEst;
-    double actualEst = estimateCombinedFee(confTarget, SUCCESS_PCT, true, &tempResult);
+    double actualEst = estimateCombinedFee(*snapshot, confTarget, SUCCESS_PCT, true, &tempResult);
     if (actualEst > median) {
         median = actualEst;
         if (feeCalc) {
@@ -917,7 +1002,7 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
             feeCalc->reason = FeeReason::FULL_ESTIMATE;
         }
     }
-    double doubleEst = estimateCombinedFee(2 * confTarget, DOUBLE_SUCCESS_PCT, !conservative, &tempResult);
+    double doubleEst = estimateCombinedFee(*snapshot, 2 * confTarget, DOUBLE_SUCCESS_PCT, !conservative, &tempResult);
     if (doubleEst > median) {
         median = doubleEst;
         if (feeCalc) {
@@ -927,7 +1012,7 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
     }
 
     if (conservative || median == -1) {
-        double consEst =  estimateConservativeFee(2 * confTarget, &tempResult);
+        double consEst =  estimateConservativeFee(*snapshot, 2 * confTarget, &tempResult);
         if (consEst > median) {
             median = consEst;
             if (feeCalc) {
@@ -1035,6 +1120,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            PublishSnapshot();
         }
     }
     catch (const std::exception& e) {
@@ -1048,12 +1134,14 @@ void CBlockPolicyEstimator::FlushUnconfirmed()
 {
     const auto startclear{SteadyClock::now()};
     LOCK(m_cs_fee_estimator);
+    ApplyPendingEvents();
     size_t num_entries = mapMemPoolTxs.size();
     // Remove every entry in mapMemPoolTxs
     while (!mapMemPoolTxs.empty()) {
         auto mi = mapMemPoolTxs.begin();
         _removeTx(mi->first, false); // this calls erase() on mapMemPoolTxs
     }
+    PublishSnapshot();
     const auto endclear{SteadyClock::now()};
     LogPrint(BCLog::ESTIMATEFEE, "Recorded %u unconfirmed txs from mempool in %.3fs\n", num_entries, Ticks<SecondsDouble>(endclear - startclear));
 }
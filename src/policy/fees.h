@@ -144,6 +144,11 @@ struct FeeCalculation
  *  We want to be able to estimate feerates that are needed on tx's to be included in
  * a certain number of blocks.  Every time a block is added to the best chain, this class records
  * stats on the transactions included in that block
+ *
+ * Mempool additions and removals reported by the validation interface only append to an
+ * event log. The bucket updates for these events are applied in order, in one batch, when
+ * the next block is processed. Estimates are calculated from an immutable snapshot of the
+ * stats that is published after every block, so they never wait for the estimator lock.
  */
 class CBlockPolicyEstimator : public CValidationInterface
 {
@@ -205,19 +210,20 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_pending_mutex, !m_snapshot_mutex);
 
-    /** Process a transaction accepted to the mempool*/
+    /** Process a transaction accepted to the mempool. The transaction is queued and
+     *  its bucket is updated when the next block is processed. */
     void processTransaction(const NewMempoolTransactionInfo& tx)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_pending_mutex);
 
     /** Remove a transaction from the mempool tracking stats for non BLOCK removal reasons*/
     bool removeTx(uint256 hash)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_pending_mutex, !m_snapshot_mutex);
 
     /** DEPRECATED. Return a feerate estimate */
     CFeeRate estimateFee(int confTarget) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
 
     /** Estimate feerate needed to get be included in a block within confTarget
      *  blocks. If no answer can be given at confTarget, return an estimate at
@@ -225,7 +231,7 @@ public:
      *  valid over longer time horizons also.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -233,7 +239,7 @@ public:
      */
     CFeeRate estimateRawFee(int confTarget, double successThreshold, FeeEstimateHorizon horizon,
                             EstimationResult* result = nullptr) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
 
     /** Write estimation data to a file */
     bool Write(AutoFile& fileout) const
@@ -241,19 +247,19 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_snapshot_mutex);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_pending_mutex, !m_snapshot_mutex);
 
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_pending_mutex, !m_snapshot_mutex);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -265,11 +271,11 @@ public:
 protected:
     /** Overridden from CValidationInterface. */
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_pending_mutex);
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_pending_mutex);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_pending_mutex, !m_snapshot_mutex);
 
 private:
     mutable Mutex m_cs_fee_estimator;
@@ -300,13 +306,54 @@ private:
     std::vector<double> buckets GUARDED_BY(m_cs_fee_estimator); // The upper-bound of the range for the bucket (inclusive)
     std::map<double, unsigned int> bucketMap GUARDED_BY(m_cs_fee_estimator); // Map of bucket upper-bound to index into all vectors by bucket
 
+    /** A mempool addition or removal reported by the validation interface */
+    struct MempoolTxEvent
+    {
+        uint256 hash;
+        bool removed{false};
+        /** Only set for additions */
+        unsigned int height{0};
+        double feerate{0};
+        bool valid_for_estimation{false};
+    };
+
+    /** Guards only the event log, so the validation callbacks never wait for bucket updates */
+    Mutex m_pending_mutex;
+    std::vector<MempoolTxEvent> m_pending_events GUARDED_BY(m_pending_mutex);
+
+    /** Immutable copy of the data estimates are calculated from */
+    struct EstimatorSnapshot
+    {
+        unsigned int nBestSeenHeight{0};
+        unsigned int max_usable_estimate{0};
+        std::vector<double> buckets;
+        std::map<double, unsigned int> bucketMap;
+        std::unique_ptr<const TxConfirmStats> feeStats;
+        std::unique_ptr<const TxConfirmStats> shortStats;
+        std::unique_ptr<const TxConfirmStats> longStats;
+
+        ~EstimatorSnapshot();
+    };
+
+    mutable Mutex m_snapshot_mutex;
+    std::shared_ptr<const EstimatorSnapshot> m_snapshot GUARDED_BY(m_snapshot_mutex);
+
+    /** Apply all queued mempool events to the stats, in the order they were reported */
+    void ApplyPendingEvents() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_pending_mutex);
+    /** Copy the current stats into a new snapshot for estimates to use */
+    void PublishSnapshot() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_snapshot_mutex);
+    std::shared_ptr<const EstimatorSnapshot> GetSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(!m_snapshot_mutex);
+
+    /** A non-thread-safe helper for tracking a queued mempool addition */
+    void _processTransaction(const MempoolTxEvent& event) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+
     /** Process a transaction confirmed in a block*/
     bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
 
     /** Helper for estimateSmartFee */
-    double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    static double estimateCombinedFee(const EstimatorSnapshot& snapshot, unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result);
     /** Helper for estimateSmartFee */
-    double estimateConservativeFee(unsigned int doubleTarget, EstimationResult *result) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+    static double estimateConservativeFee(const EstimatorSnapshot& snapshot, unsigned int doubleTarget, EstimationResult *result);
     /** Number of blocks of data recorded while fee estimates have been running */
     unsigned int BlockSpan() const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
     /** Number of blocks of recorded fee estimate data represented in saved data file */
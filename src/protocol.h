@@ -336,6 +336,11 @@ enum ServiceFlags : uint64_t {
     // collisions and other cases where nodes may be advertising a service they
     // do not actually support. Other service bits should be allocated via the
     // BIP process.
+
+    // NODE_OUTPOINT_FILTERS means the node will service outpoint block filter
+    // requests, using the BIP157 messages with the outpoint filter type. The
+    // outpoint filter is not specified in a BIP, so this is an experimental bit.
+    NODE_OUTPOINT_FILTERS = (1 << 24),
 };
 
 /**
@@ -13,10 +13,13 @@
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
+#include <index/addrindex.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
+#include <key_io.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <node/mempool_event_log.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
@@ -32,17 +35,22 @@
 #include <util/strencodings.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <any>
+#include <limits>
 #include <vector>
 
 #include <univalue.h>
+#include <univalue_stream.h>
 
 using node::GetTransaction;
+using node::MempoolEvent;
 using node::NodeContext;
 using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+static constexpr unsigned int MAX_REST_MEMPOOL_EVENTS = 10000;
 
 static const struct {
     RESTResponseFormat rf;
@@ -336,10 +344,18 @@ static bool rest_block(const std::any& context,
         CBlock block{};
         DataStream block_stream{block_data};
         block_stream >> TX_WITH_WITNESS(block);
-        UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity);
-        std::string strJSON = objBlock.write() + "\n";
+        // Send the JSON in parts as it is produced, rather than building all of it first.
+        UniValueStreamWriter writer{[req](std::string_view chunk) { req->WriteBody(chunk); }};
+        try {
+            blockToJSON(writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity);
+            writer.flush();
+        } catch (const std::runtime_error& e) {
+            // Nothing was sent yet, so drop the partial JSON and reply the error.
+            req->ClearBody();
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, e.what());
+        }
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        req->WriteReply(HTTP_OK, "\n");
         return true;
     }
 
@@ -641,6 +657,82 @@ static bool rest_deploymentinfo(const std::any& context, HTTPRequest* req, const
 
 }
 
+static bool rest_mempool_events(const std::any& context, HTTPRequest* req, RESTResponseFormat rf)
+{
+    const NodeContext* node = GetNodeContext(context, req);
+    if (!node) return false;
+    if (!node->mempool_event_log) {
+        return RESTERR(req, HTTP_NOT_FOUND, "Mempool event log disabled (see -restmempoolevents)");
+    }
+
+    std::string raw_start;
+    std::string raw_count;
+    try {
+        raw_start = req->GetQueryParameter("start").value_or("0");
+        raw_count = req->GetQueryParameter("count").value_or("1000");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto start{ToIntegral<uint64_t>(raw_start)};
+    if (!start.has_value()) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid start: " + raw_start);
+    }
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count.has_value() || *count < 1 || *count > MAX_REST_MEMPOOL_EVENTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Event count is invalid or out of acceptable range (1-%u): %s", MAX_REST_MEMPOOL_EVENTS, raw_count));
+    }
+
+    const auto page{node->mempool_event_log->Read(*start, *count)};
+    if (!page) {
+        return RESTERR(req, HTTP_NOT_FOUND, strprintf("Events starting at %u are no longer available, resync using /rest/mempool/contents.json?verbose=false&mempool_sequence=true", *start));
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        DataStream ss_events{};
+        ss_events << page->next_seq << page->events;
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, ss_events);
+        } else {
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, HexStr(ss_events) + "\n");
+        }
+        return true;
+    }
+    case RESTResponseFormat::JSON: {
+        UniValue events(UniValue::VARR);
+        for (const MempoolEvent& event : page->events) {
+            UniValue obj(UniValue::VOBJ);
+            obj.pushKV("seq", event.seq);
+            obj.pushKV("mempool_sequence", event.mempool_sequence);
+            obj.pushKV("txid", event.txid.ToString());
+            obj.pushKV("wtxid", event.wtxid.ToString());
+            if (event.type == MempoolEvent::Type::ADDED) {
+                obj.pushKV("type", "added");
+                obj.pushKV("fee", ValueFromAmount(event.fee));
+                obj.pushKV("vsize", event.vsize);
+                obj.pushKV("hex", EncodeHexTx(*event.tx));
+            } else {
+                obj.pushKV("type", "removed");
+                obj.pushKV("reason", RemovalReasonToString(event.reason));
+            }
+            events.push_back(std::move(obj));
+        }
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("next", page->next_seq);
+        result.pushKV("events", std::move(events));
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, result.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+}
+
 static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
 {
     if (!CheckWarmup(req))
@@ -648,8 +740,11 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
 
     std::string param;
     const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
+    if (param == "events") {
+        return rest_mempool_events(context, req, rf);
+    }
     if (param != "contents" && param != "info") {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents>.json");
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents|events>.<ext>");
     }
 
     const CTxMemPool* mempool = GetMemPool(context, req);
@@ -682,7 +777,20 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
-            str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+            if (verbose) {
+                UniValueStreamWriter writer{[req](std::string_view chunk) { req->WriteBody(chunk); }};
+                try {
+                    MempoolToJSON(writer, *mempool);
+                    writer.flush();
+                } catch (const std::runtime_error& e) {
+                    // Nothing was sent yet, so drop the partial JSON and reply the error.
+                    req->ClearBody();
+                    return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, e.what());
+                }
+                str_json = "\n";
+            } else {
+                str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+            }
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
         }
@@ -996,6 +1104,67 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_address_history(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string address;
+    const RESTResponseFormat rf = ParseDataFormat(address, str_uri_part);
+
+    if (!g_addr_index) {
+        return RESTERR(req, HTTP_NOT_FOUND, "Address index disabled (see -addrindex)");
+    }
+    const CTxDestination dest{DecodeDestination(address)};
+    if (!IsValidDestination(dest)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + SanitizeString(address));
+    }
+
+    std::string raw_start;
+    std::string raw_stop;
+    std::string raw_count;
+    try {
+        raw_start = req->GetQueryParameter("start").value_or("0");
+        raw_stop = req->GetQueryParameter("stop").value_or("");
+        raw_count = req->GetQueryParameter("count").value_or("1000");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto start{ToIntegral<int32_t>(raw_start)};
+    const auto stop{raw_stop.empty() ? std::numeric_limits<int32_t>::max() : ToIntegral<int32_t>(raw_stop)};
+    if (!start.has_value() || !stop.has_value() || *start < 0 || *start > *stop) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid start or stop height");
+    }
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count.has_value() || *count < 1 || *count > MAX_ADDRESS_HISTORY_COUNT) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Transaction count is invalid or out of acceptable range (1-%u): %s", MAX_ADDRESS_HISTORY_COUNT, raw_count));
+    }
+
+    if (!g_addr_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Address index is still syncing");
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+    const int stop_height{std::min(*stop, WITH_LOCK(cs_main, return chainman.ActiveChain().Height()))};
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        UniValue history;
+        try {
+            history = ScriptHistoryToJSON(chainman, *g_addr_index, GetScriptForDestination(dest), *start, stop_height, *count);
+        } catch (const std::runtime_error& e) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, e.what());
+        }
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, history.write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1012,6 +1181,7 @@ static const struct {
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/addresshistory/", rest_address_history},
 };
 
 void StartREST(const std::any& context)
@@ -0,0 +1,179 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/binary.h>
+
+#include <chain.h>
+#include <index/txindex.h>
+#include <node/blockstorage.h>
+#include <node/context.h>
+#include <node/transaction.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <rpc/protocol.h>
+#include <rpc/server_util.h>
+#include <rpc/util.h>
+#include <serialize.h>
+#include <sync.h>
+#include <txmempool.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <map>
+#include <vector>
+
+using node::NodeContext;
+
+namespace {
+
+using BinaryRPCMethod = void (*)(const NodeContext& node, SpanReader& params, DataStream& result);
+
+const CBlockIndex& LookupBlock(ChainstateManager& chainman, const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    const CBlockIndex* pindex{chainman.m_blockman.LookupBlockIndex(hash)};
+    if (!pindex) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+    }
+    return *pindex;
+}
+
+/** () -> (uint256 hash, int32 height) */
+void getbestblockhash(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    ChainstateManager& chainman{EnsureChainman(node)};
+    LOCK(cs_main);
+    const CBlockIndex& tip{*CHECK_NONFATAL(chainman.ActiveChain().Tip())};
+    result << tip.GetBlockHash() << int32_t{tip.nHeight};
+}
+
+/** (int32 height) -> (uint256 hash) */
+void getblockhash(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    int32_t height;
+    params >> height;
+    ChainstateManager& chainman{EnsureChainman(node)};
+    LOCK(cs_main);
+    const CBlockIndex* pindex{height < 0 ? nullptr : chainman.ActiveChain()[height]};
+    if (!pindex) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Block height out of range");
+    }
+    result << pindex->GetBlockHash();
+}
+
+/** (uint256 hash) -> (CBlockHeader header, int32 height) */
+void getblockheader(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    uint256 hash;
+    params >> hash;
+    ChainstateManager& chainman{EnsureChainman(node)};
+    LOCK(cs_main);
+    const CBlockIndex& index{LookupBlock(chainman, hash)};
+    result << index.GetBlockHeader() << int32_t{index.nHeight};
+}
+
+/** (uint256 hash) -> (CBlock block), as stored on disk */
+void getblock(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    uint256 hash;
+    params >> hash;
+    ChainstateManager& chainman{EnsureChainman(node)};
+    FlatFilePos pos;
+    {
+        LOCK(cs_main);
+        const CBlockIndex& index{LookupBlock(chainman, hash)};
+        if (chainman.m_blockman.IsBlockPruned(index)) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+        }
+        pos = index.GetBlockPos();
+    }
+    std::vector<uint8_t> block_data;
+    if (!chainman.m_blockman.ReadRawBlockFromDisk(block_data, pos)) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    }
+    result.write(MakeByteSpan(block_data));
+}
+
+/** (uint256 hash) -> (CBlockUndo undo), the outputs spent by the block */
+void getblockundo(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    uint256 hash;
+    params >> hash;
+    ChainstateManager& chainman{EnsureChainman(node)};
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = &LookupBlock(chainman, hash);
+        if (chainman.m_blockman.IsBlockPruned(*pindex)) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Undo data not available (pruned data)");
+        }
+    }
+    CBlockUndo block_undo;
+    // The genesis block spends nothing and has no undo data.
+    if (pindex->nHeight > 0 && !chainman.m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Undo data not found on disk");
+    }
+    result << block_undo;
+}
+
+/** () -> (std::vector<uint256> txids, uint64 mempool_sequence) */
+void getrawmempool(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    const CTxMemPool& mempool{EnsureMemPool(node)};
+    std::vector<uint256> txids;
+    uint64_t mempool_sequence;
+    {
+        LOCK(mempool.cs);
+        txids.reserve(mempool.size());
+        for (const CTxMemPoolEntry& e : mempool.entryAll()) {
+            txids.push_back(e.GetTx().GetHash().ToUint256());
+        }
+        mempool_sequence = mempool.GetSequence();
+    }
+    result << txids << mempool_sequence;
+}
+
+/** (uint256 txid) -> (CTransaction tx, uint256 block_hash), with a zero block
+ * hash for mempool transactions */
+void getrawtransaction(const NodeContext& node, SpanReader& params, DataStream& result)
+{
+    uint256 txid;
+    params >> txid;
+    ChainstateManager& chainman{EnsureChainman(node)};
+    const bool txindex_ready{g_txindex && g_txindex->BlockUntilSyncedToCurrentChain()};
+    uint256 block_hash;
+    const CTransactionRef tx{node::GetTransaction(/*block_index=*/nullptr, node.mempool.get(), txid, block_hash, chainman.m_blockman)};
+    if (!tx) {
+        if (!g_txindex) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No such mempool transaction. Use -txindex to enable blockchain transaction queries");
+        } else if (!txindex_ready) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No such mempool transaction. Blockchain transactions are still in the process of being indexed");
+        }
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No such mempool or blockchain transaction");
+    }
+    result << TX_WITH_WITNESS(tx) << block_hash;
+}
+
+const std::map<std::string_view, BinaryRPCMethod> g_binary_methods{
+    {"getbestblockhash", getbestblockhash},
+    {"getblock", getblock},
+    {"getblockhash", getblockhash},
+    {"getblockheader", getblockheader},
+    {"getblockundo", getblockundo},
+    {"getrawmempool", getrawmempool},
+    {"getrawtransaction", getrawtransaction},
+};
+
+} // namespace
+
+void ExecuteBinaryRPC(const std::any& context, std::string_view method, SpanReader& params, DataStream& result)
+{
+    const auto it{g_binary_methods.find(method)};
+    if (it == g_binary_methods.end()) {
+        throw JSONRPCError(RPC_METHOD_NOT_FOUND, "Method not found");
+    }
+    it->second(EnsureAnyNodeContext(context), params, result);
+    if (!params.empty()) {
+        throw std::ios_base::failure("Excess arguments");
+    }
+}
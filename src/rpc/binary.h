@@ -0,0 +1,31 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BGL_RPC_BINARY_H
+#define BGL_RPC_BINARY_H
+
+#include <streams.h>
+
+#include <any>
+#include <cstddef>
+#include <string_view>
+
+static constexpr bool DEFAULT_RPC_BINARY{false};
+/** Maximum number of calls in one binary RPC request */
+static constexpr size_t MAX_BINARY_RPC_CALLS{1000};
+/** Once the reply to a binary RPC request is this large, its remaining calls
+ * fail without being executed */
+static constexpr size_t MAX_BINARY_RPC_REPLY_SIZE{32 << 20};
+
+/**
+ * Execute a method of the binary RPC interface, which serves a few frequently
+ * called RPCs with their arguments and results in the consensus serialization
+ * instead of JSON. See doc/binary-rpc-interface.md for the methods.
+ *
+ * Throws a JSONRPCError object for unknown methods and failed calls, and
+ * std::ios_base::failure for malformed or excess arguments.
+ */
+void ExecuteBinaryRPC(const std::any& context, std::string_view method, SpanReader& params, DataStream& result);
+
+#endif // BGL_RPC_BINARY_H
@@ -19,9 +19,11 @@
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <index/addrindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <kernel/coinstats.h>
+#include <key_io.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
@@ -42,6 +44,7 @@
 #include <txmempool.h>
 #include <undo.h>
 #include <univalue.h>
+#include <univalue_stream.h>
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
@@ -163,19 +166,14 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
-UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity)
+/** Pass the entries of the "tx" field of blockToJSON to fn, one at a time. */
+template <typename Fn>
+static void BlockTxsToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& blockindex, TxVerbosity verbosity, Fn&& fn)
 {
-    UniValue result = blockheaderToJSON(tip, blockindex);
-
-    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
-    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
-    result.pushKV("weight", (int)::GetBlockWeight(block));
-    UniValue txs(UniValue::VARR);
-
     switch (verbosity) {
         case TxVerbosity::SHOW_TXID:
             for (const CTransactionRef& tx : block.vtx) {
-                txs.push_back(tx->GetHash().GetHex());
+                fn(tx->GetHash().GetHex());
             }
             break;
 
@@ -191,16 +189,45 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
                 const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
-                txs.push_back(std::move(objTx));
+                fn(std::move(objTx));
             }
             break;
     }
+}
 
+UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity)
+{
+    UniValue result = blockheaderToJSON(tip, blockindex);
+
+    result.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
+    result.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
+    result.pushKV("weight", (int)::GetBlockWeight(block));
+    UniValue txs(UniValue::VARR);
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue tx) { txs.push_back(std::move(tx)); });
     result.pushKV("tx", std::move(txs));
 
     return result;
 }
 
+void blockToJSON(UniValueStreamWriter& writer, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity)
+{
+    const UniValue header{blockheaderToJSON(tip, blockindex)};
+
+    writer.beginObject();
+    for (size_t i = 0; i < header.size(); ++i) {
+        writer.pushKV(header.getKeys()[i], header[i]);
+    }
+    writer.pushKV("strippedsize", (int)::GetSerializeSize(TX_NO_WITNESS(block)));
+    writer.pushKV("size", (int)::GetSerializeSize(TX_WITH_WITNESS(block)));
+    writer.pushKV("weight", (int)::GetBlockWeight(block));
+    writer.key("tx");
+    writer.beginArray();
+    // Only a single transaction is held as a UniValue at any time.
+    BlockTxsToJSON(blockman, block, blockindex, verbosity, [&](UniValue tx) { writer.value(tx); });
+    writer.endArray();
+    writer.endObject();
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{"getblockcount",
@@ -780,6 +807,10 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
+    if (request.m_result_writer && tx_verbosity != TxVerbosity::SHOW_TXID) {
+        blockToJSON(*request.m_result_writer, chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity);
+        return NullUniValue;
+    }
     return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity);
 },
     };
@@ -2431,6 +2462,10 @@ static RPCHelpMan scanblocks()
         if (!BlockFilterTypeByName(filtertype_name, filtertype)) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown filtertype");
         }
+        // Only basic filters commit to the scripts of spent outputs.
+        if (filtertype != BlockFilterType::BASIC) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "scanblocks only supports the basic filtertype");
+        }
 
         UniValue options{request.params[5].isNull() ? UniValue::VOBJ : request.params[5]};
         bool filter_false_positives{options.exists("filter_false_positives") ? options["filter_false_positives"].get_bool() : false};
@@ -2624,6 +2659,118 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+UniValue ScriptHistoryToJSON(ChainstateManager& chainman, const AddrIndex& index, const CScript& script,
+                             int start_height, int stop_height, size_t max_count)
+{
+    // Postings only hold heights. A reorg may rewind the index between reading
+    // them and reading their blocks, so the postings are resolved against the
+    // index's best block, and read again if it changed in the meantime.
+    std::vector<AddrIndexPosting> postings;
+    std::optional<int> next_height;
+    const CBlockIndex* best_block{nullptr};
+    for (int attempt = 0; attempt < 3 && !best_block; ++attempt) {
+        const uint256 best_hash{index.GetSummary().best_block_hash};
+        postings.clear();
+        next_height = index.FindScriptHistory(script, start_height, stop_height, max_count, postings);
+        if (index.GetSummary().best_block_hash == best_hash) {
+            best_block = WITH_LOCK(::cs_main, return chainman.m_blockman.LookupBlockIndex(best_hash));
+        }
+    }
+    if (!best_block) {
+        throw std::runtime_error("The address index changed while it was read, try again");
+    }
+
+    UniValue history(UniValue::VARR);
+    const CBlockIndex* pindex{nullptr};
+    CBlock block;
+    for (const AddrIndexPosting& posting : postings) {
+        if (!pindex || pindex->nHeight != posting.height) {
+            pindex = best_block->GetAncestor(posting.height);
+            if (!pindex || !chainman.m_blockman.ReadBlockFromDisk(block, *pindex)) {
+                throw std::runtime_error(strprintf("Failed to read block at height %d", posting.height));
+            }
+        }
+        if (posting.tx_pos >= block.vtx.size()) {
+            throw std::runtime_error(strprintf("Transaction %u not found in block %s", posting.tx_pos, pindex->GetBlockHash().ToString()));
+        }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("height", posting.height);
+        entry.pushKV("blockhash", pindex->GetBlockHash().GetHex());
+        entry.pushKV("txid", block.vtx[posting.tx_pos]->GetHash().GetHex());
+        entry.pushKV("type", posting.spend ? "spend" : "receive");
+        history.push_back(std::move(entry));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("history", std::move(history));
+    if (next_height) ret.pushKV("next_height", *next_height);
+    return ret;
+}
+
+static RPCHelpMan getaddresshistory()
+{
+    return RPCHelpMan{"getaddresshistory",
+                "\nReturn the confirmed transactions that paid to or spent from an address, in chain order.\n"
+                "Requires -addrindex.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address"},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The height of the first block to look at"},
+                    {"stop_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the current best block"}, "The height of the last block to look at"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{1000}, strprintf("Stop after the block at which this many transactions were found (1 to %u)", MAX_ADDRESS_HISTORY_COUNT)},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "history", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::NUM, "height", "The block height"},
+                                {RPCResult::Type::STR_HEX, "blockhash", "The block hash"},
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                {RPCResult::Type::STR, "type", "\"receive\" if the transaction created an output to the address, \"spend\" if it spent one. A transaction doing both is listed twice."},
+                            }},
+                        }},
+                        {RPCResult::Type::NUM, "next_height", /*optional=*/true, "The start_height to continue from, if the history up to stop_height was cut short by count"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 100000 200000") +
+                    HelpExampleRpc("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\", 100000, 200000")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_addr_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index is not enabled (see -addrindex)");
+    }
+
+    const CTxDestination dest{DecodeDestination(request.params[0].get_str())};
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    if (!g_addr_index->BlockUntilSyncedToCurrentChain()) {
+        const IndexSummary summary{g_addr_index->GetSummary()};
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because addrindex is still syncing. Current height: %d", summary.best_block_height));
+    }
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const int tip_height{WITH_LOCK(::cs_main, return chainman.ActiveChain().Height())};
+    const int start_height{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    const int stop_height{request.params[2].isNull() ? tip_height : std::min(request.params[2].getInt<int>(), tip_height)};
+    if (start_height < 0 || start_height > stop_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid start_height or stop_height");
+    }
+    const int count{request.params[3].isNull() ? 1000 : request.params[3].getInt<int>()};
+    if (count < 1 || count > int{MAX_ADDRESS_HISTORY_COUNT}) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count is out of range (1-%u)", MAX_ADDRESS_HISTORY_COUNT));
+    }
+
+    return ScriptHistoryToJSON(chainman, *g_addr_index, GetScriptForDestination(dest), start_height, stop_height, count);
+},
+    };
+}
+
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
  *
@@ -2953,6 +3100,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getaddresshistory},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
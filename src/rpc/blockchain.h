@@ -16,10 +16,13 @@
 #include <stdint.h>
 #include <vector>
 
+class AddrIndex;
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class CScript;
 class UniValue;
+class UniValueStreamWriter;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -40,10 +43,19 @@ void RPCNotifyBlockChange(const CBlockIndex*);
 
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity) LOCKS_EXCLUDED(cs_main);
+/** Block description to JSON, written to a stream */
+void blockToJSON(UniValueStreamWriter& writer, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity) LOCKS_EXCLUDED(cs_main);
 
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex) LOCKS_EXCLUDED(cs_main);
 
+/** Most transactions one getaddresshistory call or /rest/addresshistory request may ask for */
+static constexpr unsigned int MAX_ADDRESS_HISTORY_COUNT{10000};
+
+/** Transactions touching a script, as returned by getaddresshistory */
+UniValue ScriptHistoryToJSON(ChainstateManager& chainman, const AddrIndex& index, const CScript& script,
+                             int start_height, int stop_height, size_t max_count) LOCKS_EXCLUDED(cs_main);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
@@ -86,6 +86,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "sendmany", 6 , "conf_target" },
     { "sendmany", 8, "fee_rate"},
     { "sendmany", 9, "verbose" },
+    { "queuepayout", 1, "amount" },
+    { "queuepayout", 2, "subtractfeefromamount" },
+    { "getpayout", 0, "payout_id" },
     { "deriveaddresses", 1, "range" },
     { "scanblocks", 1, "scanobjects" },
     { "scanblocks", 2, "start_height" },
@@ -246,6 +249,9 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "listdescriptors", 0, "private" },
     { "verifychain", 0, "checklevel" },
     { "verifychain", 1, "nblocks" },
+    { "getaddresshistory", 1, "start_height" },
+    { "getaddresshistory", 2, "stop_height" },
+    { "getaddresshistory", 3, "count" },
     { "getblockstats", 0, "hash_or_height" },
     { "getblockstats", 1, "stats" },
     { "pruneblockchain", 0, "height" },
@@ -264,6 +270,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getmempoolancestors", 1, "verbose" },
     { "getmempooldescendants", 1, "verbose" },
     { "gettxspendingprevout", 0, "outputs" },
+    { "gettxspendingprevout", 1, "options" },
+    { "gettxspendingprevout", 1, "mempool_only" },
     { "bumpfee", 1, "options" },
     { "bumpfee", 1, "conf_target"},
     { "bumpfee", 1, "fee_rate"},
@@ -9,6 +9,7 @@
 
 #include <chainparams.h>
 #include <core_io.h>
+#include <index/spenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <node/mempool_persist_args.h>
 #include <node/types.h>
@@ -20,6 +21,7 @@
 #include <rpc/util.h>
 #include <txmempool.h>
 #include <univalue.h>
+#include <univalue_stream.h>
 #include <util/fs.h>
 #include <util/moneystr.h>
 #include <util/strencodings.h>
@@ -279,33 +281,102 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+/**
+ * Copy of the data shown for a mempool entry. It is taken while holding
+ * pool.cs, and the JSON is built from it after the lock has been released,
+ * so that serializing large results does not block transaction acceptance.
+ */
+struct MempoolEntrySnapshot {
+    Txid txid;
+    Wtxid wtxid;
+    int32_t vsize;
+    int32_t weight;
+    std::chrono::seconds time;
+    unsigned int height;
+    uint64_t descendant_count;
+    int64_t descendant_size;
+    uint64_t ancestor_count;
+    int64_t ancestor_size;
+    CAmount fee;
+    CAmount modified_fee;
+    CAmount ancestor_fees;
+    CAmount descendant_fees;
+    std::vector<Txid> depends;
+    std::vector<Txid> spent_by;
+    bool bip125_replaceable;
+    bool unbroadcast;
+};
+
+static MempoolEntrySnapshot SnapshotEntry(const CTxMemPool& pool, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
 {
     AssertLockHeld(pool.cs);
 
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    const CTransaction& tx = e.GetTx();
+    MempoolEntrySnapshot snapshot{
+        .txid = tx.GetHash(),
+        .wtxid = tx.GetWitnessHash(),
+        .vsize = e.GetTxSize(),
+        .weight = e.GetTxWeight(),
+        .time = e.GetTime(),
+        .height = e.GetHeight(),
+        .descendant_count = e.GetCountWithDescendants(),
+        .descendant_size = e.GetSizeWithDescendants(),
+        .ancestor_count = e.GetCountWithAncestors(),
+        .ancestor_size = e.GetSizeWithAncestors(),
+        .fee = e.GetFee(),
+        .modified_fee = e.GetModifiedFee(),
+        .ancestor_fees = e.GetModFeesWithAncestors(),
+        .descendant_fees = e.GetModFeesWithDescendants(),
+        .depends = {},
+        .spent_by = {},
+        .bip125_replaceable = false,
+        .unbroadcast = pool.IsUnbroadcastTx(tx.GetHash()),
+    };
+
+    for (const CTxIn& txin : tx.vin) {
+        if (pool.exists(GenTxid::Txid(txin.prevout.hash))) {
+            snapshot.depends.push_back(txin.prevout.hash);
+        }
+    }
+
+    snapshot.spent_by.reserve(e.GetMemPoolChildrenConst().size());
+    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
+        snapshot.spent_by.push_back(child.GetTx().GetHash());
+    }
+
+    // Add opt-in RBF status
+    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
+    if (rbfState == RBFTransactionState::UNKNOWN) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
+    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
+        snapshot.bip125_replaceable = true;
+    }
+
+    return snapshot;
+}
+
+static void entryToJSON(UniValue& info, const MempoolEntrySnapshot& e)
+{
+    info.pushKV("vsize", (int)e.vsize);
+    info.pushKV("weight", (int)e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.descendant_count);
+    info.pushKV("descendantsize", e.descendant_size);
+    info.pushKV("ancestorcount", e.ancestor_count);
+    info.pushKV("ancestorsize", e.ancestor_size);
+    info.pushKV("wtxid", e.wtxid.ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.ancestor_fees));
+    fees.pushKV("descendant", ValueFromAmount(e.descendant_fees));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(GenTxid::Txid(txin.prevout.hash)))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : e.depends) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -317,23 +388,41 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.spent_by) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
 
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
+    info.pushKV("bip125-replaceable", e.bip125_replaceable);
+    info.pushKV("unbroadcast", e.unbroadcast);
+}
+
+/** Build a verbose JSON object, keyed by txid, from entry snapshots */
+static UniValue EntriesToJSON(const std::vector<MempoolEntrySnapshot>& entries)
+{
+    UniValue o(UniValue::VOBJ);
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        // Mempool has unique entries so there is no advantage in using
+        // UniValue::pushKV, which checks if the key already exists in O(N).
+        // UniValue::pushKVEnd is used instead which currently is O(1).
+        o.pushKVEnd(e.txid.ToString(), std::move(info));
     }
+    return o;
+}
 
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+/** Snapshot all entries of the mempool */
+static std::vector<MempoolEntrySnapshot> SnapshotAllEntries(const CTxMemPool& pool)
+{
+    std::vector<MempoolEntrySnapshot> entries;
+    LOCK(pool.cs);
+    entries.reserve(pool.size());
+    for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        entries.push_back(SnapshotEntry(pool, e));
+    }
+    return entries;
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -342,27 +431,22 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
-        UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
-            // Mempool has unique entries so there is no advantage in using
-            // UniValue::pushKV, which checks if the key already exists in O(N).
-            // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
-        }
-        return o;
+        return EntriesToJSON(SnapshotAllEntries(pool));
     } else {
-        UniValue a(UniValue::VARR);
+        std::vector<Txid> txids;
         uint64_t mempool_sequence;
         {
             LOCK(pool.cs);
+            txids.reserve(pool.size());
             for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
+                txids.push_back(e.GetTx().GetHash());
             }
             mempool_sequence = pool.GetSequence();
         }
+        UniValue a(UniValue::VARR);
+        for (const Txid& txid : txids) {
+            a.push_back(txid.ToString());
+        }
         if (!include_mempool_sequence) {
             return a;
         } else {
@@ -374,6 +458,19 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
     }
 }
 
+void MempoolToJSON(UniValueStreamWriter& writer, const CTxMemPool& pool)
+{
+    const std::vector<MempoolEntrySnapshot> entries{SnapshotAllEntries(pool)};
+    writer.beginObject();
+    // Only a single entry is held as a UniValue at any time.
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        writer.pushKV(e.txid.ToString(), info);
+    }
+    writer.endObject();
+}
+
 static RPCHelpMan getrawmempool()
 {
     return RPCHelpMan{"getrawmempool",
@@ -419,6 +516,10 @@ static RPCHelpMan getrawmempool()
         include_mempool_sequence = request.params[1].get_bool();
     }
 
+    if (request.m_result_writer && fVerbose && !include_mempool_sequence) {
+        MempoolToJSON(*request.m_result_writer, EnsureAnyMemPool(request.context));
+        return NullUniValue;
+    }
     return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
 },
     };
@@ -455,31 +556,35 @@ static RPCHelpMan getmempoolancestors()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<Txid> txids;
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    auto ancestors{mempool.AssumeCalculateMemPoolAncestors(self.m_name, *entry, CTxMemPool::Limits::NoLimits(), /*fSearchForParents=*/false)};
+        auto ancestors{mempool.AssumeCalculateMemPoolAncestors(self.m_name, *entry, CTxMemPool::Limits::NoLimits(), /*fSearchForParents=*/false)};
+
+        for (CTxMemPool::txiter ancestorIt : ancestors) {
+            if (fVerbose) {
+                entries.push_back(SnapshotEntry(mempool, *ancestorIt));
+            } else {
+                txids.push_back(ancestorIt->GetTx().GetHash());
+            }
+        }
+    }
 
     if (!fVerbose) {
         UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            o.push_back(ancestorIt->GetTx().GetHash().ToString());
+        for (const Txid& txid : txids) {
+            o.push_back(txid.ToString());
         }
         return o;
     } else {
-        UniValue o(UniValue::VOBJ);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            const CTxMemPoolEntry &e = *ancestorIt;
-            const uint256& _hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(_hash.ToString(), std::move(info));
-        }
-        return o;
+        return EntriesToJSON(entries);
     }
 },
     };
@@ -516,35 +621,39 @@ static RPCHelpMan getmempooldescendants()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<Txid> txids;
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto it{mempool.GetIter(hash)};
-    if (!it) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto it{mempool.GetIter(hash)};
+        if (!it) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    CTxMemPool::setEntries setDescendants;
-    mempool.CalculateDescendants(*it, setDescendants);
-    // CTxMemPool::CalculateDescendants will include the given tx
-    setDescendants.erase(*it);
+        CTxMemPool::setEntries setDescendants;
+        mempool.CalculateDescendants(*it, setDescendants);
+        // CTxMemPool::CalculateDescendants will include the given tx
+        setDescendants.erase(*it);
+
+        for (CTxMemPool::txiter descendantIt : setDescendants) {
+            if (fVerbose) {
+                entries.push_back(SnapshotEntry(mempool, *descendantIt));
+            } else {
+                txids.push_back(descendantIt->GetTx().GetHash());
+            }
+        }
+    }
 
     if (!fVerbose) {
         UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            o.push_back(descendantIt->GetTx().GetHash().ToString());
+        for (const Txid& txid : txids) {
+            o.push_back(txid.ToString());
         }
 
         return o;
     } else {
-        UniValue o(UniValue::VOBJ);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            const CTxMemPoolEntry &e = *descendantIt;
-            const uint256& _hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(_hash.ToString(), std::move(info));
-        }
-        return o;
+        return EntriesToJSON(entries);
     }
 },
     };
@@ -568,15 +677,17 @@ static RPCHelpMan getmempoolentry()
     uint256 hash = ParseHashV(request.params[0], "parameter 1");
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
-
-    const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+    const MempoolEntrySnapshot snapshot{[&] {
+        LOCK(mempool.cs);
+        const auto entry{mempool.GetEntry(Txid::FromUint256(hash))};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
+        return SnapshotEntry(mempool, *entry);
+    }()};
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(info, snapshot);
     return info;
 },
     };
@@ -585,7 +696,8 @@ static RPCHelpMan getmempoolentry()
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool to find transactions spending any of the given outputs.\n"
+        "With -spenderindex and mempool_only=false, confirmed transactions spending them are also returned.",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -597,6 +709,11 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::Default{true}, "Only look for spending transactions in the mempool. If false, confirmed spends are looked up in the -spenderindex"},
+                },
+            },
         },
         RPCResult{
             RPCResult::Type::ARR, "", "",
@@ -605,7 +722,9 @@ static RPCHelpMan gettxspendingprevout()
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::NUM, "spendingvin", /*optional=*/true, "the input of the spending transaction, only for a confirmed spend"},
+                    {RPCResult::Type::NUM, "blockheight", /*optional=*/true, "the height of the block containing the spending transaction, only for a confirmed spend"},
                 }},
             }
         },
@@ -641,6 +760,26 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
+            bool mempool_only{true};
+            if (!request.params[1].isNull()) {
+                const UniValue& options{request.params[1].get_obj()};
+                RPCTypeCheckObj(options,
+                                {
+                                    {"mempool_only", UniValueType(UniValue::VBOOL)},
+                                }, /*fAllowNull=*/true, /*fStrict=*/true);
+                if (options.exists("mempool_only")) mempool_only = options["mempool_only"].get_bool();
+            }
+            if (!mempool_only) {
+                if (!g_spender_index) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Use -spenderindex to look up confirmed spending transactions");
+                }
+                // Wait for the index to catch up before taking the mempool
+                // lock, so that a spend is either in the mempool or indexed.
+                if (!g_spender_index->BlockUntilSyncedToCurrentChain()) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Spender index is still being synced, use mempool_only to only check the mempool");
+                }
+            }
+
             const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
             LOCK(mempool.cs);
 
@@ -654,6 +793,12 @@ static RPCHelpMan gettxspendingprevout()
                 const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
                 if (spendingTx != nullptr) {
                     o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                } else if (!mempool_only) {
+                    if (const auto spender{g_spender_index->FindSpender(prevout)}) {
+                        o.pushKV("spendingtxid", spender->txid.ToString());
+                        o.pushKV("spendingvin", uint64_t{spender->vin});
+                        o.pushKV("blockheight", spender->height);
+                    }
                 }
 
                 result.push_back(std::move(o));
@@ -680,6 +825,15 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("incrementalrelayfee", ValueFromAmount(pool.m_opts.incremental_relay_feerate.GetFeePerK()));
     ret.pushKV("unbroadcastcount", uint64_t{pool.GetUnbroadcastTxs().size()});
     ret.pushKV("fullrbf", pool.m_opts.full_rbf);
+    const MempoolEvictionStats eviction_stats{pool.GetEvictionStats()};
+    UniValue evictions(UniValue::VOBJ);
+    evictions.pushKV("runs", eviction_stats.trim_runs);
+    evictions.pushKV("batches", eviction_stats.batches);
+    evictions.pushKV("packages", eviction_stats.packages);
+    evictions.pushKV("transactions", eviction_stats.txs);
+    evictions.pushKV("vbytes", eviction_stats.vbytes);
+    evictions.pushKV("time_us", count_microseconds(eviction_stats.time));
+    ret.pushKV("evictions", evictions);
     return ret;
 }
 
@@ -702,6 +856,15 @@ static RPCHelpMan getmempoolinfo()
                 {RPCResult::Type::NUM, "incrementalrelayfee", "minimum fee rate increment for mempool limiting or replacement in " + CURRENCY_UNIT + "/kvB"},
                 {RPCResult::Type::NUM, "unbroadcastcount", "Current number of transactions that haven't passed initial broadcast yet"},
                 {RPCResult::Type::BOOL, "fullrbf", "True if the mempool accepts RBF without replaceability signaling inspection"},
+                {RPCResult::Type::OBJ, "evictions", "Work done evicting transactions because the mempool exceeded its size limit",
+                {
+                    {RPCResult::Type::NUM, "runs", "Number of size limit enforcements that evicted transactions"},
+                    {RPCResult::Type::NUM, "batches", "Number of batches the evicted transactions were removed in"},
+                    {RPCResult::Type::NUM, "packages", "Number of evicted packages (lowest descendant score transaction and its descendants)"},
+                    {RPCResult::Type::NUM, "transactions", "Number of evicted transactions"},
+                    {RPCResult::Type::NUM, "vbytes", "Sum of the virtual sizes of the evicted transactions"},
+                    {RPCResult::Type::NUM, "time_us", "Total time spent evicting transactions, in microseconds"},
+                }},
             }},
         RPCExamples{
             HelpExampleCli("getmempoolinfo", "")
@@ -7,6 +7,7 @@
 
 class CTxMemPool;
 class UniValue;
+class UniValueStreamWriter;
 
 /** Mempool information to JSON */
 UniValue MempoolInfoToJSON(const CTxMemPool& pool);
@@ -14,4 +15,7 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 /** Mempool to JSON */
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose = false, bool include_mempool_sequence = false);
 
+/** Verbose mempool contents to JSON, written to a stream */
+void MempoolToJSON(UniValueStreamWriter& writer, const CTxMemPool& pool);
+
 #endif // BGL_RPC_MEMPOOL_H
@@ -8,7 +8,9 @@
 #include <chainparams.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/addrindex.h>
 #include <index/coinstatsindex.h>
+#include <index/spenderindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
@@ -392,6 +394,14 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_addr_index) {
+        result.pushKVs(SummaryToJSON(g_addr_index->GetSummary(), index_name));
+    }
+
+    if (g_spender_index) {
+        result.pushKVs(SummaryToJSON(g_spender_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
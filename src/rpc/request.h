@@ -13,6 +13,8 @@
 #include <univalue.h>
 #include <util/fs.h>
 
+class UniValueStreamWriter;
+
 enum class JSONRPCVersion {
     V1_LEGACY,
     V2
@@ -44,6 +46,12 @@ public:
     std::string peerAddr;
     std::any context;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    /**
+     * If set, a method with a large result may write it here instead of
+     * returning it, once nothing can fail anymore. The returned value is then
+     * ignored. Only set for requests answered on their own over HTTP.
+     */
+    UniValueStreamWriter* m_result_writer{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
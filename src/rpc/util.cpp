@@ -20,6 +20,7 @@
 #include <script/solver.h>
 #include <tinyformat.h>
 #include <univalue.h>
+#include <univalue_stream.h>
 #include <util/check.h>
 #include <util/result.h>
 #include <util/strencodings.h>
@@ -653,11 +654,28 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
     if (!arg_mismatch.empty()) {
         throw JSONRPCError(RPC_TYPE_ERROR, strprintf("Wrong type passed:\n%s", arg_mismatch.write(4)));
     }
+    const bool doc_check{gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)};
+    // A result written to the stream is captured and parsed back, so that it
+    // can be checked before it is passed on.
+    std::string streamed;
+    UniValueStreamWriter capture{[&streamed](std::string_view chunk) { streamed.append(chunk); }};
+    JSONRPCRequest capturing_request;
+    const JSONRPCRequest* req{&request};
+    if (doc_check && request.m_result_writer) {
+        capturing_request = request;
+        capturing_request.m_result_writer = &capture;
+        req = &capturing_request;
+    }
     CHECK_NONFATAL(m_req == nullptr);
-    m_req = &request;
-    UniValue ret = m_fun(*this, request);
+    m_req = req;
+    UniValue ret = m_fun(*this, *req);
     m_req = nullptr;
-    if (gArgs.GetBoolArg("-rpcdoccheck", DEFAULT_RPC_DOC_CHECK)) {
+    const bool streamed_result{capture.size() > 0};
+    if (streamed_result) {
+        capture.flush();
+        CHECK_NONFATAL(ret.read(streamed));
+    }
+    if (doc_check) {
         UniValue mismatch{UniValue::VARR};
         for (const auto& res : m_results.m_results) {
             UniValue match{res.MatchesType(ret)};
@@ -679,6 +697,7 @@ UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
                           PACKAGE_BUGREPORT)};
         }
     }
+    if (streamed_result) request.m_result_writer->value(ret);
     return ret;
 }
 
@@ -0,0 +1,89 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <consensus/validation.h>
+#include <index/addrindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <rpc/blockchain.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+#include <univalue.h>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(addrindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(addrindex_history, TestChain100Setup)
+{
+    AddrIndex addr_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(addr_index.Init());
+    BOOST_REQUIRE(addr_index.StartBackgroundSync());
+    IndexWaitSynced(addr_index, *Assert(m_node.shutdown));
+
+    // Every block of the test chain pays its coinbase to the same key.
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    std::vector<AddrIndexPosting> postings;
+    BOOST_CHECK(!addr_index.FindScriptHistory(coinbase_script, 0, 100, 1000, postings));
+    BOOST_REQUIRE_EQUAL(postings.size(), 100U);
+    for (int height = 1; height <= 100; ++height) {
+        BOOST_CHECK(postings[height - 1] == (AddrIndexPosting{height, 0, false}));
+    }
+
+    // Results stop after the block at which max_count is reached.
+    postings.clear();
+    BOOST_CHECK_EQUAL(addr_index.FindScriptHistory(coinbase_script, 20, 100, 10, postings).value_or(-1), 30);
+    BOOST_REQUIRE_EQUAL(postings.size(), 10U);
+    BOOST_CHECK_EQUAL(postings.front().height, 20);
+
+    // A block spending a coinbase output to a new address.
+    CKey key{GenerateRandomKey()};
+    const CScript dest_script{GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, dest_script, /*output_amount=*/COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_CHECK(addr_index.BlockUntilSyncedToCurrentChain());
+
+    postings.clear();
+    BOOST_CHECK(!addr_index.FindScriptHistory(dest_script, 0, 101, 1000, postings));
+    BOOST_REQUIRE_EQUAL(postings.size(), 1U);
+    BOOST_CHECK(postings[0] == (AddrIndexPosting{101, 1, false}));
+
+    postings.clear();
+    BOOST_CHECK(!addr_index.FindScriptHistory(coinbase_script, 101, 101, 1000, postings));
+    BOOST_CHECK(postings == (std::vector<AddrIndexPosting>{{101, 0, false}, {101, 1, true}}));
+
+    // Replacing the block in a reorg removes its entries.
+    const uint256 spend_block{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash())};
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    // Until the index has caught up with the reorg, the history is read from
+    // the blocks it indexed rather than the active chain.
+    const UniValue history{ScriptHistoryToJSON(*m_node.chainman, addr_index, dest_script, 0, 101, 1000)["history"]};
+    if (!history.empty()) {
+        BOOST_REQUIRE_EQUAL(history.size(), 1U);
+        BOOST_CHECK_EQUAL(history[0]["blockhash"].get_str(), spend_block.GetHex());
+        BOOST_CHECK_EQUAL(history[0]["txid"].get_str(), spend.GetHash().GetHex());
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(addr_index.BlockUntilSyncedToCurrentChain());
+
+    postings.clear();
+    BOOST_CHECK(!addr_index.FindScriptHistory(dest_script, 0, 101, 1000, postings));
+    BOOST_CHECK(postings.empty());
+    BOOST_CHECK(!addr_index.FindScriptHistory(coinbase_script, 101, 101, 1000, postings));
+    BOOST_CHECK(postings == (std::vector<AddrIndexPosting>{{101, 0, false}}));
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    addr_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
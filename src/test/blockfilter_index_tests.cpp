@@ -11,6 +11,7 @@
 #include <interfaces/chain.h>
 #include <node/miner.h>
 #include <pow.h>
+#include <streams.h>
 #include <test/util/blockfilter.h>
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
@@ -18,6 +19,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 using node::BlockAssembler;
 using node::BlockManager;
 using node::CBlockTemplate;
@@ -41,15 +44,18 @@ static bool CheckFilterLookups(BlockFilterIndex& filter_index, const CBlockIndex
     BlockFilter filter;
     uint256 filter_header;
     std::vector<BlockFilter> filters;
+    std::vector<BlockFilterRecord> records;
     std::vector<uint256> filter_hashes;
 
     BOOST_CHECK(filter_index.LookupFilter(block_index, filter));
     BOOST_CHECK(filter_index.LookupFilterHeader(block_index, filter_header));
     BOOST_CHECK(filter_index.LookupFilterRange(block_index->nHeight, block_index, filters));
+    BOOST_CHECK(filter_index.LookupFilterRecordRange(block_index->nHeight, block_index, records));
     BOOST_CHECK(filter_index.LookupFilterHashRange(block_index->nHeight, block_index,
                                                    filter_hashes));
 
     BOOST_CHECK_EQUAL(filters.size(), 1U);
+    BOOST_CHECK_EQUAL(records.size(), 1U);
     BOOST_CHECK_EQUAL(filter_hashes.size(), 1U);
 
     BOOST_CHECK_EQUAL(filter.GetHash(), expected_filter.GetHash());
@@ -57,6 +63,11 @@ static bool CheckFilterLookups(BlockFilterIndex& filter_index, const CBlockIndex
     BOOST_CHECK_EQUAL(filters[0].GetHash(), expected_filter.GetHash());
     BOOST_CHECK_EQUAL(filter_hashes[0], expected_filter.GetHash());
 
+    // A record is the serialized filter without the filter type.
+    DataStream expected_record;
+    expected_record << expected_filter;
+    BOOST_CHECK(std::ranges::equal(records[0].data, Span{expected_record}.subspan(1)));
+
     filters.clear();
     filter_hashes.clear();
     last_header = filter_header;
@@ -270,6 +281,26 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_outpoint_sync, TestChain100Setup)
+{
+    // The outpoint filter does not depend on undo data, so its index syncs
+    // without reading it.
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::OUTPOINT, 1 << 20, true);
+    BOOST_REQUIRE(filter_index.Init());
+    BOOST_REQUIRE(filter_index.StartBackgroundSync());
+    IndexWaitSynced(filter_index, *Assert(m_node.shutdown));
+
+    uint256 last_header;
+    LOCK(cs_main);
+    for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+         block_index != nullptr;
+         block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+        CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+    }
+
+    filter_index.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
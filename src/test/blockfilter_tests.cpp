@@ -8,10 +8,12 @@
 #include <blockfilter.h>
 #include <core_io.h>
 #include <primitives/block.h>
+#include <random.h>
 #include <serialize.h>
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -41,6 +43,41 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golomb_rice_reader)
+{
+    FastRandomContext ctx;
+    for (uint8_t P : {0, 1, 19, 56, 57, 63}) {
+        // Mix in a few values with long quotients.
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 200; ++i) {
+            const uint64_t q{i % 50 == 0 ? ctx.randrange(300) : ctx.randrange(4)};
+            values.push_back((q << P) + (P == 0 ? 0 : ctx.randbits(P)));
+        }
+
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (uint64_t value : values) {
+                GolombRiceEncode(bitwriter, P, value);
+            }
+        }
+
+        SpanReader stream{encoded};
+        BitStreamReader bitreader{stream};
+        GolombRiceReader reader{encoded};
+        for (uint64_t value : values) {
+            BOOST_CHECK_EQUAL(GolombRiceDecode(bitreader, P), value);
+            BOOST_CHECK_EQUAL(reader.Read(P), value);
+        }
+        BOOST_CHECK_EQUAL(reader.RemainingBytes(), stream.size());
+
+        // Running out of data in the middle of a value fails.
+        GolombRiceReader truncated{Span{encoded}.first(encoded.size() - 1)};
+        BOOST_CHECK_THROW(while (true) truncated.Read(P), std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
 {
     GCSFilter filter;
@@ -127,6 +164,53 @@ BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
     BOOST_CHECK(default_ctor_block_filter_1.GetEncodedFilter() == default_ctor_block_filter_2.GetEncodedFilter());
 }
 
+BOOST_AUTO_TEST_CASE(blockfilter_outpoint_test)
+{
+    const CScript p2wpkh{CScript() << OP_0 << std::vector<unsigned char>(20, 1)};
+    const std::vector<unsigned char> output_key(32, 2);
+    const CScript p2tr{CScript() << OP_1 << output_key};
+    const CScript op_return{CScript() << OP_RETURN << std::vector<unsigned char>(4, 40)};
+    const CScript spent_script{CScript() << OP_0 << std::vector<unsigned char>(20, 3)};
+    const COutPoint spent{Txid::FromUint256(uint256::ONE), 7};
+
+    CMutableTransaction coinbase;
+    coinbase.vin.emplace_back();
+    coinbase.vout.emplace_back(100, p2wpkh);
+
+    CMutableTransaction tx;
+    tx.vin.emplace_back(spent);
+    tx.vout.emplace_back(200, p2tr);
+    tx.vout.emplace_back(0, op_return);
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.vtx.push_back(MakeTransactionRef(tx));
+
+    CBlockUndo block_undo;
+    block_undo.vtxundo.emplace_back();
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(300, spent_script), 100, false);
+
+    BlockFilter block_filter(BlockFilterType::OUTPOINT, block, block_undo);
+    const GCSFilter& filter = block_filter.GetFilter();
+    BOOST_CHECK_EQUAL(filter.GetN(), 3U);
+
+    // Outputs are included, taproot ones by their output key only.
+    BOOST_CHECK(filter.Match(OutPointFilterElement(p2wpkh)));
+    BOOST_CHECK(filter.Match(OutPointFilterElement(p2tr)));
+    BOOST_CHECK(filter.Match(output_key));
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(p2tr.begin(), p2tr.end())));
+    BOOST_CHECK(!filter.Match(OutPointFilterElement(op_return)));
+
+    // Spends are included by outpoint, not by the script spent.
+    BOOST_CHECK(filter.Match(OutPointFilterElement(spent)));
+    BOOST_CHECK(!filter.Match(OutPointFilterElement(spent_script)));
+    BOOST_CHECK(!filter.Match(OutPointFilterElement(coinbase.vin[0].prevout)));
+
+    BlockFilter decoded(BlockFilterType::OUTPOINT, block.GetHash(), block_filter.GetEncodedFilter(), /*skip_decode_check=*/false);
+    BOOST_CHECK_EQUAL(decoded.GetFilter().GetParams().m_P, OUTPOINT_FILTER_P);
+    BOOST_CHECK(decoded.GetFilter().MatchAny({OutPointFilterElement(spent), OutPointFilterElement(spent_script)}));
+}
+
 BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 {
     UniValue json;
@@ -182,11 +266,14 @@ BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 BOOST_AUTO_TEST_CASE(blockfilter_type_names)
 {
     BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::OUTPOINT), "outpoint");
     BOOST_CHECK_EQUAL(BlockFilterTypeName(static_cast<BlockFilterType>(255)), "");
 
     BlockFilterType filter_type;
     BOOST_CHECK(BlockFilterTypeByName("basic", filter_type));
     BOOST_CHECK_EQUAL(filter_type, BlockFilterType::BASIC);
+    BOOST_CHECK(BlockFilterTypeByName("outpoint", filter_type));
+    BOOST_CHECK_EQUAL(filter_type, BlockFilterType::OUTPOINT);
 
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
@@ -3,12 +3,14 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chainparams.h>
+#include <common/args.h>
 #include <index/coinstatsindex.h>
 #include <interfaces/chain.h>
 #include <kernel/coinstats.h>
 #include <test/util/index.h>
 #include <test/util/setup_common.h>
 #include <test/util/validation.h>
+#include <util/string.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -76,6 +78,64 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
     coin_stats_index.Stop();
 }
 
+// Stats of blocks prepared out of order by the sync workers must add up to the
+// same UTXO set hash as a scan of the chainstate.
+BOOST_FIXTURE_TEST_CASE(coinstatsindex_parallel_sync, TestChain100Setup)
+{
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    for (int i = 0; i < 5; ++i) {
+        const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[i], /*input_vout=*/0, /*input_height=*/i + 1,
+                                                                      coinbaseKey, script_pub_key, /*output_amount=*/COIN, /*submit=*/false)};
+        CreateAndProcessBlock({spend}, script_pub_key);
+    }
+
+    CoinStatsIndex coin_stats_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(coin_stats_index.Init());
+    BOOST_REQUIRE(coin_stats_index.StartBackgroundSync());
+    IndexWaitSynced(coin_stats_index, *Assert(m_node.shutdown));
+    gArgs.ForceSetArg("-indexbatchsize", util::ToString(DEFAULT_INDEX_BATCH_SIZE));
+
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    const CBlockIndex* tip{WITH_LOCK(cs_main, chainstate.ForceFlushStateToDisk(); return chainstate.m_chain.Tip())};
+    const auto index_stats{coin_stats_index.LookUpStats(*tip)};
+    const auto utxo_stats{WITH_LOCK(cs_main, return kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, &chainstate.CoinsDB(), m_node.chainman->m_blockman))};
+    BOOST_REQUIRE(index_stats);
+    BOOST_REQUIRE(utxo_stats);
+    BOOST_CHECK_EQUAL(index_stats->hashSerialized, utxo_stats->hashSerialized);
+    BOOST_CHECK_EQUAL(index_stats->nTransactionOutputs, utxo_stats->nTransactionOutputs);
+    BOOST_CHECK_EQUAL(*index_stats->total_amount, *utxo_stats->total_amount);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    coin_stats_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(coinstatsindex_small_sync_batches, TestChain100Setup)
+{
+    // Flush after every block, so blocks are appended while the entries of
+    // the previous ones are still being written.
+    gArgs.ForceSetArg("-indexbatchsize", "0");
+
+    CoinStatsIndex coin_stats_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(coin_stats_index.Init());
+    BOOST_REQUIRE(coin_stats_index.StartBackgroundSync());
+    IndexWaitSynced(coin_stats_index, *Assert(m_node.shutdown));
+
+    Chainstate& chainstate{m_node.chainman->ActiveChainstate()};
+    const CBlockIndex* tip{WITH_LOCK(cs_main, chainstate.ForceFlushStateToDisk(); return chainstate.m_chain.Tip())};
+    for (const CBlockIndex* pindex{tip}; pindex; pindex = pindex->pprev) {
+        BOOST_CHECK(coin_stats_index.LookUpStats(*pindex));
+    }
+    const auto index_stats{coin_stats_index.LookUpStats(*tip)};
+    const auto utxo_stats{WITH_LOCK(cs_main, return kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, &chainstate.CoinsDB(), m_node.chainman->m_blockman))};
+    BOOST_REQUIRE(index_stats);
+    BOOST_REQUIRE(utxo_stats);
+    BOOST_CHECK_EQUAL(index_stats->hashSerialized, utxo_stats->hashSerialized);
+    BOOST_CHECK_EQUAL(coin_stats_index.GetSummary().best_block_height, tip->nHeight);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    coin_stats_index.Stop();
+}
+
 // Test shutdown between BlockConnected and ChainStateFlushed notifications,
 // make sure index is not corrupted and is able to reload.
 BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
@@ -114,6 +114,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "generate",
     "generateblock",
     "getaddednodeinfo",
+    "getaddresshistory",
     "getaddrmaninfo",
     "getbestblockhash",
     "getblock",
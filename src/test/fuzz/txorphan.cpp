@@ -139,6 +139,8 @@ FUZZ_TARGET(txorphan, .init = initialize_orphanage)
                 },
                 [&] {
                     orphanage.EraseForPeer(peer_id);
+                    Assert(orphanage.UsageByPeer(peer_id) == 0);
+                    Assert(!orphanage.HaveTxToReconsider(peer_id));
                 },
                 [&] {
                     // test mocktime and expiry
@@ -148,6 +150,9 @@ FUZZ_TARGET(txorphan, .init = initialize_orphanage)
                     Assert(orphanage.Size() <= limit);
                 });
 
+            // Every orphan is accounted to its peer, and nothing else is.
+            Assert((orphanage.Size() == 0) == (orphanage.TotalOrphanUsage() == 0));
+            Assert(orphanage.UsageByPeer(peer_id) <= orphanage.TotalOrphanUsage());
         }
         // Set tx as potential parent to be used for future GetChildren() calls.
         if (!ptx_potential_parent || fuzzed_data_provider.ConsumeBool()) {
@@ -146,6 +146,20 @@ BOOST_AUTO_TEST_CASE(siphash)
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between CSipHasher and SipHashBatch, for inputs of
+    // mixed lengths and a count that is not a multiple of the lane count.
+    std::vector<std::vector<unsigned char>> data;
+    for (int i = 0; i < 103; ++i) {
+        data.push_back(ctx.randbytes(ctx.randrange(70)));
+    }
+    const uint64_t k1 = ctx.rand64(), k2 = ctx.rand64();
+    std::vector<Span<const unsigned char>> inputs(data.begin(), data.end());
+    std::vector<uint64_t> hashes(inputs.size());
+    SipHashBatch(k1, k2, inputs, hashes);
+    for (size_t i = 0; i < data.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes[i], CSipHasher(k1, k2).Write(data[i]).Finalize());
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
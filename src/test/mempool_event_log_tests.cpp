@@ -0,0 +1,156 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <core_memusage.h>
+#include <kernel/mempool_entry.h>
+#include <node/mempool_event_log.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using node::MempoolEvent;
+using node::MempoolEventLog;
+
+static CTransactionRef MakeTx(uint32_t n)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout.n = n;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    tx.vout[0].nValue = COIN;
+    return MakeTransactionRef(tx);
+}
+
+BOOST_FIXTURE_TEST_SUITE(mempool_event_log_tests, ChainTestingSetup)
+
+BOOST_AUTO_TEST_CASE(mempool_event_log)
+{
+    ValidationSignals& signals{*m_node.validation_signals};
+    MempoolEventLog log{/*max_events=*/4, /*max_bytes=*/1'000'000};
+    signals.RegisterValidationInterface(&log);
+    // Positions are relative to the first cursor of this log.
+    const uint64_t first{log.NextSeq()};
+
+    std::vector<CTransactionRef> txs;
+    for (uint32_t i = 0; i < 3; ++i) {
+        txs.push_back(MakeTx(i));
+        const NewMempoolTransactionInfo tx_info{txs.back(), /*fee=*/1000 + i, /*vsize=*/100, /*height=*/1,
+                                                /*mempool_limit_bypassed=*/false,
+                                                /*submitted_in_package=*/false,
+                                                /*chainstate_is_current=*/true,
+                                                /*has_no_mempool_parents=*/true};
+        signals.TransactionAddedToMempool(tx_info, /*mempool_sequence=*/10 + i);
+    }
+    signals.TransactionRemovedFromMempool(txs[0], MemPoolRemovalReason::REPLACED, /*mempool_sequence=*/13);
+    signals.SyncWithValidationInterfaceQueue();
+
+    // All events are retained, start=0 reads from the oldest.
+    auto page{log.Read(/*start=*/0, /*max_count=*/10)};
+    BOOST_REQUIRE(page);
+    BOOST_REQUIRE_EQUAL(page->events.size(), 4U);
+    BOOST_CHECK_EQUAL(page->next_seq, first + 4);
+    BOOST_CHECK(page->events[1].type == MempoolEvent::Type::ADDED);
+    BOOST_CHECK_EQUAL(page->events[1].seq, first + 1);
+    BOOST_CHECK_EQUAL(page->events[1].mempool_sequence, 11U);
+    BOOST_CHECK_EQUAL(page->events[1].fee, 1001);
+    BOOST_CHECK(page->events[3].type == MempoolEvent::Type::REMOVED);
+    BOOST_CHECK(page->events[3].reason == MemPoolRemovalReason::REPLACED);
+    BOOST_CHECK_EQUAL(page->events[3].txid, txs[0]->GetHash());
+    BOOST_CHECK_EQUAL(page->events[3].wtxid, txs[0]->GetWitnessHash());
+    // Removed transactions are not kept alive by the log.
+    BOOST_CHECK(!page->events[3].tx);
+
+    // Paging resumes from the returned cursor.
+    page = log.Read(/*start=*/first + 1, /*max_count=*/2);
+    BOOST_REQUIRE(page);
+    BOOST_REQUIRE_EQUAL(page->events.size(), 2U);
+    BOOST_CHECK_EQUAL(page->events[0].seq, first + 1);
+    BOOST_CHECK_EQUAL(page->next_seq, first + 3);
+
+    // Caught up: no events and the cursor is unchanged.
+    page = log.Read(/*start=*/first + 4, /*max_count=*/10);
+    BOOST_REQUIRE(page);
+    BOOST_CHECK(page->events.empty());
+    BOOST_CHECK_EQUAL(page->next_seq, first + 4);
+
+    // Block removals push the first event out of the bounded log.
+    LockPoints lp;
+    const CTxMemPoolEntry entry{txs[1], /*fee=*/1001, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0,
+                                /*spends_coinbase=*/false, /*sigops_cost=*/4, lp};
+    signals.MempoolTransactionsRemovedForBlock({RemovedMempoolTransactionInfo{entry, /*mempool_sequence=*/13}}, /*nBlockHeight=*/2);
+    signals.SyncWithValidationInterfaceQueue();
+
+    BOOST_CHECK(!log.Read(/*start=*/first, /*max_count=*/10));
+    // A cursor ahead of the log is rejected as well.
+    BOOST_CHECK(!log.Read(/*start=*/first + 6, /*max_count=*/10));
+    page = log.Read(/*start=*/first + 4, /*max_count=*/10);
+    BOOST_REQUIRE(page);
+    BOOST_REQUIRE_EQUAL(page->events.size(), 1U);
+    BOOST_CHECK(page->events[0].reason == MemPoolRemovalReason::BLOCK);
+    BOOST_CHECK_EQUAL(page->events[0].mempool_sequence, 13U);
+
+    // Removals serialize as seq, type, mempool sequence, txid, wtxid and reason.
+    DataStream ss{};
+    ss << page->events[0];
+    BOOST_CHECK_EQUAL(ss.size(), 8U + 1U + 8U + 32U + 32U + 1U);
+
+    signals.UnregisterValidationInterface(&log);
+}
+
+BOOST_AUTO_TEST_CASE(mempool_event_log_epoch)
+{
+    // Cursors of another log, e.g. from before a restart, are rejected even
+    // if their position is in range.
+    MempoolEventLog log{/*max_events=*/10, /*max_bytes=*/1'000'000};
+    MempoolEventLog other{/*max_events=*/10, /*max_bytes=*/1'000'000};
+    BOOST_CHECK_NE(log.NextSeq(), other.NextSeq());
+    BOOST_CHECK(log.Read(/*start=*/log.NextSeq(), /*max_count=*/10));
+    BOOST_CHECK(!log.Read(/*start=*/other.NextSeq(), /*max_count=*/10));
+    BOOST_CHECK(!log.Read(/*start=*/1, /*max_count=*/10));
+}
+
+BOOST_AUTO_TEST_CASE(mempool_event_log_memory)
+{
+    ValidationSignals& signals{*m_node.validation_signals};
+    // Only room for about two added transactions.
+    const size_t tx_usage{sizeof(MempoolEvent) + RecursiveDynamicUsage(MakeTx(0))};
+    MempoolEventLog log{/*max_events=*/100, /*max_bytes=*/2 * tx_usage + tx_usage / 2};
+    signals.RegisterValidationInterface(&log);
+    const uint64_t first{log.NextSeq()};
+
+    for (uint32_t i = 0; i < 4; ++i) {
+        const NewMempoolTransactionInfo tx_info{MakeTx(i), /*fee=*/1000, /*vsize=*/100, /*height=*/1,
+                                                /*mempool_limit_bypassed=*/false,
+                                                /*submitted_in_package=*/false,
+                                                /*chainstate_is_current=*/true,
+                                                /*has_no_mempool_parents=*/true};
+        signals.TransactionAddedToMempool(tx_info, /*mempool_sequence=*/i);
+    }
+    signals.SyncWithValidationInterfaceQueue();
+
+    BOOST_CHECK(!log.Read(/*start=*/first + 1, /*max_count=*/10));
+    auto page{log.Read(/*start=*/0, /*max_count=*/10)};
+    BOOST_REQUIRE(page);
+    BOOST_REQUIRE_EQUAL(page->events.size(), 2U);
+    BOOST_CHECK_EQUAL(page->events[0].seq, first + 2);
+
+    // Removals are much smaller, so more of them fit.
+    for (uint32_t i = 0; i < 4; ++i) {
+        signals.TransactionRemovedFromMempool(MakeTx(i), MemPoolRemovalReason::EXPIRY, /*mempool_sequence=*/4 + i);
+    }
+    signals.SyncWithValidationInterfaceQueue();
+    page = log.Read(/*start=*/0, /*max_count=*/10);
+    BOOST_REQUIRE(page);
+    BOOST_CHECK_GT(page->events.size(), 4U);
+
+    signals.UnregisterValidationInterface(&log);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <common/system.h>
 #include <policy/policy.h>
+#include <test/util/random.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
 #include <util/time.h>
@@ -484,6 +485,11 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     CFeeRate maxFeeRateRemoved(25000, GetVirtualTransactionSize(CTransaction(tx3)) + GetVirtualTransactionSize(CTransaction(tx2)));
     BOOST_CHECK_EQUAL(pool.GetMinFee(1).GetFeePerK(), maxFeeRateRemoved.GetFeePerK() + 1000);
 
+    const MempoolEvictionStats eviction_stats{pool.GetEvictionStats()};
+    BOOST_CHECK_EQUAL(eviction_stats.trim_runs, 3U);
+    BOOST_CHECK_EQUAL(eviction_stats.packages, 3U);
+    BOOST_CHECK_EQUAL(eviction_stats.txs, 4U);
+
     CMutableTransaction tx4 = CMutableTransaction();
     tx4.vin.resize(2);
     tx4.vin[0].prevout.SetNull();
@@ -600,6 +606,47 @@ inline CTransactionRef make_tx(std::vector<CAmount>&& output_values, std::vector
 }
 
 
+BOOST_AUTO_TEST_CASE(MempoolSizeLimitBatchTest)
+{
+    auto& pool = static_cast<MemPoolTest&>(*Assert(m_node.mempool));
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    // Independent transactions, sorted by increasing feerate
+    std::vector<CMutableTransaction> txs;
+    for (int i = 0; i < 20; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(Txid::FromUint256(InsecureRand256()), 0);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+        pool.addUnchecked(entry.Fee(1000LL * (i + 1)).FromTx(tx));
+        txs.push_back(tx);
+    }
+
+    const size_t size_limit{pool.DynamicMemoryUsage() / 2};
+    std::vector<COutPoint> no_spends_remaining;
+    pool.TrimToSize(size_limit, &no_spends_remaining);
+    BOOST_CHECK_LE(pool.DynamicMemoryUsage(), size_limit);
+    BOOST_CHECK(pool.size() > 0 && pool.size() < txs.size());
+
+    // Exactly the lowest feerate transactions were evicted
+    const size_t evicted{txs.size() - pool.size()};
+    for (size_t i = 0; i < txs.size(); ++i) {
+        BOOST_CHECK_EQUAL(pool.exists(GenTxid::Txid(txs[i].GetHash())), i >= evicted);
+    }
+    BOOST_CHECK_EQUAL(no_spends_remaining.size(), evicted);
+
+    // Packages without in-mempool ancestors are evicted together
+    const MempoolEvictionStats eviction_stats{pool.GetEvictionStats()};
+    BOOST_CHECK_EQUAL(eviction_stats.trim_runs, 1U);
+    BOOST_CHECK_EQUAL(eviction_stats.packages, evicted);
+    BOOST_CHECK_EQUAL(eviction_stats.txs, evicted);
+    BOOST_CHECK_LT(eviction_stats.batches, evicted);
+}
+
 BOOST_AUTO_TEST_CASE(MempoolAncestryTests)
 {
     size_t ancestors, descendants;
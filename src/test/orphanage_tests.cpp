@@ -334,4 +334,53 @@ BOOST_AUTO_TEST_CASE(get_children)
     }
 }
 
+BOOST_AUTO_TEST_CASE(peer_usage_and_work_set)
+{
+    FastRandomContext det_rand{true};
+    TxOrphanage orphanage;
+    const NodeId node0{0};
+    const NodeId node1{1};
+
+    const auto parent{MakeTransactionSpending({}, det_rand)};
+    const auto child0{MakeTransactionSpending({{parent->GetHash(), 0}}, det_rand)};
+    const auto child1{MakeTransactionSpending({{parent->GetHash(), 1}}, det_rand)};
+    const auto unrelated{MakeTransactionSpending({}, det_rand)};
+
+    BOOST_CHECK(orphanage.AddTx(child0, node0));
+    BOOST_CHECK(orphanage.AddTx(unrelated, node0));
+    BOOST_CHECK(orphanage.AddTx(child1, node1));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(node0), child0->GetTotalSize() + unrelated->GetTotalSize());
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(node1), child1->GetTotalSize());
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), orphanage.UsageByPeer(node0) + orphanage.UsageByPeer(node1));
+
+    // Both children end up in the work set of the peer that provided them.
+    orphanage.AddChildrenToWorkSet(*parent);
+    BOOST_CHECK(orphanage.HaveTxToReconsider(node0));
+    BOOST_CHECK(orphanage.HaveTxToReconsider(node1));
+
+    // Erasing an orphan also removes it from its peer's work set.
+    BOOST_CHECK_EQUAL(orphanage.EraseTx(child1->GetWitnessHash()), 1);
+    BOOST_CHECK(!orphanage.HaveTxToReconsider(node1));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(node1), 0U);
+    BOOST_CHECK(orphanage.GetTxToReconsider(node1) == nullptr);
+
+    BOOST_CHECK(orphanage.GetTxToReconsider(node0) == child0);
+    BOOST_CHECK(!orphanage.HaveTxToReconsider(node0));
+
+    // Disconnecting a peer only erases its own orphans.
+    BOOST_CHECK(orphanage.AddTx(child1, node1));
+    orphanage.EraseForPeer(node0);
+    BOOST_CHECK_EQUAL(orphanage.Size(), 1U);
+    BOOST_CHECK(orphanage.HaveTx(child1->GetWitnessHash()));
+    BOOST_CHECK_EQUAL(orphanage.UsageByPeer(node0), 0U);
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), child1->GetTotalSize());
+
+    // Blocks spending the same outpoint evict the orphan.
+    CBlock block;
+    block.vtx.push_back(MakeTransactionSpending({{parent->GetHash(), 1}}, det_rand));
+    orphanage.EraseForBlock(block);
+    BOOST_CHECK_EQUAL(orphanage.Size(), 0U);
+    BOOST_CHECK_EQUAL(orphanage.TotalOrphanUsage(), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
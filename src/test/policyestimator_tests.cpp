@@ -264,4 +264,30 @@ BOOST_AUTO_TEST_CASE(BlockPolicyEstimates)
     }
 }
 
+BOOST_AUTO_TEST_CASE(QueuedMempoolEvents)
+{
+    CBlockPolicyEstimator& feeEst = *Assert(m_node.fee_estimator);
+
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 0;
+    const CTransactionRef ptx{MakeTransactionRef(tx)};
+    const NewMempoolTransactionInfo tx_info{ptx, /*fee=*/10000, GetVirtualTransactionSize(*ptx), /*height=*/0,
+                                            /*mempool_limit_bypassed=*/false,
+                                            /*submitted_in_package=*/false,
+                                            /*chainstate_is_current=*/true,
+                                            /*has_no_mempool_parents=*/true};
+
+    // Additions are only queued, but are applied before a removal is processed
+    feeEst.processTransaction(tx_info);
+    BOOST_CHECK(feeEst.removeTx(ptx->GetHash()));
+    BOOST_CHECK(!feeEst.removeTx(ptx->GetHash()));
+
+    // Queued additions are applied in order when the next block is processed
+    feeEst.processTransaction(tx_info);
+    feeEst.processBlock({}, 1);
+    BOOST_CHECK(feeEst.removeTx(ptx->GetHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/validation.h>
+#include <index/spenderindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(spenderindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(spenderindex_find_spender, TestChain100Setup)
+{
+    SpenderIndex spender_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(spender_index.Init());
+    BOOST_REQUIRE(spender_index.StartBackgroundSync());
+    IndexWaitSynced(spender_index, *Assert(m_node.shutdown));
+
+    // None of the coinbase outputs of the test chain are spent.
+    const COutPoint prevout{m_coinbase_txns[0]->GetHash(), 0};
+    BOOST_CHECK(!spender_index.FindSpender(prevout));
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, coinbase_script, /*output_amount=*/COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_CHECK(spender_index.BlockUntilSyncedToCurrentChain());
+
+    const auto spender{spender_index.FindSpender(prevout)};
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, spend.GetHash().ToUint256());
+    BOOST_CHECK_EQUAL(spender->vin, 0U);
+    BOOST_CHECK_EQUAL(spender->height, 101);
+    BOOST_CHECK(!spender_index.FindSpender(COutPoint{spend.GetHash(), 0}));
+
+    // Replacing the block in a reorg leaves the output unspent again.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(spender_index.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(!spender_index.FindSpender(prevout));
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    spender_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -94,6 +94,7 @@ constexpr ServiceFlags ALL_SERVICE_FLAGS[]{
     NODE_COMPACT_FILTERS,
     NODE_NETWORK_LIMITED,
     NODE_P2P_V2,
+    NODE_OUTPOINT_FILTERS,
 };
 
 constexpr NetPermissionFlags ALL_NET_PERMISSION_FLAGS[]{
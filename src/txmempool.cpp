@@ -640,7 +640,8 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
         if (it != mapTx.end()) {
             setEntries stage;
             stage.insert(it);
-            txs_removed_for_block.emplace_back(*it);
+            // The removal below takes the current mempool sequence number.
+            txs_removed_for_block.emplace_back(*it, GetSequence());
             RemoveStaged(stage, true, MemPoolRemovalReason::BLOCK);
         }
         removeConflicts(*tx);
@@ -1128,34 +1129,61 @@ void CTxMemPool::trackPackageRemoved(const CFeeRate& rate) {
 void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpendsRemaining) {
     AssertLockHeld(cs);
 
+    const auto time_start{SteadyClock::now()};
+    // Exact per-entry usage of mapTx and cachedInnerUsage. Memory held by links,
+    // mapNextTx and txns_randomized is only ever released as well, so summing this
+    // over staged entries gives a lower bound on what removing them frees.
+    const size_t entry_overhead{memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*))};
+
     unsigned nTxnRemoved = 0;
     CFeeRate maxFeeRateRemoved(0);
     while (!mapTx.empty() && DynamicMemoryUsage() > sizelimit) {
-        indexed_transaction_set::index<descendant_score>::type::iterator it = mapTx.get<descendant_score>().begin();
-
-        // We set the new mempool min fee to the feerate of the removed set, plus the
-        // "minimum reasonable fee rate" (ie some value under which we consider txn
-        // to have 0 fee). This way, we don't allow txn to enter mempool with feerate
-        // equal to txn which were removed with no block in between.
-        CFeeRate removed(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants());
-        removed += m_opts.incremental_relay_feerate;
-        trackPackageRemoved(removed);
-        maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
-
+        const size_t usage{DynamicMemoryUsage()};
+        size_t released{0};
         setEntries stage;
-        CalculateDescendants(mapTx.project<0>(it), stage);
-        nTxnRemoved += stage.size();
-
-        std::vector<CTransaction> txn;
-        if (pvNoSpendsRemaining) {
-            txn.reserve(stage.size());
-            for (txiter iter : stage)
-                txn.push_back(iter->GetTx());
+        std::vector<CTransactionRef> txn;
+        const auto& by_score{mapTx.get<descendant_score>()};
+        for (auto it = by_score.begin(); it != by_score.end() && released < usage && usage - released > sizelimit; ++it) {
+            const txiter root{mapTx.project<0>(it)};
+            if (stage.count(root)) continue;
+
+            // We set the new mempool min fee to the feerate of the removed set, plus the
+            // "minimum reasonable fee rate" (ie some value under which we consider txn
+            // to have 0 fee). This way, we don't allow txn to enter mempool with feerate
+            // equal to txn which were removed with no block in between.
+            CFeeRate removed(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants());
+            removed += m_opts.incremental_relay_feerate;
+            trackPackageRemoved(removed);
+            maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
+
+            setEntries package;
+            CalculateDescendants(root, package);
+            bool has_outside_ancestors{false};
+            for (txiter pit : package) {
+                for (const CTxMemPoolEntry& parent : pit->GetMemPoolParentsConst()) {
+                    if (package.count(mapTx.iterator_to(parent)) == 0) has_outside_ancestors = true;
+                }
+                released += entry_overhead + pit->DynamicMemoryUsage();
+                m_eviction_stats.vbytes += pit->GetTxSize();
+                if (pvNoSpendsRemaining) txn.push_back(pit->GetSharedTx());
+            }
+            stage.insert(package.begin(), package.end());
+            ++m_eviction_stats.packages;
+
+            // Removing a package that has in-mempool ancestors changes their descendant
+            // scores, so the next package has to be picked after this batch is removed.
+            // Otherwise the order of the remaining entries is unaffected and we keep
+            // staging packages while the lower bound says we are still over the limit.
+            if (has_outside_ancestors) break;
         }
+        nTxnRemoved += stage.size();
+        m_eviction_stats.txs += stage.size();
+        ++m_eviction_stats.batches;
         RemoveStaged(stage, false, MemPoolRemovalReason::SIZELIMIT);
+
         if (pvNoSpendsRemaining) {
-            for (const CTransaction& tx : txn) {
-                for (const CTxIn& txin : tx.vin) {
+            for (const CTransactionRef& tx : txn) {
+                for (const CTxIn& txin : tx->vin) {
                     if (exists(GenTxid::Txid(txin.prevout.hash))) continue;
                     pvNoSpendsRemaining->push_back(txin.prevout);
                 }
@@ -1163,6 +1191,11 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
         }
     }
 
+    if (nTxnRemoved > 0) {
+        ++m_eviction_stats.trim_runs;
+        m_eviction_stats.time += std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - time_start);
+    }
+
     if (maxFeeRateRemoved > CFeeRate(0)) {
         LogPrint(BCLog::MEMPOOL, "Removed %u txn, rolling minimum fee bumped to %s\n", nTxnRemoved, maxFeeRateRemoved.ToString());
     }
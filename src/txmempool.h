@@ -32,6 +32,7 @@
 #include <boost/multi_index_container.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <optional>
 #include <set>
@@ -206,6 +207,25 @@ struct entry_time {};
 struct ancestor_score {};
 struct index_by_wtxid {};
 
+/**
+ * Cumulative statistics about the work done by CTxMemPool::TrimToSize().
+ */
+struct MempoolEvictionStats
+{
+    /** Number of TrimToSize() calls that evicted at least one transaction */
+    uint64_t trim_runs{0};
+    /** Number of RemoveStaged() batches used to evict transactions */
+    uint64_t batches{0};
+    /** Number of packages (lowest descendant score entry plus descendants) evicted */
+    uint64_t packages{0};
+    /** Number of transactions evicted */
+    uint64_t txs{0};
+    /** Sum of the virtual sizes of all evicted transactions */
+    uint64_t vbytes{0};
+    /** Total time spent evicting transactions */
+    std::chrono::microseconds time{0};
+};
+
 /**
  * Information about a mempool transaction.
  */
@@ -323,6 +343,8 @@ protected:
 
     bool m_load_tried GUARDED_BY(cs){false};
 
+    MempoolEvictionStats m_eviction_stats GUARDED_BY(cs);
+
     CFeeRate GetMinFee(size_t sizelimit) const;
 
 public:
@@ -619,9 +641,20 @@ public:
     /** Remove transactions from the mempool until its dynamic size is <= sizelimit.
       *  pvNoSpendsRemaining, if set, will be populated with the list of outpoints
       *  which are not in mempool which no longer have any spends in this mempool.
+      *
+      *  Packages are evicted in descendant score order. Consecutive packages whose
+      *  removal cannot change the descendant score of any remaining entry are
+      *  staged together and removed with a single RemoveStaged() call.
       */
     void TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpendsRemaining = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    /** Cumulative eviction work done by TrimToSize() since startup. */
+    MempoolEvictionStats GetEvictionStats() const
+    {
+        LOCK(cs);
+        return m_eviction_stats;
+    }
+
     /** Expire all transaction (and their dependencies) in the mempool older than time. Return the number of removed transactions. */
     int Expire(std::chrono::seconds time) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -8,6 +8,7 @@
 #include <logging.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <util/check.h>
 #include <util/time.h>
 
 #include <cassert>
@@ -41,15 +42,21 @@ bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
         return false;
     }
 
-    auto ret = m_orphans.emplace(wtxid, OrphanTx{tx, peer, Now<NodeSeconds>() + ORPHAN_TX_EXPIRE_TIME, m_orphan_list.size()});
+    const size_t usage{tx->GetTotalSize()};
+    auto ret = m_orphans.emplace(wtxid, OrphanTx{tx, peer, Now<NodeSeconds>() + ORPHAN_TX_EXPIRE_TIME, m_orphan_list.size(), usage});
     assert(ret.second);
     m_orphan_list.push_back(ret.first);
     for (const CTxIn& txin : tx->vin) {
         m_outpoint_to_orphan_it[txin.prevout].insert(ret.first);
     }
-
-    LogPrint(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u outsz %u)\n", hash.ToString(), wtxid.ToString(), sz,
-             m_orphans.size(), m_outpoint_to_orphan_it.size());
+    PeerOrphanInfo& peer_info = m_peer_orphanage_info[peer];
+    peer_info.m_orphans.insert(wtxid);
+    peer_info.m_total_usage += usage;
+    m_total_orphan_usage += usage;
+
+    LogPrint(BCLog::TXPACKAGES, "stored orphan tx %s (wtxid=%s), weight: %u (mapsz %u outsz %u, peer=%d usage %u total usage %u)\n",
+             hash.ToString(), wtxid.ToString(), sz, m_orphans.size(), m_outpoint_to_orphan_it.size(),
+             peer, peer_info.m_total_usage, m_total_orphan_usage);
     return true;
 }
 
@@ -75,6 +82,18 @@ int TxOrphanage::EraseTxNoLock(const Wtxid& wtxid)
             m_outpoint_to_orphan_it.erase(itPrev);
     }
 
+    const auto peer_it = m_peer_orphanage_info.find(it->second.fromPeer);
+    if (Assume(peer_it != m_peer_orphanage_info.end())) {
+        PeerOrphanInfo& peer_info = peer_it->second;
+        peer_info.m_orphans.erase(wtxid);
+        peer_info.m_work_set.erase(wtxid);
+        Assume(peer_info.m_total_usage >= it->second.usage);
+        peer_info.m_total_usage -= it->second.usage;
+        if (peer_info.m_orphans.empty()) m_peer_orphanage_info.erase(peer_it);
+    }
+    Assume(m_total_orphan_usage >= it->second.usage);
+    m_total_orphan_usage -= it->second.usage;
+
     size_t old_pos = it->second.list_pos;
     assert(m_orphan_list[old_pos] == it);
     if (old_pos + 1 != m_orphan_list.size()) {
@@ -99,18 +118,16 @@ void TxOrphanage::EraseForPeer(NodeId peer)
 {
     LOCK(m_mutex);
 
-    m_peer_work_set.erase(peer);
+    const auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it == m_peer_orphanage_info.end()) return;
 
+    // Copy the peer's orphans, as erasing the last one also erases the peer's entry.
+    const std::vector<Wtxid> peer_orphans(peer_it->second.m_orphans.begin(), peer_it->second.m_orphans.end());
     int nErased = 0;
-    std::map<Wtxid, OrphanTx>::iterator iter = m_orphans.begin();
-    while (iter != m_orphans.end())
-    {
-        // increment to avoid iterator becoming invalid after erasure
-        const auto& [wtxid, orphan] = *iter++;
-        if (orphan.fromPeer == peer) {
-            nErased += EraseTxNoLock(wtxid);
-        }
+    for (const Wtxid& wtxid : peer_orphans) {
+        nErased += EraseTxNoLock(wtxid);
     }
+    Assume(!m_peer_orphanage_info.contains(peer));
     if (nErased > 0) LogPrint(BCLog::TXPACKAGES, "Erased %d orphan transaction(s) from peer=%d\n", nErased, peer);
 }
 
@@ -152,21 +169,17 @@ void TxOrphanage::AddChildrenToWorkSet(const CTransaction& tx)
 {
     LOCK(m_mutex);
 
-
-    for (unsigned int i = 0; i < tx.vout.size(); i++) {
-        const auto it_by_prev = m_outpoint_to_orphan_it.find(COutPoint(tx.GetHash(), i));
-        if (it_by_prev != m_outpoint_to_orphan_it.end()) {
-            for (const auto& elem : it_by_prev->second) {
-                // Get this source peer's work set, emplacing an empty set if it didn't exist
-                // (note: if this peer wasn't still connected, we would have removed the orphan tx already)
-                std::set<Wtxid>& orphan_work_set = m_peer_work_set.try_emplace(elem->second.fromPeer).first->second;
-                // Add this tx to the work set
-                orphan_work_set.insert(elem->first);
-                LogPrint(BCLog::TXPACKAGES, "added %s (wtxid=%s) to peer %d workset\n",
-                         tx.GetHash().ToString(), tx.GetWitnessHash().ToString(), elem->second.fromPeer);
-            }
+    ForEachSpendOf(tx.GetHash(), [&](const auto& orphans) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        for (const auto& elem : orphans) {
+            // The source peer's entry exists for as long as it has orphans
+            // (note: if this peer wasn't still connected, we would have removed the orphan tx already)
+            std::set<Wtxid>& orphan_work_set = m_peer_orphanage_info.at(elem->second.fromPeer).m_work_set;
+            // Add this tx to the work set
+            orphan_work_set.insert(elem->first);
+            LogPrint(BCLog::TXPACKAGES, "added %s (wtxid=%s) to peer %d workset\n",
+                     elem->second.tx->GetHash().ToString(), elem->first.ToString(), elem->second.fromPeer);
         }
-    }
+    });
 }
 
 bool TxOrphanage::HaveTx(const Wtxid& wtxid) const
@@ -179,15 +192,14 @@ CTransactionRef TxOrphanage::GetTxToReconsider(NodeId peer)
 {
     LOCK(m_mutex);
 
-    auto work_set_it = m_peer_work_set.find(peer);
-    if (work_set_it != m_peer_work_set.end()) {
-        auto& work_set = work_set_it->second;
-        while (!work_set.empty()) {
-            Wtxid wtxid = *work_set.begin();
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it != m_peer_orphanage_info.end()) {
+        auto& work_set = peer_it->second.m_work_set;
+        if (!work_set.empty()) {
+            // Work sets only contain orphans that are still in the orphanage.
+            const auto orphan_it = m_orphans.find(*work_set.begin());
             work_set.erase(work_set.begin());
-
-            const auto orphan_it = m_orphans.find(wtxid);
-            if (orphan_it != m_orphans.end()) {
+            if (Assume(orphan_it != m_orphans.end())) {
                 return orphan_it->second.tx;
             }
         }
@@ -199,18 +211,33 @@ bool TxOrphanage::HaveTxToReconsider(NodeId peer)
 {
     LOCK(m_mutex);
 
-    auto work_set_it = m_peer_work_set.find(peer);
-    if (work_set_it != m_peer_work_set.end()) {
-        auto& work_set = work_set_it->second;
-        return !work_set.empty();
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    if (peer_it != m_peer_orphanage_info.end()) {
+        return !peer_it->second.m_work_set.empty();
     }
     return false;
 }
 
+size_t TxOrphanage::TotalOrphanUsage() const
+{
+    LOCK(m_mutex);
+    return m_total_orphan_usage;
+}
+
+size_t TxOrphanage::UsageByPeer(NodeId peer) const
+{
+    LOCK(m_mutex);
+    auto peer_it = m_peer_orphanage_info.find(peer);
+    return peer_it == m_peer_orphanage_info.end() ? 0 : peer_it->second.m_total_usage;
+}
+
 void TxOrphanage::EraseForBlock(const CBlock& block)
 {
     LOCK(m_mutex);
 
+    // Nothing can be included in or conflicted by the block.
+    if (m_orphans.empty()) return;
+
     std::vector<Wtxid> vOrphanErase;
 
     for (const CTransactionRef& ptx : block.vtx) {
@@ -246,16 +273,13 @@ std::vector<CTransactionRef> TxOrphanage::GetChildrenFromSamePeer(const CTransac
     std::vector<OrphanMap::iterator> iters;
 
     // For each output, get all entries spending this prevout, filtering for ones from the specified peer.
-    for (unsigned int i = 0; i < parent->vout.size(); i++) {
-        const auto it_by_prev = m_outpoint_to_orphan_it.find(COutPoint(parent->GetHash(), i));
-        if (it_by_prev != m_outpoint_to_orphan_it.end()) {
-            for (const auto& elem : it_by_prev->second) {
-                if (elem->second.fromPeer == nodeid) {
-                    iters.emplace_back(elem);
-                }
+    ForEachSpendOf(parent->GetHash(), [&](const auto& orphans) {
+        for (const auto& elem : orphans) {
+            if (elem->second.fromPeer == nodeid) {
+                iters.emplace_back(elem);
             }
         }
-    }
+    });
 
     // Sort by address so that duplicates can be deleted. At the same time, sort so that more recent
     // orphans (which expire later) come first.  Break ties based on address, as nTimeExpire is
@@ -287,16 +311,13 @@ std::vector<std::pair<CTransactionRef, NodeId>> TxOrphanage::GetChildrenFromDiff
     std::vector<OrphanMap::iterator> iters;
 
     // For each output, get all entries spending this prevout, filtering for ones not from the specified peer.
-    for (unsigned int i = 0; i < parent->vout.size(); i++) {
-        const auto it_by_prev = m_outpoint_to_orphan_it.find(COutPoint(parent->GetHash(), i));
-        if (it_by_prev != m_outpoint_to_orphan_it.end()) {
-            for (const auto& elem : it_by_prev->second) {
-                if (elem->second.fromPeer != nodeid) {
-                    iters.emplace_back(elem);
-                }
+    ForEachSpendOf(parent->GetHash(), [&](const auto& orphans) {
+        for (const auto& elem : orphans) {
+            if (elem->second.fromPeer != nodeid) {
+                iters.emplace_back(elem);
             }
         }
-    }
+    });
 
     // Erase duplicates
     std::sort(iters.begin(), iters.end(), IteratorComparator());
@@ -47,10 +47,10 @@ public:
     void LimitOrphans(unsigned int max_orphans, FastRandomContext& rng) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
 
     /** Add any orphans that list a particular tx as a parent into the from peer's work set */
-    void AddChildrenToWorkSet(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);;
+    void AddChildrenToWorkSet(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
 
     /** Does this peer have any work to do? */
-    bool HaveTxToReconsider(NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);;
+    bool HaveTxToReconsider(NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
 
     /** Get all children that spend from this tx and were received from nodeid. Sorted from most
      * recent to least recent. */
@@ -67,6 +67,12 @@ public:
         return m_orphans.size();
     }
 
+    /** Total serialized size of all orphans, in bytes */
+    size_t TotalOrphanUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Total serialized size of the orphans provided by this peer, in bytes */
+    size_t UsageByPeer(NodeId peer) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
 protected:
     /** Guards orphan transactions */
     mutable Mutex m_mutex;
@@ -76,14 +82,28 @@ protected:
         NodeId fromPeer;
         NodeSeconds nTimeExpire;
         size_t list_pos;
+        /** Serialized size of tx, accounted to fromPeer */
+        size_t usage;
     };
 
     /** Map from wtxid to orphan transaction record. Limited by
      *  -maxorphantx/DEFAULT_MAX_ORPHAN_TRANSACTIONS */
     std::map<Wtxid, OrphanTx> m_orphans GUARDED_BY(m_mutex);
 
-    /** Which peer provided the orphans that need to be reconsidered */
-    std::map<NodeId, std::set<Wtxid>> m_peer_work_set GUARDED_BY(m_mutex);
+    struct PeerOrphanInfo {
+        /** Orphans provided by this peer, so they can be erased without scanning m_orphans */
+        std::set<Wtxid> m_orphans;
+        /** Orphans provided by this peer that need to be reconsidered */
+        std::set<Wtxid> m_work_set;
+        /** Total serialized size of m_orphans, in bytes */
+        size_t m_total_usage{0};
+    };
+
+    /** Per-peer index of orphans and their work sets. An entry exists as long as the peer has orphans. */
+    std::map<NodeId, PeerOrphanInfo> m_peer_orphanage_info GUARDED_BY(m_mutex);
+
+    /** Total serialized size of all orphans, in bytes */
+    size_t m_total_orphan_usage GUARDED_BY(m_mutex){0};
 
     using OrphanMap = decltype(m_orphans);
 
@@ -106,6 +126,19 @@ protected:
     /** Erase an orphan by wtxid */
     int EraseTxNoLock(const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
 
+    /** Call fn for every (outpoint, orphan set) entry spending an output of parent.
+     *  Outpoints are ordered by txid first, so this is a single seek into
+     *  m_outpoint_to_orphan_it instead of one lookup per parent output. */
+    template <typename Fn>
+    void ForEachSpendOf(const Txid& parent, Fn&& fn) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+    {
+        AssertLockHeld(m_mutex);
+        for (auto it = m_outpoint_to_orphan_it.lower_bound(COutPoint{parent, 0});
+             it != m_outpoint_to_orphan_it.end() && it->first.hash == parent; ++it) {
+            fn(it->second);
+        }
+    }
+
     /** Timestamp for the next scheduled sweep of expired orphans */
     NodeSeconds m_next_sweep GUARDED_BY(m_mutex){0s};
 };
@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -30,6 +31,10 @@ public:
 
     UniValue() { typ = VNULL; }
     UniValue(UniValue::VType type, std::string str = {}) : typ{type}, val{std::move(str)} {}
+    UniValue(const UniValue& other);
+    UniValue(UniValue&& other) noexcept = default;
+    UniValue& operator=(const UniValue& other);
+    UniValue& operator=(UniValue&& other) noexcept = default;
     template <typename Ref, typename T = std::remove_cv_t<std::remove_reference_t<Ref>>,
               std::enable_if_t<std::is_floating_point_v<T> ||                      // setFloat
                                    std::is_same_v<bool, T> ||                      // setBool
@@ -104,9 +109,16 @@ private:
     std::string val;                       // numbers are stored as C++ strings
     std::vector<std::string> keys;
     std::vector<UniValue> values;
+    /** Open addressing hash table of the positions (plus one) of the keys of
+     * large objects, so looking up a key does not need to compare it with
+     * every other key. Only the first of duplicate keys is included. */
+    std::unique_ptr<std::vector<uint32_t>> keyIndex;
 
     void checkType(const VType& expected) const;
-    bool findKey(const std::string& key, size_t& retIdx) const;
+    bool findKey(std::string_view key, size_t& retIdx) const;
+    void pushKey(std::string key);
+    void indexKey(size_t idx);
+    void writeValue(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
     void writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
 
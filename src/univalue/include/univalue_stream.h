@@ -0,0 +1,70 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef BGL_UNIVALUE_INCLUDE_UNIVALUE_STREAM_H
+#define BGL_UNIVALUE_INCLUDE_UNIVALUE_STREAM_H
+
+#include <univalue.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Writes a JSON document piece by piece, in the compact format of
+ * UniValue::write(), handing it to a sink in chunks of about flush_size
+ * bytes. This allows large documents to be sent without building them as a
+ * UniValue or as a single string first.
+ *
+ * Commas are inserted automatically. Misuse, such as closing an array as an
+ * object or writing a value in an object without a key, throws
+ * std::runtime_error.
+ */
+class UniValueStreamWriter {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    static constexpr size_t DEFAULT_FLUSH_SIZE{64 << 10};
+
+    explicit UniValueStreamWriter(Sink sink, size_t flush_size = DEFAULT_FLUSH_SIZE);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /** Write the key of the next value of the current object. */
+    void key(std::string_view key);
+    /** Write a complete value. */
+    void value(const UniValue& val);
+    void pushKV(std::string_view key, const UniValue& val)
+    {
+        this->key(key);
+        value(val);
+    }
+
+    /** Hand everything written so far to the sink. */
+    void flush();
+
+    /** Number of bytes written so far, including those not flushed yet. */
+    size_t size() const { return flushed + buf.size(); }
+
+private:
+    Sink sink;
+    size_t flush_size;
+    std::string buf;
+    size_t flushed{0};
+    /** The open objects (VOBJ) and arrays (VARR), with whether they have a
+     * first element yet. */
+    std::vector<std::pair<UniValue::VType, bool>> open;
+    bool after_key{false};
+
+    void beginValue();
+    void endValue();
+};
+
+#endif // BGL_UNIVALUE_INCLUDE_UNIVALUE_STREAM_H
@@ -5,22 +5,41 @@
 
 #include <univalue.h>
 
+#include <charconv>
+#include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 const UniValue NullUniValue;
 
+/** Objects with fewer keys are searched linearly, which is faster than hashing. */
+static constexpr size_t KEY_INDEX_MIN_SIZE{32};
+
+UniValue::UniValue(const UniValue& other)
+    : typ{other.typ}, val{other.val}, keys{other.keys}, values{other.values},
+      keyIndex{other.keyIndex ? std::make_unique<std::vector<uint32_t>>(*other.keyIndex) : nullptr}
+{
+}
+
+UniValue& UniValue::operator=(const UniValue& other)
+{
+    return *this = UniValue{other};
+}
+
 void UniValue::clear()
 {
     typ = VNULL;
     val.clear();
     keys.clear();
     values.clear();
+    keyIndex.reset();
 }
 
 void UniValue::setNull()
@@ -55,22 +74,27 @@ void UniValue::setNumStr(std::string str)
     val = std::move(str);
 }
 
-void UniValue::setInt(uint64_t val_)
+// Integers are always valid JSON numbers, so they skip the checks of setNumStr.
+template <typename Int>
+static std::string intToNumStr(Int val)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    char buf[24];
+    const auto [end, ec]{std::to_chars(buf, buf + sizeof(buf), val)};
+    return std::string(buf, end);
+}
 
-    return setNumStr(oss.str());
+void UniValue::setInt(uint64_t val_)
+{
+    clear();
+    typ = VNUM;
+    val = intToNumStr(val_);
 }
 
 void UniValue::setInt(int64_t val_)
 {
-    std::ostringstream oss;
-
-    oss << val_;
-
-    return setNumStr(oss.str());
+    clear();
+    typ = VNUM;
+    val = intToNumStr(val_);
 }
 
 void UniValue::setFloat(double val_)
@@ -119,7 +143,7 @@ void UniValue::pushKVEnd(std::string key, UniValue val)
 {
     checkType(VOBJ);
 
-    keys.push_back(std::move(key));
+    pushKey(std::move(key));
     values.push_back(std::move(val));
 }
 
@@ -153,8 +177,53 @@ void UniValue::getObjMap(std::map<std::string,UniValue>& kv) const
         kv[keys[i]] = values[i];
 }
 
-bool UniValue::findKey(const std::string& key, size_t& retIdx) const
+static void insertKeyIndex(std::vector<uint32_t>& index, const std::vector<std::string>& keys, size_t idx)
 {
+    const size_t mask{index.size() - 1};
+    size_t pos{std::hash<std::string_view>{}(keys[idx]) & mask};
+    for (; index[pos] != 0; pos = (pos + 1) & mask) {
+        if (keys[index[pos] - 1] == keys[idx]) return;
+    }
+    index[pos] = idx + 1;
+}
+
+void UniValue::pushKey(std::string key)
+{
+    keys.push_back(std::move(key));
+    indexKey(keys.size() - 1);
+}
+
+void UniValue::indexKey(size_t idx)
+{
+    if (keys.size() < KEY_INDEX_MIN_SIZE) return;
+
+    // Keep the table at most half full, by rebuilding it at twice the size
+    // when needed.
+    if (!keyIndex || keyIndex->size() < 2 * keys.size()) {
+        size_t size{2 * KEY_INDEX_MIN_SIZE};
+        while (size < 4 * keys.size()) size *= 2;
+        keyIndex = std::make_unique<std::vector<uint32_t>>(size);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            insertKeyIndex(*keyIndex, keys, i);
+        }
+        return;
+    }
+    insertKeyIndex(*keyIndex, keys, idx);
+}
+
+bool UniValue::findKey(std::string_view key, size_t& retIdx) const
+{
+    if (keyIndex) {
+        const size_t mask{keyIndex->size() - 1};
+        for (size_t pos{std::hash<std::string_view>{}(key) & mask}; (*keyIndex)[pos] != 0; pos = (pos + 1) & mask) {
+            if (keys[(*keyIndex)[pos] - 1] == key) {
+                retIdx = (*keyIndex)[pos] - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
     for (size_t i = 0; i < keys.size(); i++) {
         if (keys[i] == key) {
             retIdx = i;
@@ -232,11 +301,8 @@ const char *uvTypeName(UniValue::VType t)
 
 const UniValue& UniValue::find_value(std::string_view key) const
 {
-    for (unsigned int i = 0; i < keys.size(); ++i) {
-        if (keys[i] == key) {
-            return values.at(i);
-        }
-    }
-    return NullUniValue;
+    size_t index;
+    if (!findKey(key, index)) return NullUniValue;
+    return values.at(index);
 }
 
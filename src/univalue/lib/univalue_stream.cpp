@@ -0,0 +1,106 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#include <univalue.h>
+#include <univalue_escapes.h>
+#include <univalue_stream.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+UniValueStreamWriter::UniValueStreamWriter(Sink sink_in, size_t flush_size_in)
+    : sink{std::move(sink_in)}, flush_size{flush_size_in}
+{
+    buf.reserve(flush_size);
+}
+
+void UniValueStreamWriter::beginValue()
+{
+    if (after_key) {
+        after_key = false;
+        return;
+    }
+    if (open.empty()) return;
+    if (open.back().first == UniValue::VOBJ) {
+        throw std::runtime_error("JSON object value without a key");
+    }
+    if (open.back().second) buf += ',';
+    open.back().second = true;
+}
+
+void UniValueStreamWriter::endValue()
+{
+    if (buf.size() >= flush_size) flush();
+}
+
+void UniValueStreamWriter::beginObject()
+{
+    beginValue();
+    buf += '{';
+    open.emplace_back(UniValue::VOBJ, false);
+}
+
+void UniValueStreamWriter::endObject()
+{
+    if (open.empty() || open.back().first != UniValue::VOBJ || after_key) {
+        throw std::runtime_error("JSON object end without a matching begin");
+    }
+    open.pop_back();
+    buf += '}';
+    endValue();
+}
+
+void UniValueStreamWriter::beginArray()
+{
+    beginValue();
+    buf += '[';
+    open.emplace_back(UniValue::VARR, false);
+}
+
+void UniValueStreamWriter::endArray()
+{
+    if (open.empty() || open.back().first != UniValue::VARR) {
+        throw std::runtime_error("JSON array end without a matching begin");
+    }
+    open.pop_back();
+    buf += ']';
+    endValue();
+}
+
+void UniValueStreamWriter::key(std::string_view key)
+{
+    if (open.empty() || open.back().first != UniValue::VOBJ || after_key) {
+        throw std::runtime_error("JSON key outside of an object");
+    }
+    if (open.back().second) buf += ',';
+    open.back().second = true;
+    buf += '"';
+    for (const char c : key) {
+        const char* esc{escapes[static_cast<unsigned char>(c)]};
+        if (esc) {
+            buf += esc;
+        } else {
+            buf += c;
+        }
+    }
+    buf += "\":";
+    after_key = true;
+}
+
+void UniValueStreamWriter::value(const UniValue& val)
+{
+    beginValue();
+    buf += val.write();
+    endValue();
+}
+
+void UniValueStreamWriter::flush()
+{
+    if (buf.empty()) return;
+    sink(buf);
+    flushed += buf.size();
+    buf.clear();
+}
@@ -7,33 +7,35 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-static std::string json_escape(const std::string& inS)
+static void json_escape(std::string_view inS, std::string& outS)
 {
-    std::string outS;
-    outS.reserve(inS.size() * 2);
-
-    for (unsigned int i = 0; i < inS.size(); i++) {
-        unsigned char ch = static_cast<unsigned char>(inS[i]);
-        const char *escStr = escapes[ch];
+    for (const char c : inS) {
+        const char* escStr = escapes[static_cast<unsigned char>(c)];
 
         if (escStr)
             outS += escStr;
         else
-            outS += static_cast<char>(ch);
+            outS += c;
     }
-
-    return outS;
 }
 
-// NOLINTNEXTLINE(misc-no-recursion)
 std::string UniValue::write(unsigned int prettyIndent,
                             unsigned int indentLevel) const
 {
     std::string s;
     s.reserve(1024);
+    writeValue(prettyIndent, indentLevel, s);
+    return s;
+}
 
+// Append to a single output string, rather than building each nested value
+// as a string of its own.
+// NOLINTNEXTLINE(misc-no-recursion)
+void UniValue::writeValue(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const
+{
     unsigned int modIndent = indentLevel;
     if (modIndent == 0)
         modIndent = 1;
@@ -49,7 +51,9 @@ std::string UniValue::write(unsigned int prettyIndent,
         writeArray(prettyIndent, modIndent, s);
         break;
     case VSTR:
-        s += "\"" + json_escape(val) + "\"";
+        s += '"';
+        json_escape(val, s);
+        s += '"';
         break;
     case VNUM:
         s += val;
@@ -58,8 +62,6 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += (val == "1" ? "true" : "false");
         break;
     }
-
-    return s;
 }
 
 static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::string& s)
@@ -77,7 +79,7 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
     for (unsigned int i = 0; i < values.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += values[i].write(prettyIndent, indentLevel + 1);
+        values[i].writeValue(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1)) {
             s += ",";
         }
@@ -100,10 +102,12 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     for (unsigned int i = 0; i < keys.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += "\"" + json_escape(keys[i]) + "\":";
+        s += '"';
+        json_escape(keys[i], s);
+        s += "\":";
         if (prettyIndent)
             s += " ";
-        s += values.at(i).write(prettyIndent, indentLevel + 1);
+        values.at(i).writeValue(prettyIndent, indentLevel + 1, s);
         if (i != (values.size() - 1))
             s += ",";
         if (prettyIndent)
@@ -10,11 +10,13 @@ UNIVALUE_DIST_HEADERS_INT =
 UNIVALUE_DIST_HEADERS_INT += %reldir%/include/univalue.h
 UNIVALUE_DIST_HEADERS_INT += %reldir%/include/univalue_utffilter.h
 UNIVALUE_DIST_HEADERS_INT += %reldir%/include/univalue_escapes.h
+UNIVALUE_DIST_HEADERS_INT += %reldir%/include/univalue_stream.h
 
 UNIVALUE_LIB_SOURCES_INT =
 UNIVALUE_LIB_SOURCES_INT += %reldir%/lib/univalue.cpp
 UNIVALUE_LIB_SOURCES_INT += %reldir%/lib/univalue_get.cpp
 UNIVALUE_LIB_SOURCES_INT += %reldir%/lib/univalue_read.cpp
+UNIVALUE_LIB_SOURCES_INT += %reldir%/lib/univalue_stream.cpp
 UNIVALUE_LIB_SOURCES_INT += %reldir%/lib/univalue_write.cpp
 
 UNIVALUE_TEST_DATA_DIR_INT = %reldir%/test
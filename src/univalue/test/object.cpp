@@ -4,6 +4,7 @@
 // file COPYING or https://opensource.org/licenses/mit-license.php.
 
 #include <univalue.h>
+#include <univalue_stream.h>
 
 #include <cassert>
 #include <cstdint>
@@ -455,6 +456,105 @@ void univalue_readwrite()
     BOOST_CHECK(!v.read("{} 42"));
 }
 
+void univalue_large_object()
+{
+    // Large objects are looked up through a hash table of their keys.
+    UniValue obj(UniValue::VOBJ);
+    for (int i = 0; i < 1000; ++i) {
+        obj.pushKV("key" + std::to_string(i), i);
+    }
+    obj.pushKV("key7", "replaced");
+    obj.pushKVEnd("key8", "duplicate");
+    BOOST_CHECK_EQUAL(obj.size(), 1001U);
+    for (int i = 0; i < 1000; ++i) {
+        const UniValue& v{obj.find_value("key" + std::to_string(i))};
+        if (i == 7) {
+            BOOST_CHECK_EQUAL(v.get_str(), "replaced");
+        } else {
+            BOOST_CHECK_EQUAL(v.getInt<int>(), i);
+        }
+    }
+    BOOST_CHECK(obj.find_value("key1000").isNull());
+    BOOST_CHECK(!obj.exists("key"));
+    BOOST_CHECK(obj.exists("key999"));
+    BOOST_CHECK_EQUAL(obj["key500"].getInt<int>(), 500);
+
+    UniValue copy{obj};
+    obj.setObject();
+    BOOST_CHECK(obj.find_value("key1").isNull());
+    obj = copy;
+    BOOST_CHECK_EQUAL(copy.find_value("key999").getInt<int>(), 999);
+    BOOST_CHECK_EQUAL(obj.find_value("key999").getInt<int>(), 999);
+
+    UniValue read;
+    BOOST_CHECK(read.read(copy.write()));
+    BOOST_CHECK_EQUAL(read.write(), copy.write());
+    BOOST_CHECK_EQUAL(read.find_value("key8").getInt<int>(), 8);
+    BOOST_CHECK_EQUAL(read.find_value("key999").getInt<int>(), 999);
+}
+
+void univalue_stream()
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("a\"b", "c\nd");
+    obj.pushKV("num", -42);
+    obj.pushKV("null", NullUniValue);
+    UniValue arr(UniValue::VARR);
+    arr.push_back(true);
+    arr.push_back(UniValue(UniValue::VOBJ));
+    arr.push_back(UniValue(UniValue::VARR));
+    arr.push_back(1.5);
+    obj.pushKV("arr", arr);
+    obj.pushKV("empty", UniValue(UniValue::VOBJ));
+
+    // A tiny flush size makes the writer hand out many chunks.
+    std::string out;
+    size_t chunks{0};
+    UniValueStreamWriter writer{[&](std::string_view chunk) { out += chunk; ++chunks; }, /*flush_size=*/4};
+    writer.beginObject();
+    writer.pushKV("a\"b", "c\nd");
+    writer.key("num");
+    writer.value(-42);
+    writer.pushKV("null", NullUniValue);
+    writer.key("arr");
+    writer.beginArray();
+    writer.value(true);
+    writer.beginObject();
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.value(1.5);
+    writer.endArray();
+    writer.pushKV("empty", UniValue(UniValue::VOBJ));
+    writer.endObject();
+    writer.flush();
+    BOOST_CHECK_EQUAL(out, obj.write());
+    BOOST_CHECK_EQUAL(writer.size(), out.size());
+    BOOST_CHECK(chunks > 1);
+
+    // Nothing is handed to the sink until the buffer is full or flushed.
+    out.clear();
+    UniValueStreamWriter writer2{[&](std::string_view chunk) { out += chunk; }};
+    writer2.beginArray();
+    writer2.value(arr);
+    writer2.value("x");
+    writer2.endArray();
+    BOOST_CHECK(out.empty());
+    BOOST_CHECK_EQUAL(writer2.size(), 2 + arr.write().size() + 1 + 3);
+    writer2.flush();
+    BOOST_CHECK_EQUAL(out, "[" + arr.write() + ",\"x\"]");
+
+    UniValueStreamWriter writer3{[](std::string_view) {}};
+    BOOST_CHECK_THROW(writer3.endObject(), std::runtime_error);
+    BOOST_CHECK_THROW(writer3.key("k"), std::runtime_error);
+    writer3.beginObject();
+    BOOST_CHECK_THROW(writer3.value(1), std::runtime_error);
+    BOOST_CHECK_THROW(writer3.endArray(), std::runtime_error);
+    writer3.key("k");
+    BOOST_CHECK_THROW(writer3.key("k"), std::runtime_error);
+    BOOST_CHECK_THROW(writer3.endObject(), std::runtime_error);
+}
+
 int main(int argc, char* argv[])
 {
     univalue_constructor();
@@ -464,5 +564,7 @@ int main(int argc, char* argv[])
     univalue_array();
     univalue_object();
     univalue_readwrite();
+    univalue_large_object();
+    univalue_stream();
     return 0;
 }
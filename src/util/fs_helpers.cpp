@@ -34,7 +34,9 @@
 #endif // __linux__
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #else
 #include <io.h> /* For _get_osfhandle, _chsize */
@@ -156,6 +158,54 @@ bool TruncateFile(FILE* file, unsigned int length)
 #endif
 }
 
+MappedFile::MappedFile(const fs::path& path)
+{
+#ifdef WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data) {
+                m_data = static_cast<const std::byte*>(data);
+                m_size = static_cast<size_t>(size.QuadPart);
+            } else {
+                LogPrintf("MapViewOfFile failed: %s\n", Win32ErrorString(GetLastError()));
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(fs::PathToString(path).c_str(), O_RDONLY);
+    if (fd == -1) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const std::byte*>(data);
+            m_size = static_cast<size_t>(st.st_size);
+        } else {
+            LogPrintf("mmap failed: %s\n", SysErrorString(errno));
+        }
+    }
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    if (!m_data) return;
+#ifdef WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+}
+
 /**
  * this function tries to raise the file descriptor limit to the requested number.
  * It returns the actual file descriptor limit (which may be more or less than nMinFD)
@@ -6,8 +6,10 @@
 #ifndef BGL_UTIL_FS_HELPERS_H
 #define BGL_UTIL_FS_HELPERS_H
 
+#include <span.h>
 #include <util/fs.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <iosfwd>
@@ -27,6 +29,30 @@ bool FileCommit(FILE* file);
 void DirectoryCommit(const fs::path& dirname);
 
 bool TruncateFile(FILE* file, unsigned int length);
+
+/**
+ * A read-only memory mapping of a file. The mapping covers the file as it was
+ * when it was mapped; data appended later requires a new mapping. On Windows,
+ * a mapped file cannot be truncated.
+ */
+class MappedFile
+{
+public:
+    /** Map the file at path. The mapping is empty if the file cannot be
+     *  mapped, e.g. because it does not exist or is empty. */
+    explicit MappedFile(const fs::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    Span<const std::byte> Data() const { return {m_data, m_size}; }
+
+private:
+    const std::byte* m_data{nullptr};
+    size_t m_size{0};
+};
+
 int RaiseFileDescriptorLimit(int nMinFD);
 void AllocateFileRange(FILE* file, unsigned int offset, unsigned int length);
 
@@ -5,11 +5,16 @@
 #ifndef BGL_UTIL_GOLOMBRICE_H
 #define BGL_UTIL_GOLOMBRICE_H
 
+#include <crypto/common.h>
+#include <span.h>
 #include <util/fastrange.h>
 
 #include <streams.h>
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <ios>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +47,80 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Decoder for a sequence of Golomb-Rice coded values, equivalent to calling
+ * GolombRiceDecode on a BitStreamReader over the same bytes.
+ *
+ * Rather than reading one bit at a time, it looks at a 64-bit window of the
+ * input, counts the unary-coded quotient with a single leading-ones count and
+ * takes the remainder from the same window, so a typical value is decoded
+ * without any data-dependent branches.
+ */
+class GolombRiceReader
+{
+private:
+    Span<const unsigned char> m_data;
+    //! Number of bits consumed so far
+    uint64_t m_pos{0};
+
+    /** The unconsumed bits, MSB first. At least 57 of them are valid, and
+     *  the bits past the end of the data are zero. */
+    uint64_t Peek() const
+    {
+        const size_t byte = m_pos / 8;
+        uint64_t window;
+        if (byte + 8 <= m_data.size()) {
+            window = ReadBE64(m_data.data() + byte);
+        } else {
+            unsigned char buf[8]{};
+            std::copy(m_data.begin() + std::min(byte, m_data.size()), m_data.end(), buf);
+            window = ReadBE64(buf);
+        }
+        return window << (m_pos % 8);
+    }
+
+    void Skip(uint64_t bits)
+    {
+        if (bits > m_data.size() * 8 - m_pos) {
+            throw std::ios_base::failure("GolombRiceReader::Read(): end of data");
+        }
+        m_pos += bits;
+    }
+
+public:
+    explicit GolombRiceReader(Span<const unsigned char> data) : m_data(data) {}
+
+    uint64_t Read(uint8_t P)
+    {
+        uint64_t window = Peek();
+        int ones = std::countl_one(window);
+        if (P > 0 && ones + 1 + P <= 57) {
+            Skip(ones + 1 + P);
+            return (uint64_t(ones) << P) + ((window << (ones + 1)) >> (64 - P));
+        }
+
+        // Long quotient or large P: fall back to consuming the window in parts.
+        uint64_t q = 0;
+        while (ones >= 57) {
+            q += 57;
+            Skip(57);
+            ones = std::countl_one(Peek());
+        }
+        q += ones;
+        Skip(ones + 1);
+
+        uint64_t r = 0;
+        for (uint8_t left = P; left > 0;) {
+            const uint8_t n = std::min<uint8_t>(left, 56);
+            r = (r << n) | (Peek() >> (64 - n));
+            Skip(n);
+            left -= n;
+        }
+        return (q << P) + r;
+    }
+
+    /** Number of whole bytes after the one holding the last bit read. */
+    size_t RemainingBytes() const { return m_data.size() - (m_pos + 7) / 8; }
+};
+
 #endif // BGL_UTIL_GOLOMBRICE_H
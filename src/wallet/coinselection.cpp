@@ -68,11 +68,12 @@ struct {
  *
  * waste = selectionTotal - target + inputs × (currentFeeRate - longTermFeeRate)
  *
- * The algorithm uses two additional optimizations. A lookahead keeps track of the total value of
+ * The algorithm uses three additional optimizations. A lookahead keeps track of the total value of
  * the unexplored UTXOs. A subtree is not explored if the lookahead indicates that the target range
- * cannot be reached. Further, it is unnecessary to test equivalent combinations. This allows us
- * to skip testing the inclusion of UTXOs that match the effective value and waste of an omitted
- * predecessor.
+ * cannot be reached. Likewise, a subtree is not explored if adding even the smallest UTXO would
+ * overshoot the target range. Further, it is unnecessary to test equivalent combinations. This
+ * allows us to skip testing the inclusion of UTXOs that match the effective value and waste of an
+ * omitted predecessor.
  *
  * The Branch and Bound algorithm is described in detail in Murch's Master Thesis:
  * https://murch.one/wp-content/uploads/2016/11/erhardt2016coinselection.pdf
@@ -94,25 +95,48 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
                                              int max_selection_weight)
 {
     SelectionResult result(selection_target, SelectionAlgorithm::BNB);
+    if (utxo_pool.empty()) return util::Error();
     CAmount curr_value = 0;
     std::vector<size_t> curr_selection; // selected utxo indexes
     int curr_selection_weight = 0; // sum of selected utxo weight
 
-    // Calculate curr_available_value
-    CAmount curr_available_value = 0;
+    // Calculate the total available value
+    CAmount total_available = 0;
     for (const OutputGroup& utxo : utxo_pool) {
         // Assert that this utxo is not negative. It should never be negative,
         // effective value calculation should have removed it
         assert(utxo.GetSelectionAmount() > 0);
-        curr_available_value += utxo.GetSelectionAmount();
+        total_available += utxo.GetSelectionAmount();
     }
-    if (curr_available_value < selection_target) {
+    if (total_available < selection_target) {
         return util::Error();
     }
 
     // Sort the utxo_pool
     std::sort(utxo_pool.begin(), utxo_pool.end(), descending);
 
+    // The search only needs a few fields of each UTXO. Copy them into
+    // contiguous arrays, so that the loop below does not chase OutputGroups.
+    const size_t pool_size = utxo_pool.size();
+    std::vector<CAmount> amounts(pool_size);
+    std::vector<CAmount> fees(pool_size);
+    std::vector<CAmount> wastes(pool_size); // fee - long_term_fee
+    std::vector<int> weights(pool_size);
+    // The sum of UTXO amounts from this UTXO index on, e.g. lookahead[5] = Σ(UTXO[5+].amount)
+    std::vector<CAmount> lookahead(pool_size + 1, 0);
+    for (size_t i = pool_size; i-- > 0;) {
+        const OutputGroup& utxo = utxo_pool[i];
+        amounts[i] = utxo.GetSelectionAmount();
+        fees[i] = utxo.fee;
+        wastes[i] = utxo.fee - utxo.long_term_fee;
+        weights[i] = utxo.m_weight;
+        lookahead[i] = lookahead[i + 1] + amounts[i];
+    }
+    // The pool is sorted by descending amount, so this is the smallest amount
+    // that any extension of a selection can add.
+    const CAmount min_amount = amounts.back();
+    curr_selection.reserve(pool_size);
+
     CAmount curr_waste = 0;
     std::vector<size_t> best_selection;
     CAmount best_waste = MAX_MONEY;
@@ -121,7 +145,12 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
     bool max_tx_weight_exceeded = false;
 
     // Depth First search loop for choosing the UTXOs
-    for (size_t curr_try = 0, utxo_pool_index = 0; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
+    size_t curr_try = 0;
+    bool is_done = false;
+    for (size_t utxo_pool_index = 0; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
+        // The value of all UTXOs not yet decided on
+        const CAmount curr_available_value = lookahead[utxo_pool_index];
+
         // Conditions for starting a backtrack
         bool backtrack = false;
         if (curr_value + curr_available_value < selection_target || // Cannot possibly reach target with the amount remaining in the curr_available_value.
@@ -143,48 +172,42 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
             }
             curr_waste -= (curr_value - selection_target); // Remove the excess value as we will be selecting different coins now
             backtrack = true;
+        } else if (curr_value + min_amount > selection_target + cost_of_change) {
+            // Below the target, but adding even the smallest UTXO overshoots the range: no selection in this branch is changeless
+            backtrack = true;
         }
 
         if (backtrack) { // Backtracking, moving backwards
             if (curr_selection.empty()) { // We have walked back to the first utxo and no branch is untraversed. All solutions searched
+                is_done = true;
                 break;
             }
 
-            // Add omitted UTXOs back to lookahead before traversing the omission branch of last included UTXO.
-            for (--utxo_pool_index; utxo_pool_index > curr_selection.back(); --utxo_pool_index) {
-                curr_available_value += utxo_pool.at(utxo_pool_index).GetSelectionAmount();
-            }
-
-            // Output was included on previous iterations, try excluding now.
-            assert(utxo_pool_index == curr_selection.back());
-            OutputGroup& utxo = utxo_pool.at(utxo_pool_index);
-            curr_value -= utxo.GetSelectionAmount();
-            curr_waste -= utxo.fee - utxo.long_term_fee;
-            curr_selection_weight -= utxo.m_weight;
+            // Output was included on previous iterations, try excluding now. The
+            // lookahead of the omission branch is the suffix sum after it.
+            utxo_pool_index = curr_selection.back();
+            curr_value -= amounts[utxo_pool_index];
+            curr_waste -= wastes[utxo_pool_index];
+            curr_selection_weight -= weights[utxo_pool_index];
             curr_selection.pop_back();
-        } else { // Moving forwards, continuing down this branch
-            OutputGroup& utxo = utxo_pool.at(utxo_pool_index);
-
-            // Remove this utxo from the curr_available_value utxo amount
-            curr_available_value -= utxo.GetSelectionAmount();
-
-            if (curr_selection.empty() ||
-                // The previous index is included and therefore not relevant for exclusion shortcut
-                (utxo_pool_index - 1) == curr_selection.back() ||
-                // Avoid searching a branch if the previous UTXO has the same value and same waste and was excluded.
-                // Since the ratio of fee to long term fee is the same, we only need to check if one of those values match in order to know that the waste is the same.
-                utxo.GetSelectionAmount() != utxo_pool.at(utxo_pool_index - 1).GetSelectionAmount() ||
-                utxo.fee != utxo_pool.at(utxo_pool_index - 1).fee)
-            {
-                // Inclusion branch first (Largest First Exploration)
-                curr_selection.push_back(utxo_pool_index);
-                curr_value += utxo.GetSelectionAmount();
-                curr_waste += utxo.fee - utxo.long_term_fee;
-                curr_selection_weight += utxo.m_weight;
-            }
+        } else if (curr_selection.empty() ||
+                   // The previous index is included and therefore not relevant for exclusion shortcut
+                   (utxo_pool_index - 1) == curr_selection.back() ||
+                   // Avoid searching a branch if the previous UTXO has the same value and same waste and was excluded.
+                   // Since the ratio of fee to long term fee is the same, we only need to check if one of those values match in order to know that the waste is the same.
+                   amounts[utxo_pool_index] != amounts[utxo_pool_index - 1] ||
+                   fees[utxo_pool_index] != fees[utxo_pool_index - 1]) {
+            // Moving forwards, inclusion branch first (Largest First Exploration)
+            curr_selection.push_back(utxo_pool_index);
+            curr_value += amounts[utxo_pool_index];
+            curr_waste += wastes[utxo_pool_index];
+            curr_selection_weight += weights[utxo_pool_index];
         }
     }
 
+    result.SetSelectionsEvaluated(curr_try);
+    result.SetAlgoCompleted(is_done);
+
     // Check for solution
     if (best_selection.empty()) {
         return max_tx_weight_exceeded ? ErrorMaxWeightExceeded() : util::Error();
@@ -325,6 +348,9 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
 util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight)
 {
     std::sort(utxo_pool.begin(), utxo_pool.end(), descending_effval_weight);
+    // Effective values and weights of the sorted UTXOs, kept in contiguous arrays for the search loop
+    std::vector<CAmount> amounts(utxo_pool.size());
+    std::vector<int> weights(utxo_pool.size());
     // The sum of UTXO amounts after this UTXO index, e.g. lookahead[5] = Σ(UTXO[6+].amount)
     std::vector<CAmount> lookahead(utxo_pool.size());
     // The minimum UTXO weight among the remaining UTXOs after this UTXO index, e.g. min_tail_weight[5] = min(UTXO[6+].weight)
@@ -335,12 +361,14 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
     int min_group_weight = std::numeric_limits<int>::max();
     for (size_t i = 0; i < utxo_pool.size(); ++i) {
         size_t index = utxo_pool.size() - 1 - i; // Loop over every element in reverse order
+        amounts[index] = utxo_pool[index].GetSelectionAmount();
+        weights[index] = utxo_pool[index].m_weight;
         lookahead[index] = total_available;
         min_tail_weight[index] = min_group_weight;
         // UTXOs with non-positive effective value must have been filtered
-        Assume(utxo_pool[index].GetSelectionAmount() > 0);
-        total_available += utxo_pool[index].GetSelectionAmount();
-        min_group_weight = std::min(min_group_weight, utxo_pool[index].m_weight);
+        Assume(amounts[index] > 0);
+        total_available += amounts[index];
+        min_group_weight = std::min(min_group_weight, weights[index]);
     }
 
     const CAmount total_target = selection_target + change_target;
@@ -411,9 +439,8 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
      *                                 Next Selection: {0, 6}
      */
     auto deselect_last = [&]() {
-        OutputGroup& utxo = utxo_pool[curr_selection.back()];
-        curr_amount -= utxo.GetSelectionAmount();
-        curr_weight -= utxo.m_weight;
+        curr_amount -= amounts[curr_selection.back()];
+        curr_weight -= weights[curr_selection.back()];
         curr_selection.pop_back();
     };
 
@@ -423,9 +450,8 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
     while (!is_done) {
         bool should_shift{false}, should_cut{false};
         // Select `next_utxo`
-        OutputGroup& utxo = utxo_pool[next_utxo];
-        curr_amount += utxo.GetSelectionAmount();
-        curr_weight += utxo.m_weight;
+        curr_amount += amounts[next_utxo];
+        curr_weight += weights[next_utxo];
         curr_selection.push_back(next_utxo);
         ++next_utxo;
         ++curr_try;
@@ -440,7 +466,7 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             if (curr_weight > max_selection_weight) max_tx_weight_exceeded = true;
             // Worse weight than best solution. More UTXOs only increase weight:
             // CUT if last selected group had minimal weight, else SHIFT
-            if (utxo_pool[curr_tail].m_weight <= min_tail_weight[curr_tail]) {
+            if (weights[curr_tail] <= min_tail_weight[curr_tail]) {
                 should_cut = true;
             } else {
                 should_shift  = true;
@@ -454,9 +480,9 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
                 best_selection_weight = curr_weight;
                 best_selection_amount = curr_amount;
             }
-        } else if (!best_selection.empty() && curr_weight + int64_t{min_tail_weight[curr_tail]} * ((total_target - curr_amount + utxo_pool[curr_tail].GetSelectionAmount() - 1) / utxo_pool[curr_tail].GetSelectionAmount()) > best_selection_weight) {
+        } else if (!best_selection.empty() && curr_weight + int64_t{min_tail_weight[curr_tail]} * ((total_target - curr_amount + amounts[curr_tail] - 1) / amounts[curr_tail]) > best_selection_weight) {
             // Compare minimal tail weight and last selected amount with the amount missing to gauge whether a better weight is still possible.
-            if (utxo_pool[curr_tail].m_weight <= min_tail_weight[curr_tail]) {
+            if (weights[curr_tail] <= min_tail_weight[curr_tail]) {
                 should_cut = true;
             } else {
                 should_shift = true;
@@ -500,7 +526,7 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             // ties on the effective value, it _must_ have the same weight (i.e. be a "clone" of the prior UTXO) or a
             // higher weight. If so, selecting `next_utxo` would produce an equivalent or worse selection as one we
             // previously evaluated. In that case, increment `next_utxo` until we find a UTXO with a differing amount.
-            while (utxo_pool[next_utxo - 1].GetSelectionAmount() == utxo_pool[next_utxo].GetSelectionAmount()) {
+            while (amounts[next_utxo - 1] == amounts[next_utxo]) {
                 if (next_utxo >= utxo_pool.size() - 1) {
                     // Reached end of UTXO pool skipping clones: SHIFT instead
                     should_shift = true;
@@ -23,6 +23,8 @@ namespace wallet {
 static constexpr CAmount CHANGE_LOWER{50000};
 //! upper bound for randomly-chosen target change amount
 static constexpr CAmount CHANGE_UPPER{1000000};
+//! pools with at least this many positive groups run BnB and CoinGrinder on their own threads
+static constexpr size_t MIN_GROUPS_FOR_PARALLEL_SELECTION{1000};
 
 /** A UTXO under consideration for use in funding a new transaction. */
 struct COutput {
@@ -176,6 +178,8 @@ struct CoinSelectionParams {
     bool m_include_unsafe_inputs = false;
     /** The maximum weight for this transaction. */
     std::optional<int> m_max_tx_weight{std::nullopt};
+    /** Pools with at least this many positive groups run BnB and CoinGrinder on their own threads. */
+    size_t m_min_groups_for_parallel_selection{MIN_GROUPS_FOR_PARALLEL_SELECTION};
 
     CoinSelectionParams(FastRandomContext& rng_fast, int change_output_size, int change_spend_size,
                         CAmount min_change_target, CFeeRate effective_feerate,
@@ -162,6 +162,13 @@ public:
        ideal to be called periodically */
     virtual bool PeriodicFlush() = 0;
 
+    /** Start committing the writes of all batches in one database transaction
+     * until EndWriteGroup(). Batch transactions started in between are nested
+     * in it. Returns false if the database does not support this. */
+    virtual bool BeginWriteGroup() { return false; }
+    /** Commit the transaction started by BeginWriteGroup() */
+    virtual bool EndWriteGroup() { return false; }
+
     virtual void IncrementUpdateCounter() = 0;
 
     virtual void ReloadDbEnv() = 0;
@@ -180,6 +187,22 @@ public:
     virtual std::unique_ptr<DatabaseBatch> MakeBatch(bool flush_on_close = true) = 0;
 };
 
+/** Groups the database writes made during its lifetime into one commit, see WalletDatabase::BeginWriteGroup() */
+class WriteGroup
+{
+    WalletDatabase& m_database;
+    const bool m_active;
+
+public:
+    explicit WriteGroup(WalletDatabase& database) : m_database{database}, m_active{database.BeginWriteGroup()} {}
+    ~WriteGroup()
+    {
+        if (m_active) m_database.EndWriteGroup();
+    }
+    WriteGroup(const WriteGroup&) = delete;
+    WriteGroup& operator=(const WriteGroup&) = delete;
+};
+
 enum class DatabaseFormat {
     BERKELEY,
     SQLITE,
@@ -197,6 +220,7 @@ struct DatabaseOptions {
     // Specialized options. Not every option is supported by every backend.
     bool verify = true;             //!< Check data integrity on load.
     bool use_unsafe_sync = false;   //!< Disable file sync for faster performance.
+    bool use_wal = false;           //!< Use a write-ahead log instead of a rollback journal.
     bool use_shared_memory = false; //!< Let other processes access the database.
     int64_t max_log_mb = 100;       //!< Max log size to allow before consolidating.
 };
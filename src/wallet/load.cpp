@@ -149,11 +149,12 @@ void StartWallets(WalletContext& context)
         pwallet->postInitProcess();
     }
 
-    // Schedule periodic wallet flushes and tx rebroadcasts
+    // Schedule periodic wallet flushes, tx rebroadcasts and payout batches
     if (context.args->GetBoolArg("-flushwallet", DEFAULT_FLUSHWALLET)) {
         context.scheduler->scheduleEvery([&context] { MaybeCompactWalletDB(context); }, 500ms);
     }
     context.scheduler->scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min);
+    context.scheduler->scheduleEvery([&context] { MaybeSendQueuedPayouts(context); }, 1s);
 }
 
 void FlushWallets(WalletContext& context)
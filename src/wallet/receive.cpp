@@ -296,10 +296,14 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse)
     isminefilter reuse_filter = avoid_reuse ? ISMINE_NO : ISMINE_USED;
     {
         LOCK(wallet.cs_wallet);
+        if (const auto cached{wallet.GetCachedBalance(min_depth, avoid_reuse)}) return *cached;
+        const uint64_t balances_generation{wallet.GetBalancesGeneration()};
+
         std::set<uint256> trusted_parents;
-        for (const auto& entry : wallet.mapWallet)
+        // Transactions whose outputs are all spent have no available or immature credit
+        for (const auto& [txid, _] : wallet.GetUnspentTXOs())
         {
-            const CWalletTx& wtx = entry.second;
+            const CWalletTx& wtx = wallet.mapWallet.at(txid);
             const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
             const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
             const CAmount tx_credit_mine{CachedTxGetAvailableCredit(wallet, wtx, ISMINE_SPENDABLE | reuse_filter)};
@@ -315,6 +319,7 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse)
             ret.m_mine_immature += CachedTxGetImmatureCredit(wallet, wtx, ISMINE_SPENDABLE);
             ret.m_watchonly_immature += CachedTxGetImmatureCredit(wallet, wtx, ISMINE_WATCH_ONLY);
         }
+        wallet.CacheBalance(min_depth, avoid_reuse, balances_generation, ret);
     }
     return ret;
 }
@@ -12,6 +12,7 @@
 #include <rpc/util.h>
 #include <script/script.h>
 #include <util/rbf.h>
+#include <util/string.h>
 #include <util/translation.h>
 #include <util/vector.h>
 #include <wallet/coincontrol.h>
@@ -415,6 +416,150 @@ RPCHelpMan sendmany()
     };
 }
 
+RPCHelpMan queuepayout()
+{
+    return RPCHelpMan{"queuepayout",
+        "\nQueue a payment to be sent in one transaction with the other queued payments.\n"
+        "Once the oldest queued payment has waited for -payoutwindow seconds, all queued payments are sent\n"
+        "with a single coin selection and signing pass, using the wallet's default fee settings.\n"
+        "Use getpayout to look up the output paying the recipient once it was sent.\n"
+        "Queued payments are not stored in the wallet file and are dropped if the wallet is unloaded before they are sent.\n"
+        "The wallet must be unlocked when the batch is sent." +
+        HELP_REQUIRING_PASSPHRASE,
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The bitgesell address to send to."},
+                    {"amount", RPCArg::Type::AMOUNT, RPCArg::Optional::NO, "The amount in " + CURRENCY_UNIT + " to send. eg 0.1"},
+                    {"subtractfeefromamount", RPCArg::Type::BOOL, RPCArg::Default{false}, "The fee will be deducted from the amount being sent.\n"
+                                         "The fee is shared with the other payments of the batch that set this."},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "payout_id", "The id to look the payment up with getpayout"},
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("queuepayout", "\"" + EXAMPLE_ADDRESS[0] + "\" 0.1")
+            + HelpExampleRpc("queuepayout", "\"" + EXAMPLE_ADDRESS[0] + "\", 0.1")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::shared_ptr<CWallet> const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!pwallet) return UniValue::VNULL;
+
+    if (pwallet->IsWalletFlagSet(WALLET_FLAG_DISABLE_PRIVATE_KEYS)) {
+        throw JSONRPCError(RPC_WALLET_ERROR, "Error: Private keys are disabled for this wallet");
+    }
+
+    const CTxDestination dest{DecodeDestination(request.params[0].get_str())};
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid Bitgesell address: " + request.params[0].get_str());
+    }
+    const CAmount amount{AmountFromValue(request.params[1])};
+    if (amount <= 0) {
+        throw JSONRPCError(RPC_TYPE_ERROR, "Invalid amount for send");
+    }
+    const bool subtract_fee{request.params[2].isNull() ? false : request.params[2].get_bool()};
+
+    const auto id{pwallet->QueuePayout(CRecipient{dest, amount, subtract_fee})};
+    if (!id) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, util::ErrorString(id).original);
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("payout_id", *id);
+    return result;
+},
+    };
+}
+
+RPCHelpMan sendqueuedpayouts()
+{
+    return RPCHelpMan{"sendqueuedpayouts",
+        "\nSend all payments queued with queuepayout now, without waiting for -payoutwindow to pass.\n"
+        "If the wallet is locked or its balance does not cover the payments, they stay queued and are retried later." +
+        HELP_REQUIRING_PASSPHRASE,
+                {},
+                {
+                    RPCResult{"if no payments were queued", RPCResult::Type::NONE, "", ""},
+                    RPCResult{"otherwise", RPCResult::Type::STR_HEX, "txid", "The id of the transaction paying the queued payments"},
+                },
+                RPCExamples{
+                    HelpExampleCli("sendqueuedpayouts", "")
+            + HelpExampleRpc("sendqueuedpayouts", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::shared_ptr<CWallet> const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!pwallet) return UniValue::VNULL;
+
+    PayoutFailure failure;
+    const auto res{SendQueuedPayouts(*pwallet, /*force=*/true, failure)};
+    if (!res) {
+        switch (failure) {
+        case PayoutFailure::WALLET_LOCKED: throw JSONRPCError(RPC_WALLET_UNLOCK_NEEDED, "Error: Please enter the wallet passphrase with walletpassphrase first. The payments stay queued.");
+        case PayoutFailure::INSUFFICIENT_FUNDS: throw JSONRPCError(RPC_WALLET_INSUFFICIENT_FUNDS, util::ErrorString(res).original + ". The payments stay queued.");
+        case PayoutFailure::WALLET_ERROR: throw JSONRPCError(RPC_WALLET_ERROR, util::ErrorString(res).original);
+        } // no default case, so the compiler can warn about missing cases
+        NONFATAL_UNREACHABLE();
+    }
+    if (!*res) return UniValue::VNULL;
+    return (*res)->GetHash().GetHex();
+},
+    };
+}
+
+RPCHelpMan getpayout()
+{
+    return RPCHelpMan{"getpayout",
+        "\nLook up a payment queued with queuepayout.\n"
+        "Sent and failed payments are forgotten once " + util::ToString(MAX_FINISHED_PAYOUTS) + " newer ones were sent or failed.\n",
+                {
+                    {"payout_id", RPCArg::Type::NUM, RPCArg::Optional::NO, "The id returned by queuepayout"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR, "status", "\"queued\", \"sent\" or \"failed\""},
+                        {RPCResult::Type::STR, "address", "The bitgesell address paid"},
+                        {RPCResult::Type::STR_AMOUNT, "amount", "The amount queued in " + CURRENCY_UNIT},
+                        {RPCResult::Type::STR_HEX, "txid", /*optional=*/true, "The id of the transaction paying the recipient, once sent"},
+                        {RPCResult::Type::NUM, "vout", /*optional=*/true, "The output index paying the recipient, once sent"},
+                        {RPCResult::Type::STR, "error", /*optional=*/true, "Why the payment's batch could not be sent, if it failed or was put back in the queue"},
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("getpayout", "1")
+            + HelpExampleRpc("getpayout", "1")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::shared_ptr<const CWallet> const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!pwallet) return UniValue::VNULL;
+
+    const std::optional<Payout> payout{pwallet->GetPayout(request.params[0].getInt<uint64_t>())};
+    if (!payout) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unknown payout id");
+    }
+
+    UniValue result(UniValue::VOBJ);
+    switch (payout->status) {
+    case Payout::Status::QUEUED: result.pushKV("status", "queued"); break;
+    case Payout::Status::SENT: result.pushKV("status", "sent"); break;
+    case Payout::Status::FAILED: result.pushKV("status", "failed"); break;
+    } // no default case, so the compiler can warn about missing cases
+    result.pushKV("address", EncodeDestination(payout->recipient.dest));
+    result.pushKV("amount", ValueFromAmount(payout->recipient.nAmount));
+    if (payout->status == Payout::Status::SENT) {
+        result.pushKV("txid", payout->outpoint.hash.GetHex());
+        result.pushKV("vout", payout->outpoint.n);
+    } else if (!payout->error.empty()) {
+        result.pushKV("error", payout->error);
+    }
+    return result;
+},
+    };
+}
+
 RPCHelpMan settxfee()
 {
     return RPCHelpMan{"settxfee",
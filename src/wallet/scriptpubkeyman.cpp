@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/system.h>
 #include <hash.h>
 #include <key_io.h>
 #include <logging.h>
@@ -15,11 +16,14 @@
 #include <util/check.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <algorithm>
 #include <optional>
+#include <thread>
 
 using common::PSBTError;
 using util::ToString;
@@ -2206,6 +2210,56 @@ bool DescriptorScriptPubKeyMan::TopUp(unsigned int size)
     return res;
 }
 
+//! Minimum number of indexes each thread expands when topping up a descriptor
+static constexpr int32_t MIN_TOPUP_INDEXES_PER_THREAD{250};
+
+/** The scripts and keys of a descriptor at one index, see ExpandDescriptorRange() */
+struct ExpandedIndex {
+    bool ok{false};
+    std::vector<CScript> scripts;
+    FlatSigningProvider out_keys;
+    DescriptorCache cache;
+};
+
+/**
+ * Expand w_desc at indexes [start, end), splitting large ranges across
+ * threads. Expanding only reads the descriptor, its cache and the provider,
+ * and each thread writes to its own results, so no locking is needed.
+ */
+static std::vector<ExpandedIndex> ExpandDescriptorRange(const WalletDescriptor& w_desc, const FlatSigningProvider& provider, int32_t start, int32_t end)
+{
+    std::vector<ExpandedIndex> results(std::max(end - start, 0));
+    const auto expand = [&](int32_t from, int32_t to) {
+        for (int32_t i = from; i < to; ++i) {
+            ExpandedIndex& res = results[i - start];
+            // Maybe we have a cached xpub and we can expand from the cache first
+            res.ok = w_desc.descriptor->ExpandFromCache(i, w_desc.cache, res.scripts, res.out_keys) ||
+                     w_desc.descriptor->Expand(i, provider, res.scripts, res.out_keys, &res.cache);
+        }
+    };
+
+    const int32_t count{end - start};
+    const int32_t threads{std::min<int32_t>(GetNumCores(), count / MIN_TOPUP_INDEXES_PER_THREAD)};
+    if (threads <= 1) {
+        expand(start, end);
+        return results;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int32_t n = 0; n < threads; ++n) {
+        const int32_t from{start + int32_t(int64_t{count} * n / threads)};
+        const int32_t to{start + int32_t(int64_t{count} * (n + 1) / threads)};
+        workers.emplace_back([&expand, from, to, n]() {
+            util::ThreadRename(strprintf("topup.%i", n));
+            expand(from, to);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
 bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int size)
 {
     LOCK(cs_desc_man);
@@ -2231,34 +2285,51 @@ bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int siz
     provider.keys = GetKeys();
 
     uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
+    // Add the expanded indexes in order, stopping at the first one that failed,
+    // and write the new cache items in one go.
+    const auto add_expanded = [&](std::vector<ExpandedIndex>& expanded) EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man) {
         DescriptorCache temp_cache;
-        // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+        bool ok{true};
+        for (ExpandedIndex& res : expanded) {
+            if (!res.ok) {
+                ok = false;
+                break;
             }
-            m_map_pubkeys[pubkey] = i;
+            const int32_t i{m_max_cached_index + 1};
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(res.scripts.begin(), res.scripts.end());
+            for (const CScript& script : res.scripts) {
+                m_map_script_pub_keys[script] = i;
+            }
+            for (const auto& pk_pair : res.out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
+            }
+            temp_cache.MergeAndDiff(res.cache);
+            m_max_cached_index++;
         }
         // Merge and write the cache
         DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
         if (!batch.WriteDescriptorCacheItems(id, new_items)) {
             throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
         }
-        m_max_cached_index++;
+        return ok;
+    };
+
+    // Expand the first new index on its own: it fills the descriptor cache with
+    // the parent xpubs, so that the other indexes only need a single
+    // unhardened derivation from there.
+    const int32_t first{m_max_cached_index + 1};
+    if (first < new_range_end) {
+        std::vector<ExpandedIndex> expanded{ExpandDescriptorRange(m_wallet_descriptor, provider, first, first + 1)};
+        if (!add_expanded(expanded)) return false;
+        expanded = ExpandDescriptorRange(m_wallet_descriptor, provider, first + 1, new_range_end);
+        if (!add_expanded(expanded)) return false;
     }
     m_wallet_descriptor.range_end = new_range_end;
     batch.WriteDescriptor(GetID(), m_wallet_descriptor);
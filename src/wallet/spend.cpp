@@ -13,12 +13,14 @@
 #include <numeric>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <random.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <script/solver.h>
 #include <util/check.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
+#include <util/threadnames.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -29,6 +31,9 @@
 #include <wallet/wallet.h>
 
 #include <cmath>
+#include <exception>
+#include <optional>
+#include <thread>
 
 using common::StringForFeeReason;
 using common::TransactionErrorString;
@@ -324,10 +329,10 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     std::vector<COutPoint> outpoints;
 
     std::set<uint256> trusted_parents;
-    for (const auto& entry : wallet.mapWallet)
+    // Only visit transactions that still have unspent outputs of ours
+    for (const auto& [txid, unspent_outputs] : wallet.GetUnspentTXOs())
     {
-        const uint256& txid = entry.first;
-        const CWalletTx& wtx = entry.second;
+        const CWalletTx& wtx = wallet.mapWallet.at(txid);
 
         if (wallet.IsTxImmatureCoinBase(wtx) && !params.include_immature_coinbase)
             continue;
@@ -384,7 +389,7 @@ CoinsResult AvailableCoins(const CWallet& wallet,
 
         bool tx_from_me = CachedTxIsFromMe(wallet, wtx, ISMINE_ALL);
 
-        for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+        for (const uint32_t i : unspent_outputs) {
             const CTxOut& output = wtx.tx->vout[i];
             const COutPoint outpoint(Txid::FromUint256(txid), i);
 
@@ -704,34 +709,111 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
     }
 
     // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
-    if (!coin_selection_params.m_subtract_fee_outputs) {
-        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight)}) {
-            results.push_back(*bnb_result);
-        } else append_error(std::move(bnb_result));
-    }
+    const bool use_bnb{!coin_selection_params.m_subtract_fee_outputs};
+    // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
+    const bool use_cg{coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}};
 
     // Deduct change weight because remaining Coin Selection algorithms can create change output
-    int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
-    max_selection_weight -= change_outputs_weight;
-    if (max_selection_weight < 0 && results.empty()) {
-        return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+    const int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
+    const int change_max_selection_weight = max_selection_weight - change_outputs_weight;
+
+    std::optional<util::Result<SelectionResult>> bnb_result;
+    std::optional<util::Result<SelectionResult>> cg_result;
+    const auto run_bnb = [&](std::vector<OutputGroup>& pool) {
+        bnb_result.emplace(SelectCoinsBnB(pool, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight));
+    };
+    const auto run_cg = [&](std::vector<OutputGroup>& pool) {
+        cg_result.emplace(CoinGrinder(pool, nTargetValue, coin_selection_params.m_min_change_target, change_max_selection_weight));
+        if (*cg_result) (*cg_result)->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+    };
+
+    // BnB and CoinGrinder can search up to their iteration limits on large
+    // pools. Run them on their own threads there, while Knapsack and SRD, which
+    // share rng_fast, run on this one. Both searches sort the pool they are
+    // given, so each of them sorts its own copy. The threads are jthreads, so
+    // they are also joined if an exception leaves this function, and an
+    // exception thrown on one of them is rethrown here once it is joined.
+    const bool parallel{groups.positive_group.size() >= coin_selection_params.m_min_groups_for_parallel_selection};
+    std::vector<OutputGroup> bnb_pool;
+    std::vector<OutputGroup> cg_pool;
+    std::exception_ptr bnb_error;
+    std::exception_ptr cg_error;
+    std::vector<std::jthread> searches;
+    const auto join_searches = [&] {
+        for (std::jthread& search : searches) search.join();
+        searches.clear();
+        if (bnb_error) std::rethrow_exception(bnb_error);
+        if (cg_error) std::rethrow_exception(cg_error);
+    };
+    if (parallel) {
+        if (use_bnb) {
+            searches.emplace_back([&] {
+                util::ThreadRename("coinselect.bnb");
+                try {
+                    bnb_pool = groups.positive_group;
+                    run_bnb(bnb_pool);
+                } catch (...) {
+                    bnb_error = std::current_exception();
+                }
+            });
+        }
+        if (use_cg) {
+            searches.emplace_back([&] {
+                util::ThreadRename("coinselect.cg");
+                try {
+                    cg_pool = groups.positive_group;
+                    run_cg(cg_pool);
+                } catch (...) {
+                    cg_error = std::current_exception();
+                }
+            });
+        }
+    } else if (use_bnb) {
+        run_bnb(groups.positive_group);
+    }
+
+    if (change_max_selection_weight < 0) {
+        // Only a changeless solution can fit
+        join_searches();
+        if (!bnb_result || !*bnb_result) {
+            return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+        }
     }
 
     // The knapsack solver has some legacy behavior where it will spend dust outputs. We retain this behavior, so don't filter for positive only here.
-    if (auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*knapsack_result);
-    } else append_error(std::move(knapsack_result));
+    auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, change_max_selection_weight)};
 
-    if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
-        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight)}) {
-            cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
-            results.push_back(*cg_result);
-        } else {
-            append_error(std::move(cg_result));
-        }
+    if (!parallel && use_cg) {
+        run_cg(groups.positive_group);
     }
 
-    if (auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_selection_weight)}) {
+    join_searches();
+    // SRD draws from the pool in its current order, which the searches sort.
+    // Give it the pool sorted the way the sequential path leaves it.
+    if (parallel && use_cg) {
+        groups.positive_group = std::move(cg_pool);
+    } else if (parallel && use_bnb) {
+        groups.positive_group = std::move(bnb_pool);
+    }
+
+    auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, change_max_selection_weight)};
+
+    // Collect the results in the order the algorithms ran in before they were
+    // parallelized, as that order breaks ties in waste
+    if (bnb_result) {
+        if (*bnb_result) {
+            results.push_back(**bnb_result);
+        } else append_error(std::move(*bnb_result));
+    }
+    if (knapsack_result) {
+        results.push_back(*knapsack_result);
+    } else append_error(std::move(knapsack_result));
+    if (cg_result) {
+        if (*cg_result) {
+            results.push_back(**cg_result);
+        } else append_error(std::move(*cg_result));
+    }
+    if (srd_result) {
         results.push_back(*srd_result);
     } else append_error(std::move(srd_result));
 
@@ -1461,4 +1543,121 @@ util::Result<CreatedTransactionResult> FundTransaction(CWallet& wallet, const CM
 
     return res;
 }
+
+static std::vector<uint64_t> PayoutIds(const std::vector<std::pair<uint64_t, CRecipient>>& payouts)
+{
+    std::vector<uint64_t> ids;
+    ids.reserve(payouts.size());
+    for (const auto& [id, recipient] : payouts) {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+util::Result<CTransactionRef> SendQueuedPayouts(CWallet& wallet, bool force, PayoutFailure& failure)
+{
+    const std::vector<std::pair<uint64_t, CRecipient>> queued{wallet.TakeQueuedPayouts(force)};
+    if (queued.empty()) return CTransactionRef{};
+
+    // The payouts of the transaction, oldest first
+    std::vector<std::pair<uint64_t, CRecipient>> payouts{queued};
+    // Payouts left for a later batch because the wallet cannot fund them yet
+    std::vector<std::pair<uint64_t, CRecipient>> deferred;
+    std::vector<size_t> order;
+    const auto create_transaction = [&]() -> util::Result<CreatedTransactionResult> {
+        // Shuffle the outputs like sendmany does, remembering where each payout ends up
+        order.resize(payouts.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), FastRandomContext());
+        std::vector<CRecipient> recipients;
+        recipients.reserve(payouts.size());
+        for (const size_t i : order) {
+            recipients.push_back(payouts[i].second);
+        }
+
+        failure = PayoutFailure::WALLET_ERROR;
+        LOCK(wallet.cs_wallet);
+        if (wallet.IsWalletFlagSet(WALLET_FLAG_DISABLE_PRIVATE_KEYS)) {
+            return util::Error{_("Private keys are disabled for this wallet")};
+        }
+        if (wallet.IsLocked()) {
+            failure = PayoutFailure::WALLET_LOCKED;
+            return util::Error{_("Wallet is locked")};
+        }
+        auto created = CreateTransaction(wallet, recipients, /*change_pos=*/std::nullopt, CCoinControl{}, /*sign=*/true);
+        if (created) {
+            wallet.CommitTransaction(created->tx, /*mapValue=*/{}, /*orderForm=*/{});
+        } else {
+            // Coin selection reports a shortfall, including one of the fee
+            // only, with this generic error.
+            CAmount needed{0};
+            for (const CRecipient& recipient : recipients) {
+                needed += recipient.nAmount;
+            }
+            if (GetBalance(wallet).m_mine_trusted < needed || util::ErrorString(created).original == _("Insufficient funds").original) {
+                failure = PayoutFailure::INSUFFICIENT_FUNDS;
+            }
+        }
+        return created;
+    };
+
+    std::optional<util::Result<CreatedTransactionResult>> res;
+    res.emplace(create_transaction());
+    if (!*res && failure == PayoutFailure::INSUFFICIENT_FUNDS) {
+        // Send the oldest payouts the balance covers, so that a payout the
+        // wallet cannot fund does not hold back the others.
+        CAmount available{WITH_LOCK(wallet.cs_wallet, return GetBalance(wallet).m_mine_trusted)};
+        payouts.clear();
+        for (const auto& payout : queued) {
+            if (payout.second.nAmount <= available) {
+                available -= payout.second.nAmount;
+                payouts.push_back(payout);
+            } else {
+                deferred.push_back(payout);
+            }
+        }
+        if (!payouts.empty() && !deferred.empty()) {
+            res.emplace(create_transaction());
+        }
+        if (!*res && failure == PayoutFailure::INSUFFICIENT_FUNDS) {
+            payouts = queued;
+            deferred.clear();
+        }
+    }
+    if (!deferred.empty()) {
+        wallet.RequeuePayouts(PayoutIds(deferred), _("Insufficient funds").original);
+        wallet.WalletLogPrintf("Could not fund %u queued payouts yet, retrying later\n", deferred.size());
+    }
+    if (!*res) {
+        const std::vector<uint64_t> ids{PayoutIds(payouts)};
+        if (failure == PayoutFailure::WALLET_ERROR) {
+            wallet.SetPayoutsFailed(ids, util::ErrorString(*res).original);
+            wallet.WalletLogPrintf("Failed to send %u queued payouts: %s\n", payouts.size(), util::ErrorString(*res).original);
+        } else {
+            wallet.RequeuePayouts(ids, util::ErrorString(*res).original);
+            wallet.WalletLogPrintf("Could not send %u queued payouts yet, retrying later: %s\n", payouts.size(), util::ErrorString(*res).original);
+        }
+        return util::Error{util::ErrorString(*res)};
+    }
+
+    // The change output, if any, is inserted between the recipients' outputs
+    std::vector<std::pair<uint64_t, COutPoint>> outpoints;
+    outpoints.reserve(payouts.size());
+    for (size_t n = 0; n < order.size(); ++n) {
+        const uint32_t vout = n + ((*res)->change_pos && *(*res)->change_pos <= n ? 1 : 0);
+        outpoints.emplace_back(payouts[order[n]].first, COutPoint{(*res)->tx->GetHash(), vout});
+    }
+    wallet.SetPayoutsSent(outpoints);
+    wallet.WalletLogPrintf("Sent %u queued payouts in %s\n", payouts.size(), (*res)->tx->GetHash().ToString());
+    return (*res)->tx;
+}
+
+void MaybeSendQueuedPayouts(WalletContext& context)
+{
+    for (const std::shared_ptr<CWallet>& pwallet : GetWallets(context)) {
+        // Failures are logged and reported through the payouts
+        PayoutFailure failure;
+        (void)SendQueuedPayouts(*pwallet, /*force=*/false, failure);
+    }
+}
 } // namespace wallet
@@ -225,6 +225,34 @@ util::Result<CreatedTransactionResult> CreateTransaction(CWallet& wallet, const
  * calling CreateTransaction();
  */
 util::Result<CreatedTransactionResult> FundTransaction(CWallet& wallet, const CMutableTransaction& tx, const std::vector<CRecipient>& recipients, std::optional<unsigned int> change_pos, bool lockUnspents, CCoinControl);
+
+/** Why SendQueuedPayouts() could not send the queued payouts. */
+enum class PayoutFailure {
+    //! The wallet is locked; the payouts stay queued
+    WALLET_LOCKED,
+    //! The wallet's spendable balance does not cover the payouts; they stay queued
+    INSUFFICIENT_FUNDS,
+    //! The transaction could not be created otherwise; the payouts failed
+    WALLET_ERROR,
+};
+
+/**
+ * Send the payouts queued with CWallet::QueuePayout() in one transaction, with a
+ * single coin selection and signing pass, and record the output paying each.
+ * Unless force is set, payouts are only sent once the oldest has been queued for
+ * the wallet's payout window.
+ *
+ * @returns the transaction, or nullptr if no payouts were due. If the transaction
+ *          could not be created, failure is set: while the wallet is locked or
+ *          short of funds the payouts are put back in the queue to be retried,
+ *          otherwise all payouts of the batch are marked as failed. When the
+ *          balance only covers some of the payouts, the oldest ones it covers
+ *          are sent and the others are put back in the queue.
+ */
+util::Result<CTransactionRef> SendQueuedPayouts(CWallet& wallet, bool force, PayoutFailure& failure);
+
+/** Send the due payouts of all loaded wallets. */
+void MaybeSendQueuedPayouts(WalletContext& context);
 } // namespace wallet
 
 #endif // BGL_WALLET_SPEND_H
@@ -25,6 +25,8 @@
 
 namespace wallet {
 static constexpr int32_t WALLET_SCHEMA_VERSION = 0;
+//! Number of closed batches whose prepared statements are kept for reuse
+static constexpr size_t MAX_CACHED_STATEMENTS{8};
 
 static Span<const std::byte> SpanFromBlob(sqlite3_stmt* stmt, int col)
 {
@@ -78,6 +80,27 @@ static bool BindBlobToStatement(sqlite3_stmt* stmt,
     return true;
 }
 
+/** Return the smallest key that is greater than every key starting with prefix,
+ * or an empty vector if there is none because the prefix is all 0xff bytes. */
+static std::vector<std::byte> PrefixRangeEnd(Span<const std::byte> prefix)
+{
+    // The prefix incremented by one (when interpreted as an integer)
+    std::vector<std::byte> end_range(prefix.begin(), prefix.end());
+    auto it = end_range.rbegin();
+    for (; it != end_range.rend(); ++it) {
+        if (*it == std::byte(std::numeric_limits<unsigned char>::max())) {
+            *it = std::byte(0);
+            continue;
+        }
+        *it = std::byte(std::to_integer<unsigned char>(*it) + 1);
+        break;
+    }
+    if (it == end_range.rend()) {
+        end_range.clear();
+    }
+    return end_range;
+}
+
 static std::optional<int> ReadPragmaInteger(sqlite3* db, const std::string& key, const std::string& description, bilingual_str& error)
 {
     std::string stmt_text = strprintf("PRAGMA %s", key);
@@ -112,7 +135,7 @@ Mutex SQLiteDatabase::g_sqlite_mutex;
 int SQLiteDatabase::g_sqlite_count = 0;
 
 SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_path, const DatabaseOptions& options, bool mock)
-    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
+    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync), m_use_wal(options.use_wal)
 {
     {
         LOCK(g_sqlite_mutex);
@@ -148,12 +171,18 @@ SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_pa
 
 void SQLiteBatch::SetupSQLStatements()
 {
+    if (auto stmts{m_database.TakeStatements()}) {
+        m_stmts = *stmts;
+        return;
+    }
+
     const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
-        {&m_read_stmt, "SELECT value FROM main WHERE key = ?"},
-        {&m_insert_stmt, "INSERT INTO main VALUES(?, ?)"},
-        {&m_overwrite_stmt, "INSERT or REPLACE into main values(?, ?)"},
-        {&m_delete_stmt, "DELETE FROM main WHERE key = ?"},
-        {&m_delete_prefix_stmt, "DELETE FROM main WHERE instr(key, ?) = 1"},
+        {&m_stmts.read, "SELECT value FROM main WHERE key = ?"},
+        {&m_stmts.insert, "INSERT INTO main VALUES(?, ?)"},
+        {&m_stmts.overwrite, "INSERT or REPLACE into main values(?, ?)"},
+        {&m_stmts.erase, "DELETE FROM main WHERE key = ?"},
+        {&m_stmts.erase_range, "DELETE FROM main WHERE key >= ? AND key < ?"},
+        {&m_stmts.erase_prefix, "DELETE FROM main WHERE instr(key, ?) = 1"},
     };
 
     for (const auto& [stmt_prepared, stmt_text] : statements) {
@@ -167,6 +196,49 @@ void SQLiteBatch::SetupSQLStatements()
     }
 }
 
+static void FinalizeStatements(SQLiteStatements& stmts)
+{
+    const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
+        {&stmts.read, "read"},
+        {&stmts.insert, "insert"},
+        {&stmts.overwrite, "overwrite"},
+        {&stmts.erase, "delete"},
+        {&stmts.erase_range, "delete range"},
+        {&stmts.erase_prefix, "delete prefix"},
+    };
+
+    for (const auto& [stmt_prepared, stmt_description] : statements) {
+        int res = sqlite3_finalize(*stmt_prepared);
+        if (res != SQLITE_OK) {
+            LogPrintf("SQLiteBatch: Batch closed but could not finalize %s statement: %s\n",
+                      stmt_description, sqlite3_errstr(res));
+        }
+        *stmt_prepared = nullptr;
+    }
+}
+
+std::optional<SQLiteStatements> SQLiteDatabase::TakeStatements()
+{
+    LOCK(m_stmts_cache_mutex);
+    if (m_stmts_cache.empty()) return std::nullopt;
+    SQLiteStatements stmts{m_stmts_cache.back()};
+    m_stmts_cache.pop_back();
+    return stmts;
+}
+
+void SQLiteDatabase::ReturnStatements(const SQLiteStatements& stmts)
+{
+    {
+        LOCK(m_stmts_cache_mutex);
+        if (m_stmts_cache.size() < MAX_CACHED_STATEMENTS) {
+            m_stmts_cache.push_back(stmts);
+            return;
+        }
+    }
+    SQLiteStatements to_finalize{stmts};
+    FinalizeStatements(to_finalize);
+}
+
 SQLiteDatabase::~SQLiteDatabase()
 {
     Cleanup();
@@ -298,6 +370,14 @@ void SQLiteDatabase::Open()
         SetPragma(m_db, "synchronous", "OFF", "Failed to set synchronous mode to OFF");
     }
 
+    // A write-ahead log only needs to be synced once per commit, where the
+    // rollback journal syncs both the journal and the database file. With the
+    // exclusive locking mode set above the WAL index is kept in heap memory.
+    // The journal mode is persistent, so switch back when WAL is not asked for.
+    if (!m_mock) {
+        SetPragma(m_db, "journal_mode", m_use_wal ? "WAL" : "DELETE", "Failed to set the journal mode");
+    }
+
     // Make the table for our key-value pairs
     // First check that the main table exists
     sqlite3_stmt* check_main_stmt{nullptr};
@@ -372,6 +452,13 @@ bool SQLiteDatabase::Backup(const std::string& dest) const
 
 void SQLiteDatabase::Close()
 {
+    {
+        LOCK(m_stmts_cache_mutex);
+        for (SQLiteStatements& stmts : m_stmts_cache) {
+            FinalizeStatements(stmts);
+        }
+        m_stmts_cache.clear();
+    }
     int res = sqlite3_close(m_db);
     if (res != SQLITE_OK) {
         throw std::runtime_error(strprintf("SQLiteDatabase: Failed to close database: %s\n", sqlite3_errstr(res)));
@@ -379,6 +466,60 @@ void SQLiteDatabase::Close()
     m_db = nullptr;
 }
 
+void SQLiteDatabase::Flush()
+{
+    if (!m_db || !m_use_wal) return;
+    // Move the whole log into the database file and truncate it
+    int res = sqlite3_wal_checkpoint_v2(m_db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr);
+    if (res != SQLITE_OK) {
+        LogPrintf("SQLiteDatabase: Failed to checkpoint the write-ahead log of %s: %s\n", Filename(), sqlite3_errstr(res));
+    }
+}
+
+bool SQLiteDatabase::PeriodicFlush()
+{
+    // Checkpoint the log while the wallet is idle, so that the automatic
+    // checkpoints made by commits rarely have anything left to do. Skip
+    // this if a batch is writing.
+    if (!m_db || !m_use_wal || !m_write_semaphore.try_wait()) return false;
+    int res = HasActiveTxn() ? SQLITE_BUSY : sqlite3_wal_checkpoint_v2(m_db, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+    m_write_semaphore.post();
+    return res == SQLITE_OK;
+}
+
+bool SQLiteDatabase::BeginWriteGroup()
+{
+    if (!m_db) return false;
+    m_write_semaphore.wait();
+    int res = HasActiveTxn() ? SQLITE_BUSY : sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+    if (res != SQLITE_OK) {
+        LogPrintf("SQLiteDatabase: Failed to begin a write group: %s\n", sqlite3_errstr(res));
+    } else {
+        m_write_group = true;
+    }
+    m_write_semaphore.post();
+    return res == SQLITE_OK;
+}
+
+bool SQLiteDatabase::EndWriteGroup()
+{
+    if (!m_db) return false;
+    m_write_semaphore.wait();
+    if (!m_write_group) {
+        m_write_semaphore.post();
+        return false;
+    }
+    int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+    if (res != SQLITE_OK) {
+        LogPrintf("SQLiteDatabase: Failed to commit a write group: %s\n", sqlite3_errstr(res));
+        // Don't leave the transaction open for unrelated writes to end up in
+        if (HasActiveTxn()) sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+    }
+    m_write_group = false;
+    m_write_semaphore.post();
+    return res == SQLITE_OK;
+}
+
 bool SQLiteDatabase::HasActiveTxn()
 {
     // 'sqlite3_get_autocommit' returns true by default, and false if a transaction has begun and not been committed or rolled back.
@@ -422,22 +563,15 @@ void SQLiteBatch::Close()
         }
     }
 
-    // Free all of the prepared statements
-    const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
-        {&m_read_stmt, "read"},
-        {&m_insert_stmt, "insert"},
-        {&m_overwrite_stmt, "overwrite"},
-        {&m_delete_stmt, "delete"},
-        {&m_delete_prefix_stmt, "delete prefix"},
-    };
-
-    for (const auto& [stmt_prepared, stmt_description] : statements) {
-        int res = sqlite3_finalize(*stmt_prepared);
-        if (res != SQLITE_OK) {
-            LogPrintf("SQLiteBatch: Batch closed but could not finalize %s statement: %s\n",
-                      stmt_description, sqlite3_errstr(res));
+    // Hand the prepared statements back to the database for the next batch,
+    // unless the connection they belong to is about to be replaced
+    if (m_stmts.read) {
+        if (force_conn_refresh) {
+            FinalizeStatements(m_stmts);
+        } else {
+            m_database.ReturnStatements(m_stmts);
         }
-        *stmt_prepared = nullptr;
+        m_stmts = {};
     }
 
     if (force_conn_refresh) {
@@ -457,39 +591,39 @@ void SQLiteBatch::Close()
 bool SQLiteBatch::ReadKey(DataStream&& key, DataStream& value)
 {
     if (!m_database.m_db) return false;
-    assert(m_read_stmt);
+    assert(m_stmts.read);
 
     // Bind: leftmost parameter in statement is index 1
-    if (!BindBlobToStatement(m_read_stmt, 1, key, "key")) return false;
-    int res = sqlite3_step(m_read_stmt);
+    if (!BindBlobToStatement(m_stmts.read, 1, key, "key")) return false;
+    int res = sqlite3_step(m_stmts.read);
     if (res != SQLITE_ROW) {
         if (res != SQLITE_DONE) {
             // SQLITE_DONE means "not found", don't log an error in that case.
             LogPrintf("%s: Unable to execute statement: %s\n", __func__, sqlite3_errstr(res));
         }
-        sqlite3_clear_bindings(m_read_stmt);
-        sqlite3_reset(m_read_stmt);
+        sqlite3_clear_bindings(m_stmts.read);
+        sqlite3_reset(m_stmts.read);
         return false;
     }
     // Leftmost column in result is index 0
     value.clear();
-    value.write(SpanFromBlob(m_read_stmt, 0));
+    value.write(SpanFromBlob(m_stmts.read, 0));
 
-    sqlite3_clear_bindings(m_read_stmt);
-    sqlite3_reset(m_read_stmt);
+    sqlite3_clear_bindings(m_stmts.read);
+    sqlite3_reset(m_stmts.read);
     return true;
 }
 
 bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
 {
     if (!m_database.m_db) return false;
-    assert(m_insert_stmt && m_overwrite_stmt);
+    assert(m_stmts.insert && m_stmts.overwrite);
 
     sqlite3_stmt* stmt;
     if (overwrite) {
-        stmt = m_overwrite_stmt;
+        stmt = m_stmts.overwrite;
     } else {
-        stmt = m_insert_stmt;
+        stmt = m_stmts.insert;
     }
 
     // Bind: leftmost parameter in statement is index 1
@@ -513,13 +647,14 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
     return res == SQLITE_DONE;
 }
 
-bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob)
+bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob, std::optional<Span<const std::byte>> blob2)
 {
     if (!m_database.m_db) return false;
     assert(stmt);
 
     // Bind: leftmost parameter in statement is index 1
     if (!BindBlobToStatement(stmt, 1, blob, "key")) return false;
+    if (blob2 && !BindBlobToStatement(stmt, 2, *blob2, "key")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
     if (!m_txn) m_database.m_write_semaphore.wait();
@@ -539,24 +674,28 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob)
 
 bool SQLiteBatch::EraseKey(DataStream&& key)
 {
-    return ExecStatement(m_delete_stmt, key);
+    return ExecStatement(m_stmts.erase, key);
 }
 
 bool SQLiteBatch::ErasePrefix(Span<const std::byte> prefix)
 {
-    return ExecStatement(m_delete_prefix_stmt, prefix);
+    // Delete the range of keys starting with the prefix, like the prefix
+    // cursor, so that the primary key index is used instead of a table scan
+    const std::vector<std::byte> end_range{PrefixRangeEnd(prefix)};
+    if (end_range.empty()) return ExecStatement(m_stmts.erase_prefix, prefix);
+    return ExecStatement(m_stmts.erase_range, prefix, end_range);
 }
 
 bool SQLiteBatch::HasKey(DataStream&& key)
 {
     if (!m_database.m_db) return false;
-    assert(m_read_stmt);
+    assert(m_stmts.read);
 
     // Bind: leftmost parameter in statement is index 1
-    if (!BindBlobToStatement(m_read_stmt, 1, key, "key")) return false;
-    int res = sqlite3_step(m_read_stmt);
-    sqlite3_clear_bindings(m_read_stmt);
-    sqlite3_reset(m_read_stmt);
+    if (!BindBlobToStatement(m_stmts.read, 1, key, "key")) return false;
+    int res = sqlite3_step(m_stmts.read);
+    sqlite3_clear_bindings(m_stmts.read);
+    sqlite3_reset(m_stmts.read);
     return res == SQLITE_ROW;
 }
 
@@ -614,20 +753,7 @@ std::unique_ptr<DatabaseCursor> SQLiteBatch::GetNewPrefixCursor(Span<const std::
     // where the data must be greater than or equal to the prefix, and less than
     // the prefix incremented by one (when interpreted as an integer)
     std::vector<std::byte> start_range(prefix.begin(), prefix.end());
-    std::vector<std::byte> end_range(prefix.begin(), prefix.end());
-    auto it = end_range.rbegin();
-    for (; it != end_range.rend(); ++it) {
-        if (*it == std::byte(std::numeric_limits<unsigned char>::max())) {
-            *it = std::byte(0);
-            continue;
-        }
-        *it = std::byte(std::to_integer<unsigned char>(*it) + 1);
-        break;
-    }
-    if (it == end_range.rend()) {
-        // If the prefix is all 0xff bytes, clear end_range as we won't need it
-        end_range.clear();
-    }
+    std::vector<std::byte> end_range{PrefixRangeEnd(prefix)};
 
     auto cursor = std::make_unique<SQLiteCursor>(start_range, end_range);
     if (!cursor) return nullptr;
@@ -652,8 +778,9 @@ bool SQLiteBatch::TxnBegin()
 {
     if (!m_database.m_db || m_txn) return false;
     m_database.m_write_semaphore.wait();
-    Assert(!m_database.HasActiveTxn());
-    int res = Assert(m_exec_handler)->Exec(m_database, "BEGIN TRANSACTION");
+    // Inside a write group the batch transaction is a savepoint of the group's transaction
+    Assert(m_database.m_write_group == m_database.HasActiveTxn());
+    int res = Assert(m_exec_handler)->Exec(m_database, m_database.m_write_group ? "SAVEPOINT batch" : "BEGIN TRANSACTION");
     if (res != SQLITE_OK) {
         LogPrintf("SQLiteBatch: Failed to begin the transaction\n");
         m_database.m_write_semaphore.post();
@@ -667,7 +794,7 @@ bool SQLiteBatch::TxnCommit()
 {
     if (!m_database.m_db || !m_txn) return false;
     Assert(m_database.HasActiveTxn());
-    int res = Assert(m_exec_handler)->Exec(m_database, "COMMIT TRANSACTION");
+    int res = Assert(m_exec_handler)->Exec(m_database, m_database.m_write_group ? "RELEASE batch" : "COMMIT TRANSACTION");
     if (res != SQLITE_OK) {
         LogPrintf("SQLiteBatch: Failed to commit the transaction\n");
     } else {
@@ -681,7 +808,8 @@ bool SQLiteBatch::TxnAbort()
 {
     if (!m_database.m_db || !m_txn) return false;
     Assert(m_database.HasActiveTxn());
-    int res = Assert(m_exec_handler)->Exec(m_database, "ROLLBACK TRANSACTION");
+    // Rolling back to a savepoint keeps it open, so release it as well
+    int res = Assert(m_exec_handler)->Exec(m_database, m_database.m_write_group ? "ROLLBACK TO batch; RELEASE batch" : "ROLLBACK TRANSACTION");
     if (res != SQLITE_OK) {
         LogPrintf("SQLiteBatch: Failed to abort the transaction\n");
     } else {
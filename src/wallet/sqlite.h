@@ -8,6 +8,9 @@
 #include <sync.h>
 #include <wallet/db.h>
 
+#include <optional>
+#include <vector>
+
 struct bilingual_str;
 
 struct sqlite3_stmt;
@@ -45,6 +48,17 @@ public:
     virtual int Exec(SQLiteDatabase& database, const std::string& statement);
 };
 
+/** The prepared statements of a SQLiteBatch. Kept by the SQLiteDatabase when
+ * a batch is closed so that the next batch does not have to prepare them again. */
+struct SQLiteStatements {
+    sqlite3_stmt* read{nullptr};
+    sqlite3_stmt* insert{nullptr};
+    sqlite3_stmt* overwrite{nullptr};
+    sqlite3_stmt* erase{nullptr};
+    sqlite3_stmt* erase_range{nullptr};
+    sqlite3_stmt* erase_prefix{nullptr};
+};
+
 /** RAII class that provides access to a WalletDatabase */
 class SQLiteBatch : public DatabaseBatch
 {
@@ -52,11 +66,7 @@ private:
     SQLiteDatabase& m_database;
     std::unique_ptr<SQliteExecHandler> m_exec_handler{std::make_unique<SQliteExecHandler>()};
 
-    sqlite3_stmt* m_read_stmt{nullptr};
-    sqlite3_stmt* m_insert_stmt{nullptr};
-    sqlite3_stmt* m_overwrite_stmt{nullptr};
-    sqlite3_stmt* m_delete_stmt{nullptr};
-    sqlite3_stmt* m_delete_prefix_stmt{nullptr};
+    SQLiteStatements m_stmts;
 
     /** Whether this batch has started a database transaction and whether it owns SQLiteDatabase::m_write_semaphore.
      * If the batch starts a db tx, it acquires the semaphore and sets this to true, keeping the semaphore
@@ -71,7 +81,7 @@ private:
     bool m_txn{false};
 
     void SetupSQLStatements();
-    bool ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob);
+    bool ExecStatement(sqlite3_stmt* stmt, Span<const std::byte> blob, std::optional<Span<const std::byte>> blob2 = std::nullopt);
 
     bool ReadKey(DataStream&& key, DataStream& value) override;
     bool WriteKey(DataStream&& key, DataStream&& value, bool overwrite = true) override;
@@ -117,6 +127,10 @@ private:
     static Mutex g_sqlite_mutex;
     static int g_sqlite_count GUARDED_BY(g_sqlite_mutex);
 
+    //! Statements of closed batches, see SQLiteStatements
+    Mutex m_stmts_cache_mutex;
+    std::vector<SQLiteStatements> m_stmts_cache GUARDED_BY(m_stmts_cache_mutex);
+
     void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex);
 
 public:
@@ -150,18 +164,25 @@ public:
      */
     bool Backup(const std::string& dest) const override;
 
-    /** No-ops
-     *
-     * SQLite always flushes everything to the database file after each transaction
+    /** SQLite always flushes everything to the database file after each transaction
      * (each Read/Write/Erase that we do is its own transaction unless we called
-     * TxnBegin) so there is no need to have Flush or Periodic Flush.
+     * TxnBegin or BeginWriteGroup) so Flush and PeriodicFlush only have to
+     * checkpoint the write-ahead log when it is used.
      *
      * There is no DB env to reload, so ReloadDbEnv has nothing to do
      */
-    void Flush() override {}
-    bool PeriodicFlush() override { return false; }
+    void Flush() override;
+    bool PeriodicFlush() override;
     void ReloadDbEnv() override {}
 
+    bool BeginWriteGroup() override;
+    bool EndWriteGroup() override;
+
+    /** Return cached statements for a new batch, if any */
+    std::optional<SQLiteStatements> TakeStatements() EXCLUSIVE_LOCKS_REQUIRED(!m_stmts_cache_mutex);
+    /** Keep the statements of a closed batch for reuse, or finalize them if enough are cached */
+    void ReturnStatements(const SQLiteStatements& stmts) EXCLUSIVE_LOCKS_REQUIRED(!m_stmts_cache_mutex);
+
     void IncrementUpdateCounter() override { ++nUpdateCounter; }
 
     std::string Filename() override { return m_file_path; }
@@ -175,6 +196,11 @@ public:
 
     sqlite3* m_db{nullptr};
     bool m_use_unsafe_sync;
+    bool m_use_wal;
+
+    /** Whether BeginWriteGroup() has started a transaction that is still open.
+     * Only accessed while holding m_write_semaphore. */
+    bool m_write_group{false};
 };
 
 std::unique_ptr<SQLiteDatabase> MakeSQLiteDatabase(const fs::path& path, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error);
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <boost/test/unit_test.hpp>
+#include <limits>
 #include <random>
 
 namespace wallet {
@@ -201,6 +202,7 @@ BOOST_AUTO_TEST_CASE(bnb_search_test)
 
     // Empty utxo pool
     BOOST_CHECK(!SelectCoinsBnB(GroupCoins(utxo_pool), 1 * CENT, 0.5 * CENT));
+    BOOST_CHECK(!SelectCoinsBnB(GroupCoins(utxo_pool), 0, 0.5 * CENT));
 
     // Add utxos
     add_coin(1 * CENT, 1, utxo_pool);
@@ -259,6 +261,7 @@ BOOST_AUTO_TEST_CASE(bnb_search_test)
     BOOST_CHECK(result5);
     BOOST_CHECK(EquivalentResult(expected_result, *result5));
     BOOST_CHECK_EQUAL(result5->GetSelectedValue(), 10 * CENT);
+    BOOST_CHECK(result5->GetAlgoCompleted());
     expected_result.Clear();
 
     // Select 0.25 Cent, not possible
@@ -271,6 +274,7 @@ BOOST_AUTO_TEST_CASE(bnb_search_test)
     target = make_hard_case(14, utxo_pool);
     const auto result7 = SelectCoinsBnB(GroupCoins(utxo_pool), target, 1); // Should not exhaust
     BOOST_CHECK(result7);
+    BOOST_CHECK(result7->GetAlgoCompleted());
 
     // Test same value early bailout optimization
     utxo_pool.clear();
@@ -1394,6 +1398,57 @@ BOOST_AUTO_TEST_CASE(srd_tests)
     }
 }
 
+BOOST_AUTO_TEST_CASE(parallel_selection_test)
+{
+    // Pools of at least MIN_GROUPS_FOR_PARALLEL_SELECTION groups run BnB and
+    // CoinGrinder on their own threads. Check that this selects exactly the
+    // inputs that running every algorithm on this thread selects.
+    std::unique_ptr<CWallet> wallet = NewWallet(m_node);
+    CoinsResult available_coins;
+    for (int i = 0; i < int(MIN_GROUPS_FOR_PARALLEL_SELECTION) + 10; ++i) {
+        add_coin(available_coins, *wallet, CENT + i * 997, CFeeRate(5000), 144, false, 0, false, /*custom_size=*/68);
+    }
+
+    const auto choose = [&](const CAmount& target, size_t min_groups_for_parallel_selection) {
+        FastRandomContext rand{/*fDeterministic=*/true};
+        CoinSelectionParams cs_params{
+            rand,
+            /*change_output_size=*/34,
+            /*change_spend_size=*/68,
+            /*min_change_target=*/CENT,
+            /*effective_feerate=*/CFeeRate(5000),
+            /*long_term_feerate=*/CFeeRate(1000),
+            /*discard_feerate=*/CFeeRate(1000),
+            /*tx_noinputs_size=*/10 + 34,
+            /*avoid_partial=*/false,
+        };
+        cs_params.m_change_fee = cs_params.m_effective_feerate.GetFee(cs_params.change_output_size);
+        cs_params.m_cost_of_change = cs_params.m_discard_feerate.GetFee(cs_params.change_spend_size) + cs_params.m_change_fee;
+        cs_params.m_min_groups_for_parallel_selection = min_groups_for_parallel_selection;
+        CoinEligibilityFilter filter(0, 0, 0);
+        Groups groups = GroupOutputs(*wallet, available_coins, cs_params, {{filter}})[filter].all_groups;
+        BOOST_REQUIRE_GE(groups.positive_group.size(), MIN_GROUPS_FOR_PARALLEL_SELECTION);
+        return ChooseSelectionResult(*m_node.chain, target, groups, cs_params);
+    };
+    // Each selection groups the coins anew, so compare the selected outpoints
+    // rather than the COutput pointers EqualResult() looks at.
+    const auto outpoints = [](const SelectionResult& result) {
+        std::set<COutPoint> outpoints;
+        for (const auto& coin : result.GetInputSet()) outpoints.insert(coin->outpoint);
+        return outpoints;
+    };
+
+    for (const CAmount target : {CAmount{50 * CENT}, CAmount{2 * COIN}, CAmount{7 * COIN}}) {
+        const auto parallel{choose(target, MIN_GROUPS_FOR_PARALLEL_SELECTION)};
+        const auto sequential{choose(target, std::numeric_limits<size_t>::max())};
+        BOOST_REQUIRE(parallel);
+        BOOST_REQUIRE(sequential);
+        BOOST_CHECK(parallel->GetAlgo() == sequential->GetAlgo());
+        BOOST_CHECK_EQUAL(parallel->GetWaste(), sequential->GetWaste());
+        BOOST_CHECK(outpoints(*parallel) == outpoints(*sequential));
+    }
+}
+
 static util::Result<SelectionResult> select_coins(const CAmount& target, const CoinSelectionParams& cs_params, const CCoinControl& cc, std::function<CoinsResult(CWallet&)> coin_setup, const node::NodeContext& m_node)
 {
     std::unique_ptr<CWallet> wallet = NewWallet(m_node);
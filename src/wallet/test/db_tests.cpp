@@ -383,6 +383,48 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK(handler2->Read(key, read_value));
     BOOST_CHECK_EQUAL(read_value, value2);
 }
+
+BOOST_AUTO_TEST_CASE(write_group)
+{
+    std::string value = "value";
+
+    DatabaseOptions options;
+    options.use_wal = true;
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<SQLiteDatabase> database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_REQUIRE(database);
+
+    {
+        WriteGroup write_group{*database};
+        BOOST_CHECK(database->HasActiveTxn());
+        BOOST_CHECK(database->MakeBatch()->Write(std::string{"key"}, value));
+
+        // Batch transactions nest in the group and can still be aborted on their own
+        std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->Write(std::string{"key2"}, value));
+        BOOST_CHECK(batch->TxnAbort());
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->Write(std::string{"key3"}, value));
+        BOOST_CHECK(batch->TxnCommit());
+        BOOST_CHECK(database->HasActiveTxn());
+
+        // A second group can't be started while one is open
+        BOOST_CHECK(!database->BeginWriteGroup());
+    }
+    BOOST_CHECK(!database->HasActiveTxn());
+    BOOST_CHECK(database->PeriodicFlush());
+
+    // The group was committed, except for the aborted batch transaction
+    database->Close();
+    database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_REQUIRE(database);
+    std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+    BOOST_CHECK(batch->Exists(std::string{"key"}));
+    BOOST_CHECK(!batch->Exists(std::string{"key2"}));
+    BOOST_CHECK(batch->Exists(std::string{"key3"}));
+}
 #endif // USE_SQLITE
 
 BOOST_AUTO_TEST_SUITE_END()
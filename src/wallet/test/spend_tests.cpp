@@ -104,5 +104,96 @@ BOOST_FIXTURE_TEST_CASE(wallet_duplicated_preset_inputs_test, TestChain100Setup)
     BOOST_CHECK(!CreateTransaction(*wallet, recipients, /*change_pos=*/std::nullopt, coin_control));
 }
 
+BOOST_FIXTURE_TEST_CASE(send_queued_payouts, TestChain100Setup)
+{
+    // Mature a few coinbase outputs, as each batch spends one of them
+    for (int i = 0; i < 3; ++i) {
+        CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    }
+    auto wallet = CreateSyncedWallet(*m_node.chain, WITH_LOCK(Assert(m_node.chainman)->GetMutex(), return m_node.chainman->ActiveChain()), coinbaseKey);
+    wallet->m_payout_window = 60s;
+    const auto now{GetTime<std::chrono::seconds>()};
+    SetMockTime(now);
+
+    const std::vector<CAmount> amounts{1 * COIN, 2 * COIN, 3 * COIN};
+    std::vector<uint64_t> ids;
+    for (const CAmount amount : amounts) {
+        ids.push_back(*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), amount, /*fSubtractFeeFromAmount=*/false})));
+    }
+    // Outputs that would not be accepted are rejected when queued
+    BOOST_CHECK(!wallet->QueuePayout(CRecipient{PubKeyDestination({}), 1, /*fSubtractFeeFromAmount=*/false}));
+    BOOST_CHECK(!wallet->QueuePayout(CRecipient{PubKeyDestination({}), 0, /*fSubtractFeeFromAmount=*/false}));
+
+    // Nothing is sent before the oldest payout waited for the window
+    SetMockTime(now + 59s);
+    PayoutFailure failure;
+    const auto none{SendQueuedPayouts(*wallet, /*force=*/false, failure)};
+    BOOST_REQUIRE(none);
+    BOOST_CHECK(!*none);
+    BOOST_CHECK(wallet->GetPayout(ids[0])->status == Payout::Status::QUEUED);
+
+    // Then all payouts are paid by one transaction
+    SetMockTime(now + 60s);
+    const auto res{SendQueuedPayouts(*wallet, /*force=*/false, failure)};
+    BOOST_REQUIRE(res && *res);
+    const CTransactionRef tx{*res};
+    BOOST_CHECK_EQUAL(tx->vout.size(), amounts.size() + 1);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const std::optional<Payout> payout{wallet->GetPayout(ids[i])};
+        BOOST_REQUIRE(payout);
+        BOOST_CHECK(payout->status == Payout::Status::SENT);
+        BOOST_CHECK_EQUAL(payout->outpoint.hash, tx->GetHash());
+        BOOST_CHECK_EQUAL(tx->vout.at(payout->outpoint.n).nValue, amounts[i]);
+    }
+    BOOST_CHECK(WITH_LOCK(wallet->cs_wallet, return wallet->GetWalletTx(tx->GetHash())));
+
+    // A batch the wallet cannot fund yet stays queued, and is only retried
+    // after another window unless forced
+    const uint64_t too_large{*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), MAX_MONEY, /*fSubtractFeeFromAmount=*/false}))};
+    BOOST_CHECK(!SendQueuedPayouts(*wallet, /*force=*/true, failure));
+    BOOST_CHECK(failure == PayoutFailure::INSUFFICIENT_FUNDS);
+    BOOST_CHECK(wallet->GetPayout(too_large)->status == Payout::Status::QUEUED);
+    BOOST_CHECK(!wallet->GetPayout(too_large)->error.empty());
+    SetMockTime(now + 60s + 59s);
+    const auto retry{SendQueuedPayouts(*wallet, /*force=*/false, failure)};
+    BOOST_REQUIRE(retry);
+    BOOST_CHECK(!*retry);
+    BOOST_CHECK(wallet->TakeQueuedPayouts(/*force=*/true).size() == 1);
+
+    // The payouts the balance covers are sent without the one it does not
+    const uint64_t unfundable{*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), MAX_MONEY, /*fSubtractFeeFromAmount=*/false}))};
+    const uint64_t fundable{*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), COIN, /*fSubtractFeeFromAmount=*/false}))};
+    const auto partial{SendQueuedPayouts(*wallet, /*force=*/true, failure)};
+    BOOST_REQUIRE(partial && *partial);
+    BOOST_CHECK(wallet->GetPayout(fundable)->status == Payout::Status::SENT);
+    BOOST_CHECK(wallet->GetPayout(unfundable)->status == Payout::Status::QUEUED);
+    const auto left{wallet->TakeQueuedPayouts(/*force=*/true)};
+    BOOST_REQUIRE_EQUAL(left.size(), 1U);
+    BOOST_CHECK_EQUAL(left[0].first, unfundable);
+
+    // Other failures fail all payouts of the batch: here the fee is above -maxtxfee.
+    wallet->m_pay_tx_fee = CFeeRate{COIN / 100};
+    wallet->m_default_max_tx_fee = 1;
+    const uint64_t over_max_fee{*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), COIN, /*fSubtractFeeFromAmount=*/false}))};
+    BOOST_CHECK(!SendQueuedPayouts(*wallet, /*force=*/true, failure));
+    BOOST_CHECK(failure == PayoutFailure::WALLET_ERROR);
+    BOOST_CHECK(wallet->GetPayout(over_max_fee)->status == Payout::Status::FAILED);
+    BOOST_CHECK(!wallet->GetPayout(over_max_fee)->error.empty());
+    wallet->m_pay_tx_fee = CFeeRate{DEFAULT_PAY_TX_FEE};
+    wallet->m_default_max_tx_fee = DEFAULT_TRANSACTION_MAXFEE;
+
+    // Payouts of a locked wallet stay queued until it is unlocked
+    BOOST_REQUIRE(wallet->EncryptWallet("passphrase"));
+    BOOST_REQUIRE(wallet->IsLocked());
+    const uint64_t locked{*Assert(wallet->QueuePayout(CRecipient{PubKeyDestination({}), COIN, /*fSubtractFeeFromAmount=*/false}))};
+    BOOST_CHECK(!SendQueuedPayouts(*wallet, /*force=*/true, failure));
+    BOOST_CHECK(failure == PayoutFailure::WALLET_LOCKED);
+    BOOST_CHECK(wallet->GetPayout(locked)->status == Payout::Status::QUEUED);
+    BOOST_REQUIRE(wallet->Unlock("passphrase"));
+    const auto unlocked{SendQueuedPayouts(*wallet, /*force=*/true, failure)};
+    BOOST_REQUIRE(unlocked && *unlocked);
+    BOOST_CHECK(wallet->GetPayout(locked)->status == Payout::Status::SENT);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -642,6 +642,115 @@ BOOST_FIXTURE_TEST_CASE(ListCoinsTest, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2U);
 }
 
+//! Check that the unspent output index matches a full scan of mapWallet.
+static void CheckUnspentTXOs(const CWallet& wallet) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet)
+{
+    const auto& unspent_txos{wallet.GetUnspentTXOs()};
+    size_t num_unspent{0};
+    for (const auto& [txid, wtx] : wallet.mapWallet) {
+        for (uint32_t n = 0; n < wtx.tx->vout.size(); ++n) {
+            const bool unspent{wallet.IsMine(wtx.tx->vout[n]) != ISMINE_NO && !wallet.IsSpent(COutPoint{wtx.GetHash(), n})};
+            const auto it{unspent_txos.find(txid)};
+            BOOST_CHECK_EQUAL(unspent, it != unspent_txos.end() && it->second.count(n) > 0);
+            num_unspent += unspent;
+        }
+    }
+    size_t num_indexed{0};
+    for (const auto& [txid, outputs] : unspent_txos) num_indexed += outputs.size();
+    BOOST_CHECK_EQUAL(num_indexed, num_unspent);
+}
+
+BOOST_FIXTURE_TEST_CASE(unspent_txo_index, ListCoinsTestingSetup)
+{
+    COutPoint spent_coin;
+    {
+        LOCK(wallet->cs_wallet);
+        CheckUnspentTXOs(*wallet);
+        // One mature and 100 immature coinbase outputs
+        BOOST_CHECK_EQUAL(wallet->GetUnspentTXOs().size(), 101U);
+    }
+
+    // Spending the mature coin drops it from the index and adds the change
+    const CWalletTx& wtx = AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    {
+        LOCK(wallet->cs_wallet);
+        spent_coin = wtx.tx->vin[0].prevout;
+        CheckUnspentTXOs(*wallet);
+        BOOST_CHECK(!wallet->GetUnspentTXOs().count(spent_coin.hash));
+        BOOST_CHECK_EQUAL(wallet->GetUnspentTXOs().at(wtx.GetHash()).size(), 1U);
+        BOOST_CHECK_EQUAL(AvailableCoins(*wallet).Size(), 2U);
+    }
+
+    // Removing the spender makes the coin available again
+    {
+        LOCK(wallet->cs_wallet);
+        std::vector<uint256> to_remove{wtx.GetHash()};
+        BOOST_CHECK(wallet->RemoveTxs(to_remove));
+        CheckUnspentTXOs(*wallet);
+        BOOST_CHECK(wallet->GetUnspentTXOs().count(spent_coin.hash));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(cached_balance, ListCoinsTestingSetup)
+{
+    // Balances are served from the cache until something changes
+    const CAmount subsidy{m_coinbase_txns.back()->vout[0].nValue};
+    const Balance initial{GetBalance(*wallet)};
+    BOOST_CHECK_EQUAL(initial.m_mine_trusted, subsidy);
+    BOOST_CHECK_EQUAL(initial.m_mine_immature, 100 * subsidy);
+    BOOST_CHECK(WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/0, /*avoid_reuse=*/true)));
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/1, /*avoid_reuse=*/true)));
+
+    // A new transaction and block update the balance
+    AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(!WITH_LOCK(wallet->cs_wallet, return wallet->GetCachedBalance(/*min_depth=*/0, /*avoid_reuse=*/true)));
+    const Balance updated{GetBalance(*wallet)};
+    BOOST_CHECK_GT(updated.m_mine_trusted, initial.m_mine_trusted);
+
+    // And matches a full recomputation
+    wallet->MarkDirty();
+    const Balance recomputed{GetBalance(*wallet)};
+    BOOST_CHECK_EQUAL(updated.m_mine_trusted, recomputed.m_mine_trusted);
+    BOOST_CHECK_EQUAL(updated.m_mine_untrusted_pending, recomputed.m_mine_untrusted_pending);
+    BOOST_CHECK_EQUAL(updated.m_mine_immature, recomputed.m_mine_immature);
+}
+
+BOOST_FIXTURE_TEST_CASE(cached_balance_top_up, TestingSetup)
+{
+    CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    wallet.m_keypool_size = 1;
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+
+    // Receive to a derived address and to one beyond the keypool
+    const auto dest{*Assert(wallet.GetNewDestination(OutputType::BECH32M, ""))};
+    auto* spkm{Assert(dynamic_cast<DescriptorScriptPubKeyMan*>(wallet.GetScriptPubKeyMan(OutputType::BECH32M, /*internal=*/false)))};
+    const WalletDescriptor w_desc{WITH_LOCK(spkm->cs_desc_man, return spkm->GetWalletDescriptor())};
+    std::vector<CScript> scripts;
+    FlatSigningProvider out_keys;
+    BOOST_REQUIRE(w_desc.descriptor->ExpandFromCache(/*pos=*/10, w_desc.cache, scripts, out_keys));
+    BOOST_CHECK(!wallet.IsMine(scripts[0]));
+
+    CMutableTransaction mtx;
+    mtx.vin.emplace_back(Txid::FromUint256(g_insecure_rand_ctx.rand256()), 0);
+    mtx.vout.emplace_back(1 * COIN, GetScriptForDestination(dest));
+    mtx.vout.emplace_back(2 * COIN, scripts[0]);
+    const CTransactionRef tx{MakeTransactionRef(mtx)};
+    wallet.AddToWallet(tx, TxStateInMempool{});
+    BOOST_CHECK_EQUAL(GetBalance(wallet).m_mine_untrusted_pending, 1 * COIN);
+
+    // Deriving the script makes the cached balance and unspent outputs include the output paying it
+    BOOST_REQUIRE(wallet.TopUpKeyPool(20));
+    BOOST_CHECK(wallet.IsMine(scripts[0]));
+    BOOST_CHECK_EQUAL(GetBalance(wallet).m_mine_untrusted_pending, 3 * COIN);
+    LOCK(wallet.cs_wallet);
+    BOOST_CHECK_EQUAL(wallet.GetUnspentTXOs().at(tx->GetHash()).size(), 2U);
+}
+
 void TestCoinsResult(ListCoinsTest& context, OutputType out_type, CAmount amount,
                      std::map<OutputType, size_t>& expected_coins_sizes)
 {
@@ -83,6 +83,41 @@ BOOST_FIXTURE_TEST_CASE(wallet_load_descriptors, TestingSetup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(wallet_load_txs, TestingSetup)
+{
+    // Enough records to be read in more than one batch and deserialized on several threads
+    constexpr int NUM_TXS{12000};
+    std::unique_ptr<WalletDatabase> database = CreateMockableWalletDatabase();
+    std::vector<Txid> txids;
+    {
+        WalletBatch batch(*database, false);
+        for (int i = 0; i < NUM_TXS; ++i) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint{Txid{}, uint32_t(i)});
+            mtx.vout.emplace_back(i + 1, CScript() << OP_TRUE);
+            CWalletTx wtx{MakeTransactionRef(mtx), TxStateInactive{}};
+            wtx.nOrderPos = NUM_TXS - i;
+            wtx.mapValue["comment"] = strprintf("tx %d", i);
+            BOOST_CHECK(batch.WriteTx(wtx));
+            txids.push_back(wtx.GetHash());
+        }
+    }
+
+    const std::shared_ptr<CWallet> wallet(new CWallet(m_node.chain.get(), "", std::move(database)));
+    BOOST_CHECK_EQUAL(wallet->LoadWallet(), DBErrors::LOAD_OK);
+    LOCK(wallet->cs_wallet);
+    BOOST_CHECK_EQUAL(wallet->mapWallet.size(), size_t{NUM_TXS});
+    BOOST_CHECK_EQUAL(wallet->wtxOrdered.size(), size_t{NUM_TXS});
+    for (int i = 0; i < NUM_TXS; ++i) {
+        const CWalletTx& wtx{wallet->mapWallet.at(txids[i])};
+        BOOST_CHECK_EQUAL(wtx.tx->vout[0].nValue, i + 1);
+        BOOST_CHECK_EQUAL(wtx.nOrderPos, NUM_TXS - i);
+        BOOST_CHECK_EQUAL(wtx.mapValue.at("comment"), strprintf("tx %d", i));
+        BOOST_CHECK(wtx.m_it_wtxOrdered->second == &wtx);
+    }
+    BOOST_CHECK(wallet->wtxOrdered.begin()->second->GetHash() == txids.back());
+}
+
 bool HasAnyRecordOfType(WalletDatabase& db, const std::string& key)
 {
     std::unique_ptr<DatabaseBatch> batch = db.MakeBatch(false);
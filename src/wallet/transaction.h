@@ -317,8 +317,8 @@ public:
         tx = std::move(arg);
     }
 
-    //! make sure balances are recalculated
-    void MarkDirty()
+    //! make sure balances are recalculated; only resets the mutable caches
+    void MarkDirty() const
     {
         m_amounts[DEBIT].Reset();
         m_amounts[CREDIT].Reset();
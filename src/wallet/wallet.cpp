@@ -30,6 +30,7 @@
 #include <node/types.h>
 #include <outputtype.h>
 #include <policy/feerate.h>
+#include <policy/policy.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <psbt.h>
@@ -57,6 +58,7 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -73,6 +75,7 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <exception>
 #include <optional>
 #include <stdexcept>
@@ -359,6 +362,204 @@ private:
         }
     }
 };
+
+//! Number of blocks read ahead of the block being rescanned
+static constexpr int RESCAN_PREFETCH_BLOCKS{16};
+//! Maximum number of threads reading and matching blocks during a rescan
+static constexpr int MAX_RESCAN_THREADS{4};
+
+/**
+ * Reads blocks ahead of a rescan on worker threads, and matches their outputs
+ * against the wallet's ScriptPubKeyMans there, so the rescan loop does not wait
+ * on disk reads and only hands transactions that may involve the wallet to
+ * SyncTransaction under cs_wallet.
+ *
+ * Block positions are looked up by the rescan thread and workers never lock
+ * cs_main, as the rescan may be running with it held.
+ *
+ * Output matches are only valid as long as the rescan has not added anything to
+ * the wallet since they were computed, as that may have topped up keypools. The
+ * rescan loop calls WalletUpdated() after such blocks, which invalidates matches
+ * computed before.
+ */
+class RescanBlockPrefetcher
+{
+public:
+    struct Item {
+        uint256 hash;
+        int height;
+        int file_number;
+        unsigned data_pos;
+        CBlock block;
+        //! Whether any output of each transaction in block is ours
+        std::vector<bool> output_is_mine;
+        //! WalletGeneration() at the time output_is_mine was computed
+        uint64_t match_generation{0};
+        bool done{false};
+    };
+
+    RescanBlockPrefetcher(const CWallet& wallet, int threads, int depth)
+        : m_wallet{wallet}, m_depth{depth}
+    {
+        // Descriptor scripts are matched through the wallet's scriptPubKey cache
+        if (m_wallet.IsLegacy()) m_legacy_spkm = m_wallet.GetLegacyScriptPubKeyMan();
+        m_workers.reserve(threads);
+        for (int n = 0; n < threads; ++n) {
+            m_workers.emplace_back([this, n]() {
+                util::ThreadRename(strprintf("rescan.%i", n));
+                Loop();
+            });
+        }
+    }
+
+    ~RescanBlockPrefetcher()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_work_cv.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    RescanBlockPrefetcher(const RescanBlockPrefetcher&) = delete;
+    RescanBlockPrefetcher& operator=(const RescanBlockPrefetcher&) = delete;
+
+    /** Queue the blocks following the one at height, up to m_depth blocks ahead of it. */
+    void Fill(const uint256& hash, int height, std::optional<int> max_height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (m_next_height <= height) {
+            // Nothing queued ahead of the block being scanned (start of the
+            // scan, reorg, or tip reached earlier), restart from it.
+            Clear();
+            m_next_hash = hash;
+            m_next_height = height;
+            m_have_next = true;
+        }
+        while (m_have_next && m_next_height < height + m_depth && (!max_height || m_next_height <= *max_height)) {
+            int file_number{-1};
+            unsigned data_pos{0};
+            bool have_next{false};
+            uint256 next_hash;
+            m_wallet.chain().findBlock(m_next_hash, FoundBlock().diskPos(file_number, data_pos).nextBlock(FoundBlock().inActiveChain(have_next).hash(next_hash)));
+            Push(m_next_hash, m_next_height, file_number, data_pos);
+            m_have_next = have_next;
+            m_next_hash = next_hash;
+            ++m_next_height;
+        }
+    }
+
+    /** Wait for and return the queued block at height, dropping anything queued
+     *  before it. Returns nullptr if that block was not queued. */
+    std::shared_ptr<Item> Pop(const uint256& hash, int height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_queue.empty() && m_queue.front()->height < height) {
+            m_queue.pop_front();
+        }
+        if (m_queue.empty() || m_queue.front()->height != height) return nullptr;
+        if (m_queue.front()->hash != hash) {
+            // The chain was reorganized since the block was queued.
+            m_queue.clear();
+            m_pending.clear();
+            m_next_height = 0;
+            return nullptr;
+        }
+        std::shared_ptr<Item> item{std::move(m_queue.front())};
+        m_queue.pop_front();
+        m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return item->done; });
+        return item;
+    }
+
+    /** Invalidate output matches computed so far. */
+    void WalletUpdated() { ++m_wallet_generation; }
+    uint64_t WalletGeneration() const { return m_wallet_generation; }
+
+private:
+    const CWallet& m_wallet;
+    const int m_depth;
+    const ScriptPubKeyMan* m_legacy_spkm{nullptr};
+
+    Mutex m_mutex;
+    //! Signalled when blocks are queued or on shutdown
+    std::condition_variable m_work_cv;
+    //! Signalled when a worker finished reading a block
+    std::condition_variable m_done_cv;
+    //! All queued blocks, in chain order
+    std::deque<std::shared_ptr<Item>> m_queue GUARDED_BY(m_mutex);
+    //! Queued blocks not yet picked up by a worker
+    std::deque<std::shared_ptr<Item>> m_pending GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::atomic<uint64_t> m_wallet_generation{0};
+    std::vector<std::thread> m_workers;
+
+    //! Next block to queue. Only accessed by the rescan thread.
+    uint256 m_next_hash;
+    int m_next_height{0};
+    bool m_have_next{false};
+
+    void Push(const uint256& hash, int height, int file_number, unsigned data_pos) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        auto item{std::make_shared<Item>()};
+        item->hash = hash;
+        item->height = height;
+        item->file_number = file_number;
+        item->data_pos = data_pos;
+        {
+            LOCK(m_mutex);
+            m_queue.push_back(item);
+            m_pending.push_back(std::move(item));
+        }
+        m_work_cv.notify_one();
+    }
+
+    void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_queue.clear();
+        m_pending.clear();
+    }
+
+    void Loop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::shared_ptr<Item> item;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_pending.empty(); });
+                if (m_stop) return;
+                item = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+
+            // A block that could not be read is left null, and read again by
+            // the rescan loop.
+            CBlock block;
+            if (!m_wallet.chain().readBlockFromDisk(item->file_number, item->data_pos, block) || block.GetHash() != item->hash) {
+                block.SetNull();
+            }
+            // Read the generation before matching, so that matches racing with a
+            // keypool top-up are treated as stale.
+            const uint64_t generation{m_wallet_generation};
+            std::vector<bool> output_is_mine;
+            output_is_mine.reserve(block.vtx.size());
+            for (const CTransactionRef& tx : block.vtx) {
+                output_is_mine.push_back(std::any_of(tx->vout.begin(), tx->vout.end(), [&](const CTxOut& txout) {
+                    return m_wallet.IsCachedScriptPubKey(txout.scriptPubKey) ||
+                           (m_legacy_spkm && m_legacy_spkm->IsMine(txout.scriptPubKey) != ISMINE_NO);
+                }));
+            }
+
+            {
+                LOCK(m_mutex);
+                item->block = std::move(block);
+                item->output_is_mine = std::move(output_is_mine);
+                item->match_generation = generation;
+                item->done = true;
+            }
+            m_done_cv.notify_all();
+        }
+    }
+};
 } // namespace
 
 std::shared_ptr<CWallet> LoadWallet(WalletContext& context, const std::string& name, std::optional<bool> load_on_start, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error, std::vector<bilingual_str>& warnings)
@@ -974,6 +1175,29 @@ void CWallet::MarkDirty()
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
     }
+    MarkBalancesDirty();
+}
+
+std::optional<Balance> CWallet::GetCachedBalance(int min_depth, bool avoid_reuse) const
+{
+    AssertLockHeld(cs_wallet);
+    RefreshNewScriptPubKeyTXOs();
+    if (m_cached_balances_generation != m_balances_generation) return std::nullopt;
+    auto it = m_cached_balances.find({min_depth, avoid_reuse});
+    if (it == m_cached_balances.end()) return std::nullopt;
+    return it->second;
+}
+
+void CWallet::CacheBalance(int min_depth, bool avoid_reuse, uint64_t balances_generation, const Balance& balance) const
+{
+    AssertLockHeld(cs_wallet);
+    // Don't cache a balance that was computed before a change
+    if (balances_generation != m_balances_generation) return;
+    if (m_cached_balances_generation != balances_generation) {
+        m_cached_balances.clear();
+        m_cached_balances_generation = balances_generation;
+    }
+    m_cached_balances[{min_depth, avoid_reuse}] = balance;
 }
 
 bool CWallet::MarkReplaced(const uint256& originalHash, const uint256& newHash)
@@ -994,6 +1218,7 @@ bool CWallet::MarkReplaced(const uint256& originalHash, const uint256& newHash)
 
     // Refresh mempool status without waiting for transactionRemovedFromMempool or transactionAddedToMempool
     RefreshMempoolStatus(wtx, chain());
+    MarkBalancesDirty();
 
     WalletBatch batch(GetDatabase());
 
@@ -1141,6 +1366,8 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
         }
     }
 
+    RefreshTXOsFromTx(wtx);
+
     //// debug print
     WalletLogPrintf("AddToWallet %s  %s%s %s\n", hash.ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""), TxStateString(state));
 
@@ -1151,6 +1378,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    MarkBalancesDirty();
 
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1297,8 +1525,91 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
+            RefreshTXO(it->second, txin.prevout.n);
+        }
+    }
+    MarkBalancesDirty();
+}
+
+void CWallet::RefreshTXO(const CWalletTx& wtx, uint32_t n) const
+{
+    AssertLockHeld(cs_wallet);
+    // The whole index is rebuilt on next use anyway
+    if (m_unspent_txos_stale) return;
+
+    if (n < wtx.tx->vout.size() && IsMine(wtx.tx->vout[n]) == ISMINE_NO) {
+        m_unowned_txo_scripts[wtx.tx->vout[n].scriptPubKey].insert(wtx.GetHash());
+    } else if (n < wtx.tx->vout.size() && !IsSpent(COutPoint(wtx.GetHash(), n))) {
+        m_unspent_txos[wtx.GetHash()].insert(n);
+        return;
+    }
+    auto it = m_unspent_txos.find(wtx.GetHash());
+    if (it == m_unspent_txos.end()) return;
+    it->second.erase(n);
+    if (it->second.empty()) m_unspent_txos.erase(it);
+}
+
+void CWallet::RefreshTXOsFromTx(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    for (uint32_t n = 0; n < wtx.tx->vout.size(); ++n) {
+        RefreshTXO(wtx, n);
+    }
+    // The outputs this transaction spends may have become spent or unspent
+    // with its new state.
+    for (const CTxIn& txin : wtx.tx->vin) {
+        auto it = mapWallet.find(txin.prevout.hash);
+        if (it != mapWallet.end()) {
+            RefreshTXO(it->second, txin.prevout.n);
+        }
+    }
+}
+
+const CWallet::UnspentTXOs& CWallet::GetUnspentTXOs() const
+{
+    AssertLockHeld(cs_wallet);
+    if (m_unspent_txos_stale.exchange(false)) {
+        // Outputs paying to scripts derived so far are found by the rebuild
+        WITH_LOCK(m_cached_spks_mutex, m_new_spks.clear());
+        m_unspent_txos.clear();
+        m_unowned_txo_scripts.clear();
+        for (const auto& [txid, wtx] : mapWallet) {
+            // The credits cached by the transaction may be missing outputs
+            // that became ours as well.
+            wtx.MarkDirty();
+            for (uint32_t n = 0; n < wtx.tx->vout.size(); ++n) {
+                RefreshTXO(wtx, n);
+            }
+        }
+    }
+    RefreshNewScriptPubKeyTXOs();
+    return m_unspent_txos;
+}
+
+void CWallet::RefreshNewScriptPubKeyTXOs() const
+{
+    AssertLockHeld(cs_wallet);
+    std::set<CScript> new_spks;
+    WITH_LOCK(m_cached_spks_mutex, new_spks.swap(m_new_spks));
+    // The whole index is rebuilt on next use anyway
+    if (m_unspent_txos_stale) return;
+
+    bool found{false};
+    for (const CScript& script : new_spks) {
+        const auto node{m_unowned_txo_scripts.extract(script)};
+        if (node.empty()) continue;
+        for (const uint256& txid : node.mapped()) {
+            const auto it{mapWallet.find(txid)};
+            if (it == mapWallet.end()) continue;
+            // The credits cached by the transaction are missing the output
+            it->second.MarkDirty();
+            for (uint32_t n = 0; n < it->second.tx->vout.size(); ++n) {
+                if (it->second.tx->vout[n].scriptPubKey == script) RefreshTXO(it->second, n);
+            }
+            found = true;
         }
     }
+    if (found) MarkBalancesDirty();
 }
 
 bool CWallet::AbandonTransaction(const uint256& hashTx)
@@ -1389,6 +1700,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
         TxUpdate update_state = try_updating_state(wtx);
         if (update_state != TxUpdate::UNCHANGED) {
             wtx.MarkDirty();
+            MarkBalancesDirty();
             if (batch) batch->WriteTx(wtx);
             // Iterate over all its outputs, and update those tx states as well (if applicable)
             for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
@@ -1411,6 +1723,15 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
     }
 }
 
+bool CWallet::IsRelatedToWalletTxs(const CTransaction& tx) const
+{
+    AssertLockHeld(cs_wallet);
+    if (mapWallet.count(tx.GetHash())) return true;
+    return std::any_of(tx.vin.begin(), tx.vin.end(), [&](const CTxIn& txin) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+        return mapWallet.count(txin.prevout.hash) || mapTxSpends.count(txin.prevout);
+    });
+}
+
 void CWallet::SyncTransaction(const CTransactionRef& ptx, const SyncTxState& state, bool update_tx, bool rescanning_old_block)
 {
     if (!AddToWalletIfInvolvingMe(ptx, state, update_tx, rescanning_old_block))
@@ -1429,6 +1750,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        MarkBalancesDirty();
     }
 
     const Txid& txid = tx->GetHash();
@@ -1451,6 +1773,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        MarkBalancesDirty();
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1508,12 +1831,15 @@ void CWallet::blockConnected(ChainstateRole role, const interfaces::BlockInfo& b
 
     m_last_block_processed_height = block.height;
     m_last_block_processed = block.hash;
+    // Depths and coinbase maturity change with the tip
+    MarkBalancesDirty();
 
     // No need to scan block if it was created before the wallet birthday.
     // Uses chain max time and twice the grace period to adjust time for block time variability.
     if (block.chain_time_max < m_birth_time.load() - (TIMESTAMP_WINDOW * 2)) return;
 
-    // Scan block
+    // Scan block, committing the wallet transactions it adds or updates together
+    WriteGroup write_group{GetDatabase()};
     for (size_t index = 0; index < block.data->vtx.size(); index++) {
         SyncTransaction(block.data->vtx[index], TxStateConfirmed{block.hash, block.height, static_cast<int>(index)});
         transactionRemovedFromMempool(block.data->vtx[index], MemPoolRemovalReason::BLOCK);
@@ -1531,9 +1857,11 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
     // future with a stickier abandoned state or even removing abandontransaction call.
     m_last_block_processed_height = block.height - 1;
     m_last_block_processed = *Assert(block.prev_hash);
+    MarkBalancesDirty();
 
     int disconnect_height = block.height;
 
+    WriteGroup write_group{GetDatabase()};
     for (const CTransactionRef& ptx : Assert(block.data)->vtx) {
         SyncTransaction(ptx, TxStateInactive{});
 
@@ -1613,16 +1941,9 @@ isminetype CWallet::IsMine(const CScript& script) const
 {
     AssertLockHeld(cs_wallet);
 
-    // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        isminetype res = ISMINE_NO;
-        for (const auto& spkm : it->second) {
-            res = std::max(res, spkm->IsMine(script));
-        }
-        Assume(res == ISMINE_SPENDABLE);
-        return res;
-    }
+    // Scripts are only cached for descriptor SPKMs, which consider all of
+    // their scripts spendable, so a hit answers without asking any SPKM.
+    if (IsCachedScriptPubKey(script)) return ISMINE_SPENDABLE;
 
     // Legacy wallet
     if (IsLegacy()) return GetLegacyScriptPubKeyMan()->IsMine(script);
@@ -1760,7 +2081,11 @@ bool CWallet::ImportScripts(const std::set<CScript> scripts, int64_t timestamp)
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportScripts(scripts, timestamp);
+    if (!spk_man->ImportScripts(scripts, timestamp)) {
+        return false;
+    }
+    MarkUnspentTXOsDirty();
+    return true;
 }
 
 bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const int64_t timestamp)
@@ -1770,7 +2095,11 @@ bool CWallet::ImportPrivKeys(const std::map<CKeyID, CKey>& privkey_map, const in
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPrivKeys(privkey_map, timestamp);
+    if (!spk_man->ImportPrivKeys(privkey_map, timestamp)) {
+        return false;
+    }
+    MarkUnspentTXOsDirty();
+    return true;
 }
 
 bool CWallet::ImportPubKeys(const std::vector<CKeyID>& ordered_pubkeys, const std::map<CKeyID, CPubKey>& pubkey_map, const std::map<CKeyID, std::pair<CPubKey, KeyOriginInfo>>& key_origins, const bool add_keypool, const bool internal, const int64_t timestamp)
@@ -1780,7 +2109,11 @@ bool CWallet::ImportPubKeys(const std::vector<CKeyID>& ordered_pubkeys, const st
         return false;
     }
     LOCK(spk_man->cs_KeyStore);
-    return spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, internal, timestamp);
+    if (!spk_man->ImportPubKeys(ordered_pubkeys, pubkey_map, key_origins, add_keypool, internal, timestamp)) {
+        return false;
+    }
+    MarkUnspentTXOsDirty();
+    return true;
 }
 
 bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScript>& script_pub_keys, const bool have_solving_data, const bool apply_label, const int64_t timestamp)
@@ -1793,6 +2126,7 @@ bool CWallet::ImportScriptPubKeys(const std::string& label, const std::set<CScri
     if (!spk_man->ImportScriptPubKeys(script_pub_keys, have_solving_data, timestamp)) {
         return false;
     }
+    MarkUnspentTXOsDirty();
     if (apply_label) {
         WalletBatch batch(GetDatabase());
         for (const CScript& script : script_pub_keys) {
@@ -1880,6 +2214,13 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
     if (!IsLegacy() && chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
 
+    // Without block filters every block is read, so read and match them ahead
+    // of time. With filters most blocks are skipped and reads are rare.
+    std::unique_ptr<RescanBlockPrefetcher> prefetcher;
+    if (!fast_rescan_filter) {
+        prefetcher = std::make_unique<RescanBlockPrefetcher>(*this, std::clamp(GetNumCores() - 1, 1, MAX_RESCAN_THREADS), RESCAN_PREFETCH_BLOCKS);
+    }
+
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
 
@@ -1892,6 +2233,8 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     double progress_end = chain().guessVerificationProgress(end_hash);
     double progress_current = progress_begin;
     int block_height = start_height;
+    int interval_start_height = start_height;
+    int blocks_scanned = 0;
     while (!fAbortRescan && !chain().shutdownRequested()) {
         if (progress_end - progress_begin > 0.0) {
             m_scanning_progress = (progress_current - progress_begin) / (progress_end - progress_begin);
@@ -1904,8 +2247,11 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 
         bool next_interval = reserver.now() >= current_time + INTERVAL_TIME;
         if (next_interval) {
+            const auto interval_start_time{current_time};
             current_time = reserver.now();
-            WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
+            WalletLogPrintf("Still rescanning. At block %d. Progress=%f (%.1f blocks/s)\n", block_height, progress_current,
+                            (block_height - interval_start_height) / std::max(Ticks<SecondsDouble>(current_time - interval_start_time), 1e-3));
+            interval_start_height = block_height;
         }
 
         bool fetch_block{true};
@@ -1933,9 +2279,19 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         chain().findBlock(block_hash, FoundBlock().inActiveChain(block_still_active).nextBlock(FoundBlock().inActiveChain(next_block).hash(next_block_hash)));
 
         if (fetch_block) {
-            // Read block data
+            // Read block data, from the prefetcher if it got to it
             CBlock block;
-            chain().findBlock(block_hash, FoundBlock().data(block));
+            std::vector<bool> output_is_mine;
+            if (prefetcher) {
+                prefetcher->Fill(block_hash, block_height, max_height);
+                if (auto item{prefetcher->Pop(block_hash, block_height)}) {
+                    block = std::move(item->block);
+                    if (item->match_generation == prefetcher->WalletGeneration()) {
+                        output_is_mine = std::move(item->output_is_mine);
+                    }
+                }
+            }
+            if (block.IsNull()) chain().findBlock(block_hash, FoundBlock().data(block));
 
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
@@ -1946,9 +2302,18 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     result.status = ScanResult::FAILURE;
                     break;
                 }
+                bool synced_any{false};
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
+                    // With precomputed output matches, skip transactions that
+                    // AddToWalletIfInvolvingMe would not act on.
+                    if (!output_is_mine.empty() && !output_is_mine[posInBlock] && !IsRelatedToWalletTxs(*block.vtx[posInBlock])) continue;
                     SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
+                    synced_any = true;
+                    // Adding the transaction may have topped up keypools.
+                    output_is_mine.clear();
                 }
+                if (synced_any && prefetcher) prefetcher->WalletUpdated();
+                ++blocks_scanned;
                 // scan succeeded, record block as most recent successfully scanned
                 result.last_scanned_block = block_hash;
                 result.last_scanned_height = block_height;
@@ -2004,7 +2369,9 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         WalletLogPrintf("Rescan interrupted by shutdown request at block %d. Progress=%f\n", block_height, progress_current);
         result.status = ScanResult::USER_ABORT;
     } else {
-        WalletLogPrintf("Rescan completed in %15dms\n", Ticks<std::chrono::milliseconds>(reserver.now() - start_time));
+        const auto elapsed{reserver.now() - start_time};
+        WalletLogPrintf("Rescan completed in %15dms (%d blocks read, %.1f blocks/s)\n", Ticks<std::chrono::milliseconds>(elapsed),
+                        blocks_scanned, (block_height - start_height + 1) / std::max(Ticks<SecondsDouble>(elapsed), 1e-3));
     }
     return result;
 }
@@ -2035,7 +2402,10 @@ bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx, std::string& err_string
     // If transaction was previously in the mempool, it should be updated when
     // TransactionRemovedFromMempool fires.
     bool ret = chain().broadcastTransaction(wtx.tx, m_default_max_tx_fee, relay, err_string);
-    if (ret) wtx.m_state = TxStateInMempool{};
+    if (ret) {
+        wtx.m_state = TxStateInMempool{};
+        MarkBalancesDirty();
+    }
     return ret;
 }
 
@@ -2415,6 +2785,7 @@ util::Result<void> CWallet::RemoveTxs(std::vector<uint256>& txs_to_remove)
     }
 
     MarkDirty();
+    MarkUnspentTXOsDirty();
 
     return {}; // all good
 }
@@ -2507,6 +2878,97 @@ bool CWallet::DelAddressBookWithDB(WalletBatch& batch, const CTxDestination& add
     return true;
 }
 
+util::Result<uint64_t> CWallet::QueuePayout(const CRecipient& recipient)
+{
+    // Apply the checks CreateTransaction() does on each output now, so that
+    // one bad payout cannot fail the whole batch later on.
+    if (!MoneyRange(recipient.nAmount) || recipient.nAmount == 0) {
+        return util::Error{_("Invalid amount")};
+    }
+    if (IsDust(CTxOut{recipient.nAmount, GetScriptForDestination(recipient.dest)}, chain().relayDustFee())) {
+        return util::Error{_("Transaction amount too small")};
+    }
+
+    LOCK(m_payouts_mutex);
+    // Payouts are not stored, so ids are random rather than counted, for an
+    // id from before the wallet was reloaded not to find another payout.
+    uint64_t id;
+    do {
+        id = GetRand<uint64_t>();
+    } while (m_payouts.count(id));
+    m_payouts.emplace(id, Payout{.recipient = recipient, .time = NodeClock::now()});
+    m_queued_payouts.push_back(id);
+    return id;
+}
+
+std::optional<Payout> CWallet::GetPayout(uint64_t id) const
+{
+    LOCK(m_payouts_mutex);
+    const auto it{m_payouts.find(id)};
+    if (it == m_payouts.end()) return std::nullopt;
+    return it->second;
+}
+
+std::vector<std::pair<uint64_t, CRecipient>> CWallet::TakeQueuedPayouts(bool force)
+{
+    LOCK(m_payouts_mutex);
+    std::vector<std::pair<uint64_t, CRecipient>> payouts;
+    if (m_queued_payouts.empty()) return payouts;
+    if (!force) {
+        const auto now{NodeClock::now()};
+        if (now < m_payouts.at(m_queued_payouts.front()).time + m_payout_window || now < m_payouts_retry_time) return payouts;
+    }
+    payouts.reserve(m_queued_payouts.size());
+    for (const uint64_t id : m_queued_payouts) {
+        payouts.emplace_back(id, m_payouts.at(id).recipient);
+    }
+    m_queued_payouts.clear();
+    return payouts;
+}
+
+void CWallet::SetPayoutsSent(const std::vector<std::pair<uint64_t, COutPoint>>& outpoints)
+{
+    LOCK(m_payouts_mutex);
+    for (const auto& [id, outpoint] : outpoints) {
+        Payout& payout{m_payouts.at(id)};
+        payout.status = Payout::Status::SENT;
+        payout.outpoint = outpoint;
+        FinishPayout(id);
+    }
+}
+
+void CWallet::SetPayoutsFailed(const std::vector<uint64_t>& ids, const std::string& error)
+{
+    LOCK(m_payouts_mutex);
+    for (const uint64_t id : ids) {
+        Payout& payout{m_payouts.at(id)};
+        payout.status = Payout::Status::FAILED;
+        payout.error = error;
+        FinishPayout(id);
+    }
+}
+
+void CWallet::RequeuePayouts(const std::vector<uint64_t>& ids, const std::string& error)
+{
+    LOCK(m_payouts_mutex);
+    for (const uint64_t id : ids) {
+        m_payouts.at(id).error = error;
+    }
+    // Payouts queued in the meantime stay behind the older ones
+    m_queued_payouts.insert(m_queued_payouts.begin(), ids.begin(), ids.end());
+    m_payouts_retry_time = NodeClock::now() + m_payout_window;
+}
+
+void CWallet::FinishPayout(uint64_t id)
+{
+    AssertLockHeld(m_payouts_mutex);
+    m_finished_payouts.push_back(id);
+    if (m_finished_payouts.size() > MAX_FINISHED_PAYOUTS) {
+        m_payouts.erase(m_finished_payouts.front());
+        m_finished_payouts.pop_front();
+    }
+}
+
 size_t CWallet::KeypoolCountExternalKeys() const
 {
     AssertLockHeld(cs_wallet);
@@ -2594,6 +3056,7 @@ void CWallet::MarkDestinationsDirty(const std::set<CTxDestination>& destinations
             CTxDestination dst;
             if (ExtractDestination(wtx.tx->vout[i].scriptPubKey, dst) && destinations.count(dst)) {
                 wtx.MarkDirty();
+                MarkBalancesDirty();
                 break;
             }
         }
@@ -3194,6 +3657,7 @@ std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::stri
     }
 
     walletInstance->m_confirm_target = args.GetIntArg("-txconfirmtarget", DEFAULT_TX_CONFIRM_TARGET);
+    walletInstance->m_payout_window = std::chrono::seconds{args.GetIntArg("-payoutwindow", DEFAULT_PAYOUT_WINDOW.count())};
     walletInstance->m_spend_zero_conf_change = args.GetBoolArg("-spendzeroconfchange", DEFAULT_SPEND_ZEROCONF_CHANGE);
     walletInstance->m_signal_rbf = args.GetBoolArg("-walletrbf", DEFAULT_WALLET_RBF);
 
@@ -3281,6 +3745,7 @@ bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interf
         walletInstance->m_last_block_processed.SetNull();
         walletInstance->m_last_block_processed_height = -1;
     }
+    walletInstance->MarkBalancesDirty();
 
     if (tip_height && *tip_height != rescan_height)
     {
@@ -3550,9 +4015,12 @@ std::set<ScriptPubKeyMan*> CWallet::GetScriptPubKeyMans(const CScript& script) c
     std::set<ScriptPubKeyMan*> spk_mans;
 
     // Search the cache for relevant SPKMs instead of iterating m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        spk_mans.insert(it->second.begin(), it->second.end());
+    {
+        LOCK(m_cached_spks_mutex);
+        const auto& it = m_cached_spks.find(script);
+        if (it != m_cached_spks.end()) {
+            spk_mans.insert(it->second.begin(), it->second.end());
+        }
     }
     SignatureData sigdata;
     Assume(std::all_of(spk_mans.begin(), spk_mans.end(), [&script, &sigdata](ScriptPubKeyMan* spkm) { return spkm->CanProvide(script, sigdata); }));
@@ -3580,11 +4048,16 @@ std::unique_ptr<SigningProvider> CWallet::GetSolvingProvider(const CScript& scri
 std::unique_ptr<SigningProvider> CWallet::GetSolvingProvider(const CScript& script, SignatureData& sigdata) const
 {
     // Search the cache for relevant SPKMs instead of iterating m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
+    ScriptPubKeyMan* spkm{nullptr};
+    {
+        LOCK(m_cached_spks_mutex);
+        const auto& it = m_cached_spks.find(script);
+        if (it != m_cached_spks.end()) spkm = it->second.at(0);
+    }
+    if (spkm) {
         // All spkms for a given script must already be able to make a SigningProvider for the script, so just return the first one.
-        Assume(it->second.at(0)->CanProvide(script, sigdata));
-        return it->second.at(0)->GetSolvingProvider(script);
+        Assume(spkm->CanProvide(script, sigdata));
+        return spkm->GetSolvingProvider(script);
     }
 
     // Legacy wallet
@@ -3641,6 +4114,9 @@ void CWallet::AddScriptPubKeyMan(const uint256& id, std::unique_ptr<ScriptPubKey
 
     // Update birth time if needed
     MaybeUpdateBirthTime(spkm->GetTimeFirstKey());
+
+    MarkUnspentTXOsDirty();
+    MarkBalancesDirty();
 }
 
 LegacyDataSPKM* CWallet::GetOrCreateLegacyDataSPKM()
@@ -3945,6 +4421,10 @@ ScriptPubKeyMan* CWallet::AddWalletDescriptor(WalletDescriptor& desc, const Flat
     // Save the descriptor to DB
     spk_man->WriteDescriptor();
 
+    // Outputs of transactions already in the wallet may match the new scriptPubKeys
+    MarkUnspentTXOsDirty();
+    MarkBalancesDirty();
+
     return spk_man;
 }
 
@@ -4059,7 +4539,7 @@ bool CWallet::ApplyMigrationData(MigrationData& data, bilingual_str& error)
         if (ExtractDestination(script, dest)) not_migrated_dests.emplace(dest);
     }
 
-    Assume(!m_cached_spks.empty());
+    Assume(WITH_LOCK(m_cached_spks_mutex, return !m_cached_spks.empty()));
 
     for (auto& desc_spkm : data.desc_spkms) {
         if (m_spk_managers.count(desc_spkm->GetID()) > 0) {
@@ -4563,15 +5043,29 @@ util::Result<MigrationResult> MigrateLegacyToDescriptor(const std::string& walle
 
 void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
 {
+    LOCK(m_cached_spks_mutex);
     for (const auto& script : spks) {
-        m_cached_spks[script].push_back(spkm);
+        auto& spkms = m_cached_spks[script];
+        // A descriptor update tops up scripts that are already cached
+        if (std::find(spkms.begin(), spkms.end(), spkm) == spkms.end()) spkms.push_back(spkm);
     }
 }
 
+bool CWallet::IsCachedScriptPubKey(const CScript& script) const
+{
+    LOCK(m_cached_spks_mutex);
+    return m_cached_spks.count(script) > 0;
+}
+
 void CWallet::TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
 {
     // Update scriptPubKey cache
     CacheNewScriptPubKeys(spks, spkm);
+    // Outputs of wallet transactions may pay to the new scripts, e.g. when a
+    // payment was received beyond the keypool. This is called with the spkm's
+    // lock held, so they are only added to the caches on their next use.
+    LOCK(m_cached_spks_mutex);
+    m_new_spks.insert(spks.begin(), spks.end());
 }
 
 std::set<CExtPubKey> CWallet::GetActiveHDPubKeys() const
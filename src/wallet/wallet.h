@@ -38,6 +38,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <limits>
 #include <map>
@@ -138,6 +139,10 @@ static const bool DEFAULT_DISABLE_WALLET = false;
 static const bool DEFAULT_WALLETCROSSCHAIN = false;
 //! -maxtxfee default
 constexpr CAmount DEFAULT_TRANSACTION_MAXFEE{COIN / 10};
+//! -payoutwindow default
+static constexpr std::chrono::seconds DEFAULT_PAYOUT_WINDOW{10};
+//! Number of sent or failed payouts remembered for getpayout
+static constexpr size_t MAX_FINISHED_PAYOUTS{10000};
 //! Discourage users to set fees higher than this amount (in satoshis) per kB
 constexpr CAmount HIGH_TX_FEE_PER_KB{COIN / 100};
 //! -maxtxfee will warn if called with a higher fee than this amount (in satoshis)
@@ -295,6 +300,26 @@ struct CRecipient
     bool fSubtractFeeFromAmount;
 };
 
+/** A payment queued with CWallet::QueuePayout(), to be sent in one transaction with the other queued payments. */
+struct Payout
+{
+    enum class Status {
+        QUEUED,
+        SENT,
+        FAILED,
+    };
+
+    CRecipient recipient;
+    //! When the payout was queued
+    NodeClock::time_point time;
+    Status status{Status::QUEUED};
+    //! The output paying the recipient, once sent
+    COutPoint outpoint{};
+    //! Why the transaction for the payout's batch could not be created, or why
+    //! it is still queued after a failed attempt
+    std::string error{};
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet maintains a set of transactions and balances, and provides the ability to create new transactions.
@@ -371,10 +396,47 @@ private:
     /** Mark a transaction's inputs dirty, thus forcing the outputs to be recomputed */
     void MarkInputsDirty(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Index of the outputs of wallet transactions that are ours and not spent
+     * by another wallet transaction, by txid. It lets AvailableCoins and
+     * GetBalance visit the unspent outputs instead of the whole of mapWallet.
+     *
+     * The index may contain outputs that have since been spent (e.g. a spender
+     * that moved from abandoned back into the mempool), but never misses an
+     * unspent one, so callers still check IsSpent and IsMine on what it returns.
+     * It is rebuilt from mapWallet on first use after loading, and whenever
+     * outputs of existing transactions may have become ours.
+     */
+    typedef std::unordered_map<uint256, std::set<uint32_t>, SaltedTxidHasher> UnspentTXOs;
+    mutable UnspentTXOs m_unspent_txos GUARDED_BY(cs_wallet);
+    mutable std::atomic<bool> m_unspent_txos_stale{true};
+    /** Outputs of wallet transactions that are not ours, by script, so that
+     * the transactions paying to newly derived scripts can be found without
+     * visiting mapWallet. Kept along with m_unspent_txos. */
+    mutable std::unordered_map<CScript, std::set<uint256>, SaltedSipHasher> m_unowned_txo_scripts GUARDED_BY(cs_wallet);
+
+    /** Results of GetBalance by min_depth and avoid_reuse, valid for m_balances_generation. */
+    mutable std::map<std::pair<int, bool>, Balance> m_cached_balances GUARDED_BY(cs_wallet);
+    mutable uint64_t m_cached_balances_generation GUARDED_BY(cs_wallet){0};
+    //! Bumped by MarkBalancesDirty()
+    mutable std::atomic<uint64_t> m_balances_generation{1};
+    /** Add output n of wtx to m_unspent_txos if it is ours and unspent, otherwise remove it. */
+    void RefreshTXO(const CWalletTx& wtx, uint32_t n) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Refresh the outputs of wtx and the wallet outputs it spends. */
+    void RefreshTXOsFromTx(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Refresh the outputs paying to the scripts derived since the last call,
+     * see m_new_spks. */
+    void RefreshNewScriptPubKeyTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet, !m_cached_spks_mutex);
+
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     void SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool update_tx = true, bool rescanning_old_block = false) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /** Whether tx is in the wallet, spends an output of a wallet transaction, or spends the same
+     *  outpoint as one. Together with IsMine(tx) this covers every confirmed transaction that
+     *  AddToWalletIfInvolvingMe acts on. */
+    bool IsRelatedToWalletTxs(const CTransaction& tx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** WalletFlags set on this wallet. */
     std::atomic<uint64_t> m_wallet_flags{0};
 
@@ -425,8 +487,27 @@ private:
     // Same as 'AddActiveScriptPubKeyMan' but designed for use within a batch transaction context
     void AddActiveScriptPubKeyManWithDb(WalletBatch& batch, uint256 id, OutputType type, bool internal);
 
-    //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
-    std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms.
+    //! It has its own mutex, which is never held while calling into a spkm, so that it can
+    //! also be read without cs_wallet (see IsCachedScriptPubKey()).
+    mutable Mutex m_cached_spks_mutex;
+    std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks GUARDED_BY(m_cached_spks_mutex);
+    //! Scripts derived by a top up whose outputs in existing wallet transactions
+    //! have not been added to the unspent output index and balances yet. Top ups
+    //! run with a spkm lock held and cannot take cs_wallet to do it themselves.
+    mutable std::set<CScript> m_new_spks GUARDED_BY(m_cached_spks_mutex);
+
+    //! Queued payouts, and sent or failed ones until MAX_FINISHED_PAYOUTS newer ones finished
+    mutable Mutex m_payouts_mutex;
+    std::map<uint64_t, Payout> m_payouts GUARDED_BY(m_payouts_mutex);
+    //! Ids of queued payouts, oldest first
+    std::deque<uint64_t> m_queued_payouts GUARDED_BY(m_payouts_mutex);
+    //! Ids of sent and failed payouts, oldest first
+    std::deque<uint64_t> m_finished_payouts GUARDED_BY(m_payouts_mutex);
+    //! Payouts put back in the queue are not retried before this time, unless forced
+    NodeClock::time_point m_payouts_retry_time GUARDED_BY(m_payouts_mutex){};
+
+    void FinishPayout(uint64_t id) EXCLUSIVE_LOCKS_REQUIRED(m_payouts_mutex);
 
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
@@ -486,6 +567,13 @@ public:
     typedef std::multimap<int64_t, CWalletTx*> TxItems;
     TxItems wtxOrdered;
 
+    /** Wallet outputs that may be unspent, by txid, see m_unspent_txos. */
+    const UnspentTXOs& GetUnspentTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet, !m_cached_spks_mutex);
+    /** Rebuild the unspent output index, and reset the credits cached by each
+     * transaction, on its next use. Needed when outputs of existing wallet
+     * transactions may have become ours, e.g. after an import. */
+    void MarkUnspentTXOsDirty() { m_unspent_txos_stale = true; }
+
     int64_t nOrderPosNext GUARDED_BY(cs_wallet) = 0;
 
     std::map<CTxDestination, CAddressBookData> m_address_book GUARDED_BY(cs_wallet);
@@ -595,6 +683,17 @@ public:
 
     void MarkDirty();
 
+    /** Invalidate the balances cached for GetBalance. Called on every change
+     *  that can affect them: transactions being added, changing state or
+     *  being marked dirty, the tip changing (depth and coinbase maturity),
+     *  and scriptPubKeys being added. */
+    void MarkBalancesDirty() const { ++m_balances_generation; }
+    /** Return the cached balance for these GetBalance arguments, if still valid. */
+    std::optional<Balance> GetCachedBalance(int min_depth, bool avoid_reuse) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet, !m_cached_spks_mutex);
+    /** Cache a balance computed by GetBalance, started at balances_generation. */
+    void CacheBalance(int min_depth, bool avoid_reuse, uint64_t balances_generation, const Balance& balance) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    uint64_t GetBalancesGeneration() const { return m_balances_generation; }
+
     //! Callback for updating transaction metadata in mapWallet.
     //!
     //! @param wtx - reference to mapWallet transaction to update
@@ -694,6 +793,8 @@ public:
 
     CFeeRate m_pay_tx_fee{DEFAULT_PAY_TX_FEE};
     unsigned int m_confirm_target{DEFAULT_TX_CONFIRM_TARGET};
+    //! How long the oldest queued payout waits for others to be batched with (-payoutwindow)
+    std::chrono::seconds m_payout_window{DEFAULT_PAYOUT_WINDOW};
     /** Allow Coin Selection to pick unconfirmed UTXOs that were sent from our own wallet if it
      * cannot fund the transaction otherwise. */
     bool m_spend_zero_conf_change{DEFAULT_SPEND_ZEROCONF_CHANGE};
@@ -736,6 +837,22 @@ public:
     /** Notify external script when a wallet transaction comes in or is updated (handled by -walletnotify) */
     std::string m_notify_tx_changed_script;
 
+    /** Queue a payment to be sent with the next payout batch. Returns the payout's id, or an
+     *  error if the recipient's output would not be accepted in a transaction. */
+    util::Result<uint64_t> QueuePayout(const CRecipient& recipient) EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+    /** Look up a payout, or return std::nullopt if the id is unknown or the payout finished too long ago. */
+    std::optional<Payout> GetPayout(uint64_t id) const EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+    /** Remove all queued payouts from the queue and return them, oldest first. Unless force is
+     *  set, this only happens once the oldest payout has been queued for m_payout_window. */
+    std::vector<std::pair<uint64_t, CRecipient>> TakeQueuedPayouts(bool force) EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+    /** Record the outputs paying payouts taken with TakeQueuedPayouts(). */
+    void SetPayoutsSent(const std::vector<std::pair<uint64_t, COutPoint>>& outpoints) EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+    /** Record that payouts taken with TakeQueuedPayouts() could not be sent. */
+    void SetPayoutsFailed(const std::vector<uint64_t>& ids, const std::string& error) EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+    /** Put payouts taken with TakeQueuedPayouts() back at the front of the queue after a failure
+     *  that may go away, such as a locked wallet. They are retried after another m_payout_window. */
+    void RequeuePayouts(const std::vector<uint64_t>& ids, const std::string& error) EXCLUSIVE_LOCKS_REQUIRED(!m_payouts_mutex);
+
     size_t KeypoolCountExternalKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool TopUpKeyPool(unsigned int kpSize = 0);
 
@@ -992,6 +1109,7 @@ public:
         AssertLockHeld(cs_wallet);
         m_last_block_processed_height = block_height;
         m_last_block_processed = block_hash;
+        MarkBalancesDirty();
     };
 
     //! Connect the signals from ScriptPubKeyMans to the signals in CWallet
@@ -1053,9 +1171,13 @@ public:
     bool CanGrindR() const;
 
     //! Add scriptPubKeys for this ScriptPubKeyMan into the scriptPubKey cache
-    void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm);
+    void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) EXCLUSIVE_LOCKS_REQUIRED(!m_cached_spks_mutex);
+
+    //! Whether script belongs to one of the wallet's descriptor ScriptPubKeyMans. Unlike
+    //! IsMine(), this does not need cs_wallet and does not consult a legacy ScriptPubKeyMan.
+    bool IsCachedScriptPubKey(const CScript& script) const EXCLUSIVE_LOCKS_REQUIRED(!m_cached_spks_mutex);
 
-    void TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) override;
+    void TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) override EXCLUSIVE_LOCKS_REQUIRED(!m_cached_spks_mutex);
 
     //! Retrieve the xpubs in use by the active descriptors
     std::set<CExtPubKey> GetActiveHDPubKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
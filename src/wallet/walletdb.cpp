@@ -16,6 +16,7 @@
 #include <util/bip32.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/translation.h>
 #ifdef USE_BDB
@@ -28,8 +29,11 @@
 #include <wallet/wallet.h>
 
 #include <atomic>
+#include <deque>
+#include <exception>
 #include <optional>
 #include <string>
+#include <thread>
 
 namespace wallet {
 namespace DBKeys {
@@ -1014,63 +1018,135 @@ static DBErrors LoadAddressBookRecords(CWallet* pwallet, DatabaseBatch& batch) E
     return result;
 }
 
+//! Number of transaction records that are read before being deserialized together
+static constexpr size_t TX_LOAD_BATCH_SIZE{10000};
+//! Minimum number of transaction records each thread deserializes
+static constexpr size_t MIN_TX_RECORDS_PER_THREAD{1000};
+
+/** A transaction record read from the database, see ParseTxRecords() */
+struct TxRecord {
+    uint256 hash;
+    DataStream value;
+    CWalletTx wtx{nullptr, TxStateInactive{}};
+    //! Set if deserializing wtx failed
+    std::exception_ptr error;
+};
+
+/**
+ * Deserialize the transactions of a batch of records, splitting large
+ * batches across threads. Deserializing and hashing the transactions is
+ * most of the work of loading a wallet with a long history, and every
+ * record only touches its own stream and CWalletTx.
+ */
+static void ParseTxRecords(std::deque<TxRecord>& records)
+{
+    const auto parse = [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            try {
+                records[i].value >> records[i].wtx;
+            } catch (...) {
+                records[i].error = std::current_exception();
+            }
+        }
+    };
+
+    const size_t count{records.size()};
+    const size_t threads{std::min<size_t>(GetNumCores(), count / MIN_TX_RECORDS_PER_THREAD)};
+    if (threads <= 1) {
+        parse(0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t n = 0; n < threads; ++n) {
+        const size_t from{count * n / threads};
+        const size_t to{count * (n + 1) / threads};
+        workers.emplace_back([&parse, from, to, n]() {
+            util::ThreadRename(strprintf("txload.%i", n));
+            parse(from, to);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
 static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, std::vector<uint256>& upgraded_txs, bool& any_unordered) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
 {
     AssertLockHeld(pwallet->cs_wallet);
     DBErrors result = DBErrors::LOAD_OK;
 
-    // Load tx record
+    // Load tx records. They are read in batches, deserialized in parallel
+    // and then added to the wallet in database order.
     any_unordered = false;
-    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
-        [&any_unordered, &upgraded_txs] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
-        DBErrors result = DBErrors::LOAD_OK;
-        uint256 hash;
-        key >> hash;
-        // LoadToWallet call below creates a new CWalletTx that fill_wtx
-        // callback fills with transaction metadata.
-        auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
-            if(!new_tx) {
-                // There's some corruption here since the tx we just tried to load was already in the wallet.
-                err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
-                result = DBErrors::CORRUPT;
-                return false;
-            }
-            value >> wtx;
-            if (wtx.GetHash() != hash)
-                return false;
-
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
-            {
-                if (!value.empty())
-                {
-                    uint8_t fTmp;
-                    uint8_t fUnused;
-                    std::string unused_string;
-                    value >> fTmp >> fUnused >> unused_string;
-                    pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
-                                       wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = fTmp;
+    std::deque<TxRecord> records;
+    const auto load_records = [&]() EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        ParseTxRecords(records);
+        for (TxRecord& record : records) {
+            DBErrors record_res = DBErrors::LOAD_OK;
+            std::string err;
+            // LoadToWallet call below creates a new CWalletTx that fill_wtx
+            // callback fills with transaction metadata.
+            auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
+                if(!new_tx) {
+                    // There's some corruption here since the tx we just tried to load was already in the wallet.
+                    err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
+                    record_res = DBErrors::CORRUPT;
+                    return false;
                 }
-                else
+                if (record.error) std::rethrow_exception(record.error);
+                wtx.CopyFrom(record.wtx);
+                if (wtx.GetHash() != record.hash)
+                    return false;
+
+                // Undo serialize changes in 31600
+                if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
                 {
-                    pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = 0;
+                    if (!record.value.empty())
+                    {
+                        uint8_t fTmp;
+                        uint8_t fUnused;
+                        std::string unused_string;
+                        record.value >> fTmp >> fUnused >> unused_string;
+                        pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
+                                           wtx.fTimeReceivedIsTxTime, fTmp, record.hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = fTmp;
+                    }
+                    else
+                    {
+                        pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, record.hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = 0;
+                    }
+                    upgraded_txs.push_back(record.hash);
                 }
-                upgraded_txs.push_back(hash);
-            }
 
-            if (wtx.nOrderPos == -1)
-                any_unordered = true;
+                if (wtx.nOrderPos == -1)
+                    any_unordered = true;
 
-            return true;
-        };
-        if (!pwallet->LoadToWallet(hash, fill_wtx)) {
-            // Use std::max as fill_wtx may have already set result to CORRUPT
-            result = std::max(result, DBErrors::NEED_RESCAN);
+                return true;
+            };
+            if (!pwallet->LoadToWallet(record.hash, fill_wtx)) {
+                // Use std::max as fill_wtx may have already set record_res to CORRUPT
+                record_res = std::max(record_res, DBErrors::NEED_RESCAN);
+            }
+            if (!err.empty()) {
+                pwallet->WalletLogPrintf("%s\n", err);
+            }
+            result = std::max(result, record_res);
         }
-        return result;
+        records.clear();
+    };
+    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
+        [&records, &load_records] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        TxRecord& record{records.emplace_back()};
+        key >> record.hash;
+        record.value = std::move(value);
+        // Not every cursor clears the value stream before reading the next record into it
+        value.clear();
+        if (records.size() >= TX_LOAD_BATCH_SIZE) load_records();
+        return DBErrors::LOAD_OK;
     });
+    load_records();
     result = std::max(result, tx_res.m_result);
 
     // Load locked utxo record
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the binary RPC interface (-rpcbinary)."""
+
+import http.client
+import struct
+import urllib.parse
+from io import BytesIO
+
+from test_framework.messages import (
+    deser_compact_size,
+    deser_string,
+    deser_uint256_vector,
+    ser_compact_size,
+    ser_string,
+    ser_uint256,
+)
+from test_framework.test_framework import BGLTestFramework
+from test_framework.util import (
+    assert_equal,
+    str_to_b64str,
+)
+from test_framework.wallet import MiniWallet
+
+MAX_BINARY_RPC_REPLY_SIZE = 32 << 20
+
+RPC_MISC_ERROR = -1
+RPC_INVALID_ADDRESS_OR_KEY = -5
+RPC_METHOD_NOT_FOUND = -32601
+RPC_DESERIALIZATION_ERROR = -22
+
+
+class BinaryRPCTest(BGLTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [["-rpcbinary", "-txindex"], []]
+        self.supports_cli = False
+
+    def binary_request(self, node, body):
+        url = urllib.parse.urlparse(node.url)
+        headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"}
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request('POST', '/binary', body, headers)
+        response = conn.getresponse()
+        return response.status, response.read()
+
+    def call(self, *calls):
+        """Run a batch of (method, params) calls, returning a list of
+        (True, result) or (False, (code, message)) replies."""
+        body = b"".join(ser_string(method.encode()) + ser_string(params) for method, params in calls)
+        status, data = self.binary_request(self.nodes[0], body)
+        assert_equal(status, http.client.OK)
+        f = BytesIO(data)
+        replies = []
+        for _ in calls:
+            if f.read(1) == b"\x00":
+                replies.append((True, f.read(deser_compact_size(f))))
+            else:
+                code = struct.unpack("<i", f.read(4))[0]
+                replies.append((False, (code, deser_string(f).decode())))
+        assert_equal(f.read(), b"")
+        return replies
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        self.generate(wallet, 5)
+        confirmed_tx = wallet.send_self_transfer(from_node=node)
+        self.generate(node, 1, sync_fun=self.no_op)
+        mempool_tx = wallet.send_self_transfer(from_node=node)
+        tip = node.getbestblockhash()
+        height = node.getblockcount()
+
+        self.log.info("Test chain methods")
+        [best, by_height, header, block, undo] = self.call(
+            ("getbestblockhash", b""),
+            ("getblockhash", struct.pack("<i", height)),
+            ("getblockheader", ser_uint256(int(tip, 16))),
+            ("getblock", ser_uint256(int(tip, 16))),
+            ("getblockundo", ser_uint256(int(tip, 16))),
+        )
+        assert_equal(best, (True, ser_uint256(int(tip, 16)) + struct.pack("<i", height)))
+        assert_equal(by_height, (True, ser_uint256(int(tip, 16))))
+        assert_equal(header, (True, bytes.fromhex(node.getblockheader(tip, False)) + struct.pack("<i", height)))
+        assert_equal(block, (True, bytes.fromhex(node.getblock(tip, 0))))
+        # One non-coinbase transaction spending one output.
+        assert undo[0]
+        assert_equal(deser_compact_size(BytesIO(undo[1])), 1)
+
+        self.log.info("Test mempool and transaction methods")
+        [mempool, in_mempool, in_block] = self.call(
+            ("getrawmempool", b""),
+            ("getrawtransaction", ser_uint256(int(mempool_tx["txid"], 16))),
+            ("getrawtransaction", ser_uint256(int(confirmed_tx["txid"], 16))),
+        )
+        f = BytesIO(mempool[1])
+        assert_equal([f"{txid:064x}" for txid in deser_uint256_vector(f)], node.getrawmempool())
+        assert_equal(struct.unpack("<Q", f.read())[0], node.getrawmempool(mempool_sequence=True)["mempool_sequence"])
+        assert_equal(in_mempool, (True, bytes.fromhex(mempool_tx["hex"]) + ser_uint256(0)))
+        assert_equal(in_block, (True, bytes.fromhex(confirmed_tx["hex"]) + ser_uint256(int(tip, 16))))
+
+        self.log.info("Test that failed calls do not affect the rest of the batch")
+        [unknown, missing, malformed, best] = self.call(
+            ("getblockchaininfo", b""),
+            ("getblock", ser_uint256(1)),
+            ("getblockhash", b"\x01"),
+            ("getbestblockhash", b""),
+        )
+        assert_equal(unknown, (False, (RPC_METHOD_NOT_FOUND, "Method not found")))
+        assert_equal(missing, (False, (RPC_INVALID_ADDRESS_OR_KEY, "Block not found")))
+        assert_equal(malformed[1][0], RPC_DESERIALIZATION_ERROR)
+        assert best[0]
+
+        self.log.info("Test that calls fail once the reply size limit is reached")
+        large_tx = wallet.create_self_transfer(target_weight=160000)
+        large = self.generateblock(node, wallet.get_address(), [large_tx["hex"]], sync_fun=self.no_op)["hash"]
+        block_size = len(node.getblock(large, 0)) // 2
+        replies = self.call(*[("getblock", ser_uint256(int(large, 16)))] * 1000)
+        executed = -(-MAX_BINARY_RPC_REPLY_SIZE // (block_size + 1 + len(ser_compact_size(block_size))))
+        assert executed < 1000
+        assert all(success for success, _ in replies[:executed])
+        for reply in replies[executed:]:
+            assert_equal(reply, (False, (RPC_MISC_ERROR, f"Binary RPC reply size limit of {MAX_BINARY_RPC_REPLY_SIZE} bytes reached")))
+
+        self.log.info("Test malformed and unauthorized requests")
+        status, _ = self.binary_request(node, ser_compact_size(100) + b"getblock")
+        assert_equal(status, http.client.BAD_REQUEST)
+        call = ser_string(b"getbestblockhash") + ser_string(b"")
+        status, _ = self.binary_request(node, call * 1000)
+        assert_equal(status, http.client.OK)
+        status, _ = self.binary_request(node, call * 1001)
+        assert_equal(status, http.client.BAD_REQUEST)
+        url = urllib.parse.urlparse(node.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request('POST', '/binary', b"", {"Authorization": f"Basic {str_to_b64str('user:wrong')}"})
+        assert_equal(conn.getresponse().status, http.client.UNAUTHORIZED)
+
+        self.log.info("Test that the interface is disabled by default")
+        status, _ = self.binary_request(self.nodes[1], ser_string(b"getbestblockhash") + ser_string(b""))
+        assert_equal(status, http.client.NOT_FOUND)
+
+
+if __name__ == '__main__':
+    BinaryRPCTest().main()
@@ -352,9 +352,40 @@ class RESTTest (BGLTestFramework):
             assert_equal(json_obj[tx]['spentby'], txs[i + 1:i + 2])
             assert_equal(json_obj[tx]['depends'], txs[i - 1:i])
 
+        self.log.info("Test the /mempool/events URI")
+        self.nodes[0].syncwithvalidationinterfacequeue()
+        events = self.test_rest_request("/mempool/events", query_params={"count": 10000})
+        added = [e for e in events['events'] if e['type'] == 'added' and e['txid'] in txs]
+        assert_equal([e['txid'] for e in added], txs)
+        for e in added:
+            assert_equal(e['vsize'], raw_mempool_verbose[e['txid']]['vsize'])
+            assert_equal(e['fee'], raw_mempool_verbose[e['txid']]['fees']['base'])
+            assert_equal(e['hex'], self.nodes[0].getrawtransaction(e['txid']))
+        cursor = events['next']
+        # The binary format starts with the next cursor
+        bin_events = self.test_rest_request("/mempool/events", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"start": 0, "count": 10000})
+        assert_equal(int.from_bytes(bin_events[:8], 'little'), cursor)
+        # Caught up, nothing new
+        assert_equal(self.test_rest_request("/mempool/events", query_params={"start": cursor}), {"next": cursor, "events": []})
+        self.test_rest_request("/mempool/events", status=404, ret_type=RetType.OBJ, query_params={"start": cursor + 1})
+        # Cursors carry a per-run epoch in their upper bits, other epochs are rejected
+        self.test_rest_request("/mempool/events", status=404, ret_type=RetType.OBJ, query_params={"start": cursor ^ (1 << 63)})
+        self.test_rest_request("/mempool/events", status=400, ret_type=RetType.OBJ, query_params={"count": 0})
+
         # Now mine the transactions
+        mempool_sequence = self.nodes[0].getrawmempool(mempool_sequence=True)['mempool_sequence']
         newblockhash = self.generate(self.nodes[1], 1)
 
+        self.nodes[0].syncwithvalidationinterfacequeue()
+        events = self.test_rest_request("/mempool/events", query_params={"start": cursor})
+        assert_equal(sorted(e['txid'] for e in events['events']), sorted(txs))
+        for e in events['events']:
+            assert_equal(e['type'], 'removed')
+            assert_equal(e['reason'], 'block')
+            # Block removals carry their mempool sequence, so bootstrapping
+            # clients do not skip them
+            assert e['mempool_sequence'] >= mempool_sequence
+
         # Check if the 3 tx show up in the new block
         json_obj = self.test_rest_request(f"/block/{newblockhash[0]}")
         non_coinbase_txs = {tx['txid'] for tx in json_obj['tx']
@@ -8,12 +8,14 @@ import json
 import os
 from dataclasses import dataclass
 from test_framework.test_framework import BGLTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.util import assert_equal, assert_greater_than, assert_greater_than_or_equal
+from test_framework.wallet import MiniWallet
 from threading import Thread
 from typing import Optional
 import subprocess
 
 
+RPC_INVALID_ADDRESS_OR_KEY = -5
 RPC_INVALID_PARAMETER      = -8
 RPC_METHOD_NOT_FOUND       = -32601
 RPC_INVALID_REQUEST        = -32600
@@ -229,6 +231,40 @@ class RPCInterfaceTest(BGLTestFramework):
         # Sanity check: command was not executed
         assert_equal(block_count + 1, self.nodes[0].getblockcount())
 
+    def test_streamed_results(self):
+        self.log.info("Testing results streamed into the reply...")
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        self.generate(wallet, 101)
+        wallet.send_self_transfer_multi(from_node=node, num_outputs=150)
+        self.generate(node, 1)
+        wallet.rescan_utxos()
+        for _ in range(150):
+            wallet.send_self_transfer(from_node=node, utxo_to_spend=wallet.get_utxo(confirmed_only=True))
+
+        # Batched calls are not streamed, so they give the reference result.
+        def batched(method, params):
+            return node.batch([{"id": 0, "method": method, "params": params}])[0]["result"]
+
+        def check_streamed(method, params):
+            expected = batched(method, params)
+            for version in [1, 2]:
+                request = format_request(BatchOptions(version), "id", {"method": method, "params": params})
+                raw_response, status = node._request("POST", "/", json.dumps(request).encode("utf-8"))
+                assert_equal(status, 200)
+                assert_equal(raw_response, format_response(BatchOptions(version), "id", {"result": expected}))
+            # Large enough to be sent in several parts
+            assert_greater_than(len(json.dumps(expected, default=str)), 1 << 16)
+
+        check_streamed("getrawmempool", [True])
+        block_hash = self.generate(node, 1)[0]
+        for verbosity in [2, 3]:
+            check_streamed("getblock", [block_hash, verbosity])
+
+        # Failures before anything is streamed are replied as usual.
+        expect_http_rpc_status(500, RPC_INVALID_ADDRESS_OR_KEY, node, "getblock", ["00" * 32, 3])
+        expect_http_rpc_status(200, RPC_INVALID_ADDRESS_OR_KEY, node, "getblock", ["00" * 32, 3], 2, False)
+
     def test_work_queue_exceeded(self):
         self.log.info("Testing work queue exceeded...")
         self.restart_node(0, ['-rpcworkqueue=1', '-rpcthreads=1'])
@@ -245,6 +281,7 @@ class RPCInterfaceTest(BGLTestFramework):
         self.test_getrpcinfo()
         self.test_batch_requests()
         self.test_http_status_codes()
+        self.test_streamed_results()
 
 
 if __name__ == '__main__':
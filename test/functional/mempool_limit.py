@@ -259,8 +259,17 @@ class MempoolLimitTest(BGLTestFramework):
         assert_equal(node.getmempoolinfo()['minrelaytxfee'], Decimal('0.00001000'))
         assert_equal(node.getmempoolinfo()['mempoolminfee'], Decimal('0.00001000'))
 
+        assert_equal(node.getmempoolinfo()['evictions']['transactions'], 0)
         fill_mempool(self, node)
 
+        self.log.info('Check that eviction work is reported')
+        evictions = node.getmempoolinfo()['evictions']
+        assert_greater_than(evictions['runs'], 0)
+        assert_greater_than(evictions['transactions'], 0)
+        assert_greater_than(evictions['vbytes'], 0)
+        assert evictions['batches'] >= evictions['runs']
+        assert evictions['packages'] <= evictions['transactions']
+
         # Deliberately try to create a tx with a fee less than the minimum mempool fee to assert that it does not get added to the mempool
         self.log.info('Create a mempool tx that will not pass mempoolminfee')
         assert_raises_rpc_error(-26, "mempool min fee not met", miniwallet.send_self_transfer, from_node=node, fee_rate=relayfee)
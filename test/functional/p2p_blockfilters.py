@@ -5,12 +5,15 @@
 """Tests NODE_COMPACT_FILTERS (BIP 157/158).
 
 Tests that a node configured with -blockfilterindex and -peerblockfilters signals
-NODE_COMPACT_FILTERS and can serve cfilters, cfheaders and cfcheckpts.
+NODE_COMPACT_FILTERS and can serve cfilters, cfheaders and cfcheckpts, and
+that outpoint filters are served under NODE_OUTPOINT_FILTERS.
 """
 
 from test_framework.messages import (
     FILTER_TYPE_BASIC,
+    FILTER_TYPE_OUTPOINT,
     NODE_COMPACT_FILTERS,
+    NODE_OUTPOINT_FILTERS,
     hash256,
     msg_getcfcheckpt,
     msg_getcfheaders,
@@ -232,6 +235,11 @@ class CompactFiltersTest(BGLTestFramework):
                 filter_type=255,
                 stop_hash=int(main_block_hash, 16),
             ),
+            # Requesting a filter type the node has no index for results in disconnection.
+            msg_getcfcheckpt(
+                filter_type=FILTER_TYPE_OUTPOINT,
+                stop_hash=int(main_block_hash, 16),
+            ),
             # Requesting unknown hash results in disconnection.
             msg_getcfcheckpt(
                 filter_type=FILTER_TYPE_BASIC,
@@ -243,6 +251,22 @@ class CompactFiltersTest(BGLTestFramework):
             peer_0.send_message(request)
             peer_0.wait_for_disconnect()
 
+        self.log.info("Check that outpoint filters are served with NODE_OUTPOINT_FILTERS.")
+        self.restart_node(0, extra_args=["-blockfilterindex=outpoint", "-peerblockfilters"])
+        self.wait_until(lambda: self.nodes[0].getindexinfo()["outpoint block filter index"]["synced"])
+        localservices = int(self.nodes[0].getnetworkinfo()['localservices'], 16)
+        assert localservices & NODE_OUTPOINT_FILTERS != 0
+        assert localservices & NODE_COMPACT_FILTERS == 0
+        peer_0 = self.nodes[0].add_p2p_connection(FiltersClient())
+        request = msg_getcfcheckpt(
+            filter_type=FILTER_TYPE_OUTPOINT,
+            stop_hash=int(main_block_hash, 16),
+        )
+        peer_0.send_and_ping(request)
+        response = peer_0.last_message['cfcheckpt']
+        assert_equal(response.filter_type, FILTER_TYPE_OUTPOINT)
+        assert_equal(response.headers, [int(self.nodes[0].getblockfilter(main_block_hash, 'outpoint')['header'], 16)])
+
         self.log.info("Test -peerblockfilters without -blockfilterindex raises an error")
         self.stop_node(0)
         self.nodes[0].extra_args = ["-peerblockfilters"]
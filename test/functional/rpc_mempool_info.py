@@ -94,6 +94,18 @@ class RPCMempoolInfoTest(BGLTestFramework):
         self.log.info("Missing txid")
         assert_raises_rpc_error(-3, "Missing txid", self.nodes[0].gettxspendingprevout, [{'vout' : 3}])
 
+        self.log.info("Confirmed spends require -spenderindex")
+        assert_raises_rpc_error(-1, "Use -spenderindex", self.nodes[0].gettxspendingprevout, [{'txid' : txidA, 'vout' : 0}], mempool_only=False)
+
+        self.log.info("Confirmed spends are only looked up with mempool_only=false")
+        self.restart_node(0, extra_args=["-spenderindex"])
+        self.generate(self.nodes[0], 1)
+        self.wait_until(lambda: self.nodes[0].getindexinfo("spenderindex")["spenderindex"]["synced"])
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidA, 'vout' : 0} ])
+        assert_equal(result, [ {'txid' : txidA, 'vout' : 0} ])
+        result = self.nodes[0].gettxspendingprevout([ {'txid' : txidA, 'vout' : 0} ], mempool_only=False)
+        assert_equal(result, [ {'txid' : txidA, 'vout' : 0, 'spendingtxid' : txidB, 'spendingvin' : 0, 'blockheight' : self.nodes[0].getblockcount()} ])
+
 
 if __name__ == '__main__':
     RPCMempoolInfoTest().main()
@@ -57,6 +57,7 @@ NODE_WITNESS = (1 << 3)
 NODE_COMPACT_FILTERS = (1 << 6)
 NODE_NETWORK_LIMITED = (1 << 10)
 NODE_P2P_V2 = (1 << 11)
+NODE_OUTPOINT_FILTERS = (1 << 24)
 
 MSG_TX = 1
 MSG_BLOCK = 2
@@ -68,6 +69,7 @@ MSG_TYPE_MASK = 0xffffffff >> 2
 MSG_WITNESS_TX = MSG_TX | MSG_WITNESS_FLAG
 
 FILTER_TYPE_BASIC = 0
+FILTER_TYPE_OUTPOINT = 1
 
 WITNESS_SCALE_FACTOR = 4
 
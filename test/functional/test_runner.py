@@ -195,6 +195,7 @@ BASE_SCRIPTS = [
     'p2p_1p1c_network.py',
     'p2p_opportunistic_1p1c.py',
     'interface_rest.py',
+    'interface_binary_rpc.py',
     'mempool_spend_coinbase.py',
     'wallet_avoid_mixing_output_types.py --descriptors',
     'mempool_reorg.py',